@@ -43,7 +43,9 @@
 #include "clang/Tooling/Tooling.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Signals.h"
+#include "llvm/Support/ThreadPool.h"
 #include <algorithm>
+#include <mutex>
 #include <utility>
 
 #if CLANG_ENABLE_STATIC_ANALYZER
@@ -390,8 +392,11 @@ ClangTidyASTConsumerFactory::CreateASTConsumer(
 
   std::unique_ptr<ClangTidyProfiling> Profiling;
   if (Context.getEnableProfiling()) {
-    Profiling = std::make_unique<ClangTidyProfiling>(
-        Context.getProfileStorageParams());
+    if (ClangTidyProfiling *Aggregate = Context.getProfileAggregate())
+      Profiling = std::make_unique<ClangTidyProfiling>(*Aggregate);
+    else
+      Profiling = std::make_unique<ClangTidyProfiling>(
+          Context.getProfileStorageParams());
     FinderOptions.CheckProfiling.emplace(Profiling->Records);
   }
 
@@ -487,12 +492,37 @@ getCheckOptions(const ClangTidyOptions &Options,
   return Factory.getCheckOptions();
 }
 
-std::vector<ClangTidyError>
-runClangTidy(clang::tidy::ClangTidyContext &Context,
-             const CompilationDatabase &Compilations,
-             ArrayRef<std::string> InputFiles,
-             llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS,
-             bool EnableCheckProfile, llvm::StringRef StoreCheckProfile) {
+namespace {
+/// Forwards option lookups of the per-thread contexts of a parallel run to the
+/// context of the main thread. Options providers cache configuration files and
+/// are not thread-safe, so lookups are serialized.
+class SynchronizedOptionsProvider : public ClangTidyOptionsProvider {
+public:
+  SynchronizedOptionsProvider(const ClangTidyContext &Parent, std::mutex &Mutex)
+      : Parent(Parent), Mutex(Mutex) {}
+
+  const ClangTidyGlobalOptions &getGlobalOptions() override {
+    return Parent.getGlobalOptions();
+  }
+
+  std::vector<OptionsSource> getRawOptions(StringRef FileName) override {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return {OptionsSource(Parent.getOptionsForFile(FileName),
+                          "parent context")};
+  }
+
+private:
+  const ClangTidyContext &Parent;
+  std::mutex &Mutex;
+};
+} // namespace
+
+static void
+runClangTidyOnFiles(ClangTidyContext &Context,
+                    const CompilationDatabase &Compilations,
+                    ArrayRef<std::string> InputFiles,
+                    IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS,
+                    ClangTidyDiagnosticConsumer &DiagConsumer) {
   ClangTool Tool(Compilations, InputFiles,
                  std::make_shared<PCHContainerOperations>(), BaseFS);
 
@@ -516,15 +546,11 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
 
   Tool.appendArgumentsAdjuster(PerFileExtraArgumentsInserter);
   Tool.appendArgumentsAdjuster(getStripPluginsAdjuster());
-  Context.setEnableProfiling(EnableCheckProfile);
-  Context.setProfileStoragePrefix(StoreCheckProfile);
 
-  ClangTidyDiagnosticConsumer DiagConsumer(Context);
   DiagnosticsEngine DE(new DiagnosticIDs(), new DiagnosticOptions(),
                        &DiagConsumer, /*ShouldOwnClient=*/false);
   Context.setDiagnosticsEngine(&DE);
   Tool.setDiagnosticConsumer(&DiagConsumer);
-
   class ActionFactory : public FrontendActionFactory {
   public:
     ActionFactory(ClangTidyContext &Context,
@@ -562,7 +588,73 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
 
   ActionFactory Factory(Context, BaseFS);
   Tool.run(&Factory);
-  return DiagConsumer.take();
+}
+
+std::vector<ClangTidyError>
+runClangTidy(clang::tidy::ClangTidyContext &Context,
+             const CompilationDatabase &Compilations,
+             ArrayRef<std::string> InputFiles,
+             llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS,
+             bool EnableCheckProfile, llvm::StringRef StoreCheckProfile,
+             unsigned Jobs) {
+  Context.setEnableProfiling(EnableCheckProfile);
+  Context.setProfileStoragePrefix(StoreCheckProfile);
+
+  if (Jobs <= 1 || InputFiles.size() <= 1) {
+    ClangTidyDiagnosticConsumer DiagConsumer(Context);
+    runClangTidyOnFiles(Context, Compilations, InputFiles, BaseFS,
+                        DiagConsumer);
+    std::vector<ClangTidyError> Errors = DiagConsumer.take();
+    finalizeErrors(Errors);
+    return Errors;
+  }
+
+  // Process the files on a thread pool. Every file gets its own context and
+  // diagnostics, which are merged and sorted once all files are done, so the
+  // result does not depend on scheduling. Each task works on its own
+  // physical file system, as ClangTool changes the working directory of the
+  // file system it runs on.
+  std::mutex Mutex;
+  std::vector<std::vector<ClangTidyError>> FileErrors(InputFiles.size());
+  // Report a single check profile for all files, unless the profiles are
+  // stored per file.
+  llvm::Optional<ClangTidyProfiling> ProfileAggregate;
+  if (EnableCheckProfile && StoreCheckProfile.empty())
+    ProfileAggregate.emplace();
+  {
+    llvm::ThreadPool Pool(
+        std::min<unsigned>(Jobs, static_cast<unsigned>(InputFiles.size())));
+    for (size_t I = 0; I < InputFiles.size(); ++I) {
+      Pool.async([&, I] {
+        ClangTidyContext FileContext(
+            std::make_unique<SynchronizedOptionsProvider>(Context, Mutex),
+            Context.canEnableAnalyzerAlphaCheckers());
+        FileContext.setEnableProfiling(EnableCheckProfile);
+        FileContext.setProfileStoragePrefix(StoreCheckProfile);
+        if (ProfileAggregate)
+          FileContext.setProfileAggregate(ProfileAggregate.getPointer());
+        IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> FS(
+            new llvm::vfs::OverlayFileSystem(
+                llvm::vfs::createPhysicalFileSystem().release()));
+        ClangTidyDiagnosticConsumer FileDiagConsumer(FileContext);
+        runClangTidyOnFiles(FileContext, Compilations, InputFiles[I], FS,
+                            FileDiagConsumer);
+        FileErrors[I] = FileDiagConsumer.take();
+
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Context.mergeStats(FileContext.getStats());
+      });
+    }
+  }
+
+  // Diagnostics and fixes in headers shared by several files are reported by
+  // each of them; remove the duplicates and conflicting fixes across files.
+  std::vector<ClangTidyError> Errors;
+  for (std::vector<ClangTidyError> &ErrorsOfFile : FileErrors)
+    std::move(ErrorsOfFile.begin(), ErrorsOfFile.end(),
+              std::back_inserter(Errors));
+  finalizeErrors(Errors);
+  return Errors;
 }
 
 void handleErrors(llvm::ArrayRef<ClangTidyError> Errors,
@@ -236,10 +236,8 @@ std::string ClangTidyContext::getCheckName(unsigned DiagnosticID) const {
 }
 
 ClangTidyDiagnosticConsumer::ClangTidyDiagnosticConsumer(
-    ClangTidyContext &Ctx, DiagnosticsEngine *ExternalDiagEngine,
-    bool RemoveIncompatibleErrors)
+    ClangTidyContext &Ctx, DiagnosticsEngine *ExternalDiagEngine)
     : Context(Ctx), ExternalDiagEngine(ExternalDiagEngine),
-      RemoveIncompatibleErrors(RemoveIncompatibleErrors),
       LastErrorRelatesToUserCode(false), LastErrorPassesLineFilter(false),
       LastErrorWasIgnored(false) {}
 
@@ -572,7 +570,7 @@ llvm::Regex *ClangTidyDiagnosticConsumer::getHeaderFilter() {
   return HeaderFilter.get();
 }
 
-void ClangTidyDiagnosticConsumer::removeIncompatibleErrors() {
+static void removeIncompatibleErrors(std::vector<ClangTidyError> &Errors) {
   // Each error is modelled as the set of intervals in which it applies
   // replacements. To detect overlapping replacements, we use a sweep line
   // algorithm over these sets of intervals.
@@ -721,11 +719,14 @@ struct EqualClangTidyError {
 
 std::vector<ClangTidyError> ClangTidyDiagnosticConsumer::take() {
   finalizeLastError();
+  return std::move(Errors);
+}
 
+void clang::tidy::finalizeErrors(std::vector<ClangTidyError> &Errors,
+                                 bool RemoveIncompatibleErrors) {
   std::sort(Errors.begin(), Errors.end(), LessClangTidyError());
   Errors.erase(std::unique(Errors.begin(), Errors.end(), EqualClangTidyError()),
                Errors.end());
   if (RemoveIncompatibleErrors)
-    removeIncompatibleErrors();
-  return std::move(Errors);
+    removeIncompatibleErrors(Errors);
 }
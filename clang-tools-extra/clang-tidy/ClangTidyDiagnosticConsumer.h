@@ -63,6 +63,15 @@ struct ClangTidyStats {
     return ErrorsIgnoredNOLINT + ErrorsIgnoredCheckFilter +
            ErrorsIgnoredNonUserCode + ErrorsIgnoredLineFilter;
   }
+
+  ClangTidyStats &operator+=(const ClangTidyStats &Other) {
+    ErrorsDisplayed += Other.ErrorsDisplayed;
+    ErrorsIgnoredCheckFilter += Other.ErrorsIgnoredCheckFilter;
+    ErrorsIgnoredNOLINT += Other.ErrorsIgnoredNOLINT;
+    ErrorsIgnoredNonUserCode += Other.ErrorsIgnoredNonUserCode;
+    ErrorsIgnoredLineFilter += Other.ErrorsIgnoredLineFilter;
+    return *this;
+  }
 };
 
 /// Every \c ClangTidyCheck reports errors through a \c DiagnosticsEngine
@@ -143,6 +152,10 @@ public:
   /// counters.
   const ClangTidyStats &getStats() const { return Stats; }
 
+  /// Adds the counters of another context, e.g. one that processed some of
+  /// the files of a parallel run, to the counters of this one.
+  void mergeStats(const ClangTidyStats &Other) { Stats += Other; }
+
   /// Control profile collection in clang-tidy.
   void setEnableProfiling(bool Profile);
   bool getEnableProfiling() const { return Profile; }
@@ -152,6 +165,13 @@ public:
   llvm::Optional<ClangTidyProfiling::StorageParams>
   getProfileStorageParams() const;
 
+  /// If set, the check profiles of the translation units processed with this
+  /// context are added to \p Aggregate instead of being reported one by one.
+  void setProfileAggregate(ClangTidyProfiling *Aggregate) {
+    ProfileAggregate = Aggregate;
+  }
+  ClangTidyProfiling *getProfileAggregate() const { return ProfileAggregate; }
+
   /// Should be called when starting to process new translation unit.
   void setCurrentBuildDirectory(StringRef BuildDirectory) {
     CurrentBuildDirectory = BuildDirectory;
@@ -200,6 +220,7 @@ private:
 
   bool Profile;
   std::string ProfilePrefix;
+  ClangTidyProfiling *ProfileAggregate = nullptr;
 
   bool AllowEnablingAnalyzerAlphaCheckers;
 };
@@ -221,6 +242,13 @@ bool shouldSuppressDiagnostic(DiagnosticsEngine::Level DiagLevel,
                               const Diagnostic &Info, ClangTidyContext &Context,
                               bool CheckMacroExpansion = true);
 
+/// Sorts \p Errors by location and removes duplicates, such as diagnostics in
+/// a header that is included by several of the processed files. If
+/// \p RemoveIncompatibleErrors is true, the fixes that overlap with another
+/// fix are dropped as well.
+void finalizeErrors(std::vector<ClangTidyError> &Errors,
+                    bool RemoveIncompatibleErrors = true);
+
 /// A diagnostic consumer that turns each \c Diagnostic into a
 /// \c SourceManager-independent \c ClangTidyError.
 //
@@ -229,8 +257,7 @@ bool shouldSuppressDiagnostic(DiagnosticsEngine::Level DiagLevel,
 class ClangTidyDiagnosticConsumer : public DiagnosticConsumer {
 public:
   ClangTidyDiagnosticConsumer(ClangTidyContext &Ctx,
-                              DiagnosticsEngine *ExternalDiagEngine = nullptr,
-                              bool RemoveIncompatibleErrors = true);
+                              DiagnosticsEngine *ExternalDiagEngine = nullptr);
 
   // FIXME: The concept of converting between FixItHints and Replacements is
   // more generic and should be pulled out into a more useful Diagnostics
@@ -238,12 +265,12 @@ public:
   void HandleDiagnostic(DiagnosticsEngine::Level DiagLevel,
                         const Diagnostic &Info) override;
 
-  // Retrieve the diagnostics that were captured.
+  // Retrieve the diagnostics that were captured, in the order in which they
+  // were reported. They still need to go through \c finalizeErrors().
   std::vector<ClangTidyError> take();
 
 private:
   void finalizeLastError();
-  void removeIncompatibleErrors();
 
   /// Returns the \c HeaderFilter constructed for the options set in the
   /// context.
@@ -258,7 +285,6 @@ private:
 
   ClangTidyContext &Context;
   DiagnosticsEngine *ExternalDiagEngine;
-  bool RemoveIncompatibleErrors;
   std::vector<ClangTidyError> Errors;
   std::unique_ptr<llvm::Regex> HeaderFilter;
   bool LastErrorRelatesToUserCode;
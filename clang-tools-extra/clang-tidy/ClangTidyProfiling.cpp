@@ -13,6 +13,7 @@
 #include "llvm/Support/Path.h"
 #include "llvm/Support/YAMLTraits.h"
 #include "llvm/Support/raw_ostream.h"
+#include <mutex>
 #include <system_error>
 #include <utility>
 
@@ -79,7 +80,21 @@ void ClangTidyProfiling::storeProfileData() {
 ClangTidyProfiling::ClangTidyProfiling(llvm::Optional<StorageParams> Storage)
     : Storage(std::move(Storage)) {}
 
+ClangTidyProfiling::ClangTidyProfiling(ClangTidyProfiling &Aggregate)
+    : Aggregate(&Aggregate) {}
+
 ClangTidyProfiling::~ClangTidyProfiling() {
+  // Translation units may be processed on several threads; don't let their
+  // reports interleave or their records race.
+  static std::mutex Mutex;
+  std::lock_guard<std::mutex> Lock(Mutex);
+
+  if (Aggregate) {
+    for (const auto &Record : Records)
+      Aggregate->Records[Record.getKey()] += Record.getValue();
+    return;
+  }
+
   TG.emplace("clang-tidy", "clang-tidy checks profiling", Records);
 
   if (!Storage.hasValue())
@@ -38,6 +38,8 @@ private:
 
   llvm::Optional<StorageParams> Storage;
 
+  ClangTidyProfiling *Aggregate = nullptr;
+
   void printUserFriendlyTable(llvm::raw_ostream &OS);
   void printAsJSON(llvm::raw_ostream &OS);
 
@@ -50,6 +52,10 @@ public:
 
   ClangTidyProfiling(llvm::Optional<StorageParams> Storage);
 
+  /// Creates the profile of one translation unit whose records are added to
+  /// \p Aggregate, instead of being reported, when it is destroyed.
+  explicit ClangTidyProfiling(ClangTidyProfiling &Aggregate);
+
   ~ClangTidyProfiling();
 };
 
@@ -22,6 +22,7 @@
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Threading.h"
 
 using namespace clang::ast_matchers;
 using namespace clang::driver;
@@ -225,6 +226,13 @@ over the real file system.
                                        cl::value_desc("filename"),
                                        cl::cat(ClangTidyCategory));
 
+static cl::opt<unsigned> Jobs("j", cl::desc(R"(
+Number of files to process in parallel in this
+process. 0 uses all hardware threads. Files are
+processed sequentially when -vfsoverlay is used.
+)"),
+                              cl::init(1), cl::cat(ClangTidyCategory));
+
 namespace clang {
 namespace tidy {
 
@@ -426,11 +434,17 @@ static int clangTidyMain(int argc, const char **argv) {
   llvm::InitializeAllTargetMCs();
   llvm::InitializeAllAsmParsers();
 
+  // Parallel runs give every thread its own physical file system, which an
+  // overlay read from a file can't be layered on top of.
+  unsigned NumJobs = Jobs == 0 ? llvm::hardware_concurrency() : Jobs;
+  if (!VfsOverlay.empty())
+    NumJobs = 1;
+
   ClangTidyContext Context(std::move(OwningOptionsProvider),
                            AllowEnablingAnalyzerAlphaCheckers);
   std::vector<ClangTidyError> Errors =
       runClangTidy(Context, OptionsParser.getCompilations(), PathList, BaseFS,
-                   EnableCheckProfile, ProfilePrefix);
+                   EnableCheckProfile, ProfilePrefix, NumJobs);
   bool FoundErrors = llvm::find_if(Errors, [](const ClangTidyError &E) {
                        return E.DiagLevel == ClangTidyError::Error;
                      }) != Errors.end();
@@ -166,6 +166,8 @@ struct CompletionCandidate {
   const Symbol *IndexResult = nullptr;
   const RawIdentifier *IdentifierResult = nullptr;
   llvm::SmallVector<llvm::StringRef, 1> RankedIncludeHeaders;
+  // The fuzzy match score of Name, if it was already computed.
+  llvm::Optional<float> NameMatch;
 
   // Returns a token identifying the overload set this is part of.
   // 0 indicates it's not part of any overload set.
@@ -1528,11 +1530,13 @@ private:
     llvm::DenseMap<size_t, size_t> BundleLookup;
     auto AddToBundles = [&](const CodeCompletionResult *SemaResult,
                             const Symbol *IndexResult,
-                            const RawIdentifier *IdentifierResult) {
+                            const RawIdentifier *IdentifierResult,
+                            llvm::Optional<float> NameMatch) {
       CompletionCandidate C;
       C.SemaResult = SemaResult;
       C.IndexResult = IndexResult;
       C.IdentifierResult = IdentifierResult;
+      C.NameMatch = NameMatch;
       if (C.IndexResult) {
         C.Name = IndexResult->Name;
         C.RankedIncludeHeaders = getRankedIncludes(*C.IndexResult);
@@ -1566,17 +1570,34 @@ private:
       return nullptr;
     };
     // Emit all Sema results, merging them with Index results if possible.
-    for (auto &SemaResult : SemaResults)
-      AddToBundles(&SemaResult, CorrespondingIndexResult(SemaResult), nullptr);
+    for (auto &SemaResult : SemaResults) {
+      // Member and global scope completion yield many results that can't
+      // match the filter. Drop them before computing their SymbolID, which
+      // needs a USR. The index result for a named decl has the same name, so
+      // it can't match either. The scores of the others are kept for ranking.
+      bool HasPlainName =
+          SemaResult.Kind != CodeCompletionResult::RK_Declaration ||
+          SemaResult.Declaration->getIdentifier();
+      llvm::Optional<float> NameMatch;
+      if (HasPlainName) {
+        NameMatch = Filter->match(Recorder->getName(SemaResult));
+        if (!NameMatch)
+          continue;
+      }
+      AddToBundles(&SemaResult, CorrespondingIndexResult(SemaResult), nullptr,
+                   NameMatch);
+    }
     // Now emit any Index-only results.
     for (const auto &IndexResult : IndexResults) {
       if (UsedIndexResults.count(&IndexResult))
         continue;
-      AddToBundles(/*SemaResult=*/nullptr, &IndexResult, nullptr);
+      AddToBundles(/*SemaResult=*/nullptr, &IndexResult, nullptr,
+                   /*NameMatch=*/None);
     }
     // Emit identifier results.
     for (const auto &Ident : IdentifierResults)
-      AddToBundles(/*SemaResult=*/nullptr, /*IndexResult=*/nullptr, &Ident);
+      AddToBundles(/*SemaResult=*/nullptr, /*IndexResult=*/nullptr, &Ident,
+                   /*NameMatch=*/None);
     // We only keep the best N results at any time, in "native" format.
     TopN<ScoredBundle, ScoredBundleGreater> Top(
         Opts.Limit == 0 ? std::numeric_limits<size_t>::max() : Opts.Limit);
@@ -1591,6 +1612,8 @@ private:
     if (C.SemaResult && C.SemaResult->Kind == CodeCompletionResult::RK_Macro &&
         !C.Name.startswith_lower(Filter->pattern()))
       return None;
+    if (C.NameMatch)
+      return C.NameMatch;
     return Filter->match(C.Name);
   }
 
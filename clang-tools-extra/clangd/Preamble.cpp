@@ -148,11 +148,13 @@ buildPreamble(PathRef FileName, CompilerInvocation &CI,
     vlog("Built preamble of size {0} for file {1}", BuiltPreamble->getSize(),
          FileName);
     std::vector<Diag> Diags = PreambleDiagnostics.take();
-    return std::make_shared<PreambleData>(
+    auto Result = std::make_shared<PreambleData>(
         std::move(*BuiltPreamble), std::move(Diags),
         SerializedDeclsCollector.takeIncludes(),
         SerializedDeclsCollector.takeMacros(), std::move(StatCache),
         SerializedDeclsCollector.takeCanonicalIncludes());
+    Result->CompileCommand = Inputs.CompileCommand;
+    return Result;
   } else {
     elog("Could not build a preamble for file {0}", FileName);
     return nullptr;
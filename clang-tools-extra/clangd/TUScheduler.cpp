@@ -147,6 +147,47 @@ private:
   std::vector<KVPair> LRU; /* GUARDED_BY(Mut) */
 };
 
+/// Retains the preambles of closed files, in case they're reopened.
+/// This is bounded by the total size of the preambles; the least recently
+/// closed ones are dropped first. Only accessed by the TUScheduler's thread.
+class TUScheduler::PreambleCache {
+public:
+  PreambleCache(size_t MaxBytes) : MaxBytes(MaxBytes) {}
+
+  /// Store the preamble of a closed file, possibly dropping older ones.
+  void put(PathRef File, std::shared_ptr<const PreambleData> Preamble) {
+    take(File);
+    if (!Preamble || Preamble->Preamble.getSize() > MaxBytes)
+      return;
+    UsedBytes += Preamble->Preamble.getSize();
+    LRU.insert(LRU.begin(), {File, std::move(Preamble)});
+    while (UsedBytes > MaxBytes) {
+      UsedBytes -= LRU.back().second->Preamble.getSize();
+      LRU.pop_back();
+    }
+  }
+
+  /// Returns the retained preamble for \p File, if any, and forgets it.
+  std::shared_ptr<const PreambleData> take(PathRef File) {
+    auto It =
+        llvm::find_if(LRU, [&](const Entry &E) { return E.first == File; });
+    if (It == LRU.end())
+      return nullptr;
+    std::shared_ptr<const PreambleData> Preamble = std::move(It->second);
+    UsedBytes -= Preamble->Preamble.getSize();
+    LRU.erase(It);
+    return Preamble;
+  }
+
+private:
+  using Entry = std::pair<Path, std::shared_ptr<const PreambleData>>;
+
+  const size_t MaxBytes;
+  size_t UsedBytes = 0;
+  /// Most recently closed first.
+  std::vector<Entry> LRU;
+};
+
 namespace {
 class ASTWorkerHandle;
 
@@ -165,7 +206,8 @@ class ASTWorker {
   ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
             TUScheduler::ASTCache &LRUCache, Semaphore &Barrier, bool RunSync,
             steady_clock::duration UpdateDebounce, bool StorePreamblesInMemory,
-            ParsingCallbacks &Callbacks);
+            ParsingCallbacks &Callbacks,
+            std::shared_ptr<const PreambleData> InitialPreamble);
 
 public:
   /// Create a new ASTWorker and return a handle to it.
@@ -173,11 +215,13 @@ public:
   /// is null, all requests will be processed on the calling thread
   /// synchronously instead. \p Barrier is acquired when processing each
   /// request, it is used to limit the number of actively running threads.
+  /// \p InitialPreamble, if any, is reused by the first update if it's valid.
   static ASTWorkerHandle
   create(PathRef FileName, const GlobalCompilationDatabase &CDB,
          TUScheduler::ASTCache &IdleASTs, AsyncTaskRunner *Tasks,
          Semaphore &Barrier, steady_clock::duration UpdateDebounce,
-         bool StorePreamblesInMemory, ParsingCallbacks &Callbacks);
+         bool StorePreamblesInMemory, ParsingCallbacks &Callbacks,
+         std::shared_ptr<const PreambleData> InitialPreamble = nullptr);
   ~ASTWorker();
 
   void update(ParseInputs Inputs, WantDiagnostics);
@@ -327,10 +371,11 @@ ASTWorkerHandle
 ASTWorker::create(PathRef FileName, const GlobalCompilationDatabase &CDB,
                   TUScheduler::ASTCache &IdleASTs, AsyncTaskRunner *Tasks,
                   Semaphore &Barrier, steady_clock::duration UpdateDebounce,
-                  bool StorePreamblesInMemory, ParsingCallbacks &Callbacks) {
-  std::shared_ptr<ASTWorker> Worker(
-      new ASTWorker(FileName, CDB, IdleASTs, Barrier, /*RunSync=*/!Tasks,
-                    UpdateDebounce, StorePreamblesInMemory, Callbacks));
+                  bool StorePreamblesInMemory, ParsingCallbacks &Callbacks,
+                  std::shared_ptr<const PreambleData> InitialPreamble) {
+  std::shared_ptr<ASTWorker> Worker(new ASTWorker(
+      FileName, CDB, IdleASTs, Barrier, /*RunSync=*/!Tasks, UpdateDebounce,
+      StorePreamblesInMemory, Callbacks, std::move(InitialPreamble)));
   if (Tasks)
     Tasks->runAsync("worker:" + llvm::sys::path::filename(FileName),
                     [Worker]() { Worker->run(); });
@@ -341,13 +386,15 @@ ASTWorker::create(PathRef FileName, const GlobalCompilationDatabase &CDB,
 ASTWorker::ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
                      TUScheduler::ASTCache &LRUCache, Semaphore &Barrier,
                      bool RunSync, steady_clock::duration UpdateDebounce,
-                     bool StorePreamblesInMemory, ParsingCallbacks &Callbacks)
+                     bool StorePreamblesInMemory, ParsingCallbacks &Callbacks,
+                     std::shared_ptr<const PreambleData> InitialPreamble)
     : IdleASTs(LRUCache), RunSync(RunSync), UpdateDebounce(UpdateDebounce),
       FileName(FileName), CDB(CDB),
       StorePreambleInMemory(StorePreamblesInMemory),
       Callbacks(Callbacks), Status{TUAction(TUAction::Idle, ""),
                                    TUStatus::BuildDetails()},
-      Barrier(Barrier), Done(false) {
+      Barrier(Barrier), LastBuiltPreamble(std::move(InitialPreamble)),
+      Done(false) {
   auto Inputs = std::make_shared<ParseInputs>();
   // Set a fallback command because compile command can be accessed before
   // `Inputs` is initialized. Other fields are only used after initialization
@@ -393,7 +440,6 @@ void ASTWorker::update(ParseInputs Inputs, WantDiagnostics WantDiags) {
         std::tie(PrevInputs->CompileCommand, PrevInputs->Contents) ==
         std::tie(Inputs.CompileCommand, Inputs.Contents);
 
-    tooling::CompileCommand OldCommand = PrevInputs->CompileCommand;
     bool RanCallbackForPrevInputs = RanASTCallback;
     {
       std::lock_guard<std::mutex> Lock(Mutex);
@@ -433,6 +479,10 @@ void ASTWorker::update(ParseInputs Inputs, WantDiagnostics WantDiags) {
 
     std::shared_ptr<const PreambleData> OldPreamble =
         getPossiblyStalePreamble();
+    // The old preamble may predate the previous inputs (it was stale, or was
+    // retained from before the file was closed), so check its own command.
+    tooling::CompileCommand OldCommand =
+        OldPreamble ? OldPreamble->CompileCommand : PrevInputs->CompileCommand;
     std::shared_ptr<const PreambleData> NewPreamble = buildPreamble(
         FileName, *Invocation, OldPreamble, OldCommand, Inputs,
         StorePreambleInMemory,
@@ -857,6 +907,8 @@ TUScheduler::TUScheduler(const GlobalCompilationDatabase &CDB,
                           : std::make_unique<ParsingCallbacks>()),
       Barrier(AsyncThreadsCount),
       IdleASTs(std::make_unique<ASTCache>(RetentionPolicy.MaxRetainedASTs)),
+      ClosedPreambles(std::make_unique<PreambleCache>(
+          RetentionPolicy.MaxRetainedPreambleBytes)),
       UpdateDebounce(UpdateDebounce) {
   if (0 < AsyncThreadsCount) {
     PreambleTasks.emplace();
@@ -894,7 +946,8 @@ bool TUScheduler::update(PathRef File, ParseInputs Inputs,
     ASTWorkerHandle Worker = ASTWorker::create(
         File, CDB, *IdleASTs,
         WorkerThreads ? WorkerThreads.getPointer() : nullptr, Barrier,
-        UpdateDebounce, StorePreamblesInMemory, *Callbacks);
+        UpdateDebounce, StorePreamblesInMemory, *Callbacks,
+        ClosedPreambles->take(File));
     FD = std::unique_ptr<FileData>(
         new FileData{Inputs.Contents, std::move(Worker)});
   } else {
@@ -905,10 +958,14 @@ bool TUScheduler::update(PathRef File, ParseInputs Inputs,
 }
 
 void TUScheduler::remove(PathRef File) {
-  bool Removed = Files.erase(File);
-  if (!Removed)
+  auto It = Files.find(File);
+  if (It == Files.end()) {
     elog("Trying to remove file from TUScheduler that is not tracked: {0}",
          File);
+    return;
+  }
+  ClosedPreambles->put(File, It->second->Worker->getPossiblyStalePreamble());
+  Files.erase(It);
 }
 
 llvm::StringRef TUScheduler::getContents(PathRef File) const {
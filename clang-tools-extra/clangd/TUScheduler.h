@@ -58,6 +58,10 @@ struct ASTRetentionPolicy {
   /// Maximum number of ASTs to be retained in memory when there are no pending
   /// requests for them.
   unsigned MaxRetainedASTs = 3;
+  /// Maximum total size of preambles retained for closed files. Reopening
+  /// such a file reuses its preamble if it's still valid, rather than building
+  /// it again. The least recently closed files are dropped first.
+  size_t MaxRetainedPreambleBytes = 0;
 };
 
 struct TUAction {
@@ -239,6 +243,8 @@ public:
   /// Responsible for retaining and rebuilding idle ASTs. An implementation is
   /// an LRU cache.
   class ASTCache;
+  /// Retains preambles of closed files, bounded by total size.
+  class PreambleCache;
 
   // The file being built/processed in the current thread. This is a hack in
   // order to get the file name into the index implementations. Do not depend on
@@ -254,6 +260,7 @@ private:
   Semaphore Barrier;
   llvm::StringMap<std::unique_ptr<FileData>> Files;
   std::unique_ptr<ASTCache> IdleASTs;
+  std::unique_ptr<PreambleCache> ClosedPreambles;
   // None when running tasks synchronously and non-None when running tasks
   // asynchronously.
   llvm::Optional<AsyncTaskRunner> PreambleTasks;
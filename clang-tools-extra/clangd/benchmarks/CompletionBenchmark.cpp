@@ -0,0 +1,113 @@
+//===--- CompletionBenchmark.cpp - Clangd completion benchmarks -*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "../CodeComplete.h"
+#include "../Compiler.h"
+#include "../Preamble.h"
+#include "benchmark/benchmark.h"
+#include "clang/Tooling/CompilationDatabase.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include <string>
+#include <tuple>
+
+std::string SourceFilename;
+clang::clangd::Position CompletionPosition;
+
+namespace clang {
+namespace clangd {
+namespace {
+
+// Uses the compile command from the compilation database next to the file, if
+// there is one.
+tooling::CompileCommand getCompileCommand(llvm::StringRef File) {
+  std::string Error;
+  if (auto CDB = tooling::CompilationDatabase::autoDetectFromSource(File,
+                                                                    Error)) {
+    auto Commands = CDB->getCompileCommands(File);
+    if (!Commands.empty())
+      return std::move(Commands.front());
+  }
+  return tooling::CompileCommand(llvm::sys::path::parent_path(File), File,
+                                 {"clang", "-fsyntax-only", File.str()},
+                                 /*Output=*/"");
+}
+
+// Completes at the given point of the file the way clangd does once the
+// preamble is built: parses the main file with the preamble, then merges,
+// scores and ranks the Sema results.
+static void CodeCompleteFile(benchmark::State &State) {
+  auto Buffer = llvm::MemoryBuffer::getFile(SourceFilename);
+  if (!Buffer) {
+    State.SkipWithError("cannot read the source file");
+    return;
+  }
+  ParseInputs Inputs;
+  Inputs.CompileCommand = getCompileCommand(SourceFilename);
+  Inputs.FS = llvm::vfs::getRealFileSystem();
+  Inputs.Contents = (*Buffer)->getBuffer().str();
+  IgnoreDiagnostics Diags;
+  auto CI = buildCompilerInvocation(Inputs, Diags);
+  if (!CI) {
+    State.SkipWithError("cannot build the compiler invocation");
+    return;
+  }
+  auto Preamble = buildPreamble(SourceFilename, *CI, /*OldPreamble=*/nullptr,
+                                Inputs.CompileCommand, Inputs,
+                                /*StoreInMemory=*/true,
+                                /*PreambleCallback=*/nullptr);
+
+  CodeCompleteOptions Opts;
+  Opts.Limit = State.range(0);
+  size_t NumCompletions = 0;
+  for (auto _ : State) {
+    CodeCompleteResult Result =
+        codeComplete(SourceFilename, Inputs.CompileCommand, Preamble.get(),
+                     Inputs.Contents, CompletionPosition, Inputs.FS, Opts);
+    NumCompletions = Result.Completions.size();
+    benchmark::DoNotOptimize(Result);
+  }
+  State.SetLabel(std::to_string(NumCompletions) + " completions");
+}
+// The default limit of clangd, and no limit.
+BENCHMARK(CodeCompleteFile)->Arg(100)->Arg(0)->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace clangd
+} // namespace clang
+
+int main(int argc, char *argv[]) {
+  llvm::StringRef Line, Column;
+  if (argc >= 3)
+    std::tie(Line, Column) = llvm::StringRef(argv[2]).split(':');
+  unsigned LineNumber, ColumnNumber;
+  if (argc < 3 || Line.getAsInteger(10, LineNumber) ||
+      Column.getAsInteger(10, ColumnNumber) || LineNumber == 0 ||
+      ColumnNumber == 0) {
+    llvm::errs() << "Usage: " << argv[0]
+                 << " source.cpp line:column BENCHMARK_OPTIONS...\n";
+    return -1;
+  }
+  llvm::SmallString<256> Path(argv[1]);
+  llvm::sys::fs::make_absolute(Path);
+  llvm::sys::path::remove_dots(Path, /*remove_dot_dot=*/true);
+  SourceFilename = Path.str();
+  CompletionPosition.line = LineNumber - 1;
+  CompletionPosition.character = ColumnNumber - 1;
+  // Trim first two arguments of the benchmark invocation and pretend no
+  // arguments were passed in the first place.
+  argv[2] = argv[0];
+  argv += 2;
+  argc -= 2;
+  ::benchmark::Initialize(&argc, argv);
+  ::benchmark::RunSpecifiedBenchmarks();
+}
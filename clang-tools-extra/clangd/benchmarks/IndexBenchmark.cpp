@@ -8,6 +8,8 @@
 
 #include "../index/Serialization.h"
 #include "../index/dex/Dex.h"
+#include "../index/dex/Iterator.h"
+#include "../index/dex/PostingList.h"
 #include "benchmark/benchmark.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
@@ -83,6 +85,33 @@ static void DexQueries(benchmark::State &State) {
 }
 BENCHMARK(DexQueries);
 
+// Intersects a dense posting list with one that has every N-th of its IDs.
+// This is synthetic, so it doesn't depend on the index passed in; it isolates
+// chunk decoding and skipping from the rest of fuzzyFind.
+static void DexIntersection(benchmark::State &State) {
+  constexpr dex::DocID Size = 1 << 20;
+  std::vector<dex::DocID> Dense, Sparse;
+  for (dex::DocID I = 0; I < Size; ++I) {
+    Dense.push_back(I * 3);
+    if (I % State.range(0) == 0)
+      Sparse.push_back(I * 3);
+  }
+  const dex::PostingList DenseList(Dense), SparseList(Sparse);
+  const dex::Corpus Corpus(Size * 3);
+  for (auto _ : State) {
+    std::vector<std::unique_ptr<dex::Iterator>> Children;
+    Children.push_back(DenseList.iterator());
+    Children.push_back(SparseList.iterator());
+    auto And = Corpus.intersect(std::move(Children));
+    size_t Matches = 0;
+    for (; !And->reachedEnd(); And->advance())
+      ++Matches;
+    benchmark::DoNotOptimize(Matches);
+  }
+  State.SetItemsProcessed(State.iterations() * Size);
+}
+BENCHMARK(DexIntersection)->Arg(1)->Arg(16)->Arg(1024);
+
 } // namespace
 } // namespace clangd
 } // namespace clang
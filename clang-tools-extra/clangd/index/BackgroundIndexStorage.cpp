@@ -21,6 +21,7 @@
 #include "llvm/Support/FileUtilities.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
+#include <atomic>
 #include <functional>
 
 namespace clang {
@@ -36,6 +37,30 @@ std::string getShardPathFromFilePath(llvm::StringRef ShardRoot,
   return ShardRootSS.str();
 }
 
+// String tables at least this large are stored uncompressed. Most shards are
+// far smaller, and keep their compressed string table.
+constexpr size_t MinMappedStrings = 64 * 1024;
+
+// Every mapping counts against the process limit (vm.max_map_count, 65530 by
+// default on Linux), and a large project has many more shards than that. Past
+// this many live mappings, shards are copied to the heap instead.
+constexpr unsigned MaxMappedShards = 8192;
+std::atomic<unsigned> MappedShards = {0};
+
+bool acquireMappingSlot(const llvm::MemoryBuffer &Buffer) {
+  if (Buffer.getBufferKind() != llvm::MemoryBuffer::MemoryBuffer_MMap)
+    return false;
+  if (++MappedShards <= MaxMappedShards)
+    return true;
+  --MappedShards;
+  return false;
+}
+
+void releaseMapping(const llvm::MemoryBuffer *Buffer) {
+  delete Buffer;
+  --MappedShards;
+}
+
 // Uses disk as a storage for index shards. Creates a directory called
 // ".clangd/index/" under the path provided during construction.
 class DiskBackedIndexStorage : public BackgroundIndexStorage {
@@ -60,10 +85,26 @@ public:
   loadShard(llvm::StringRef ShardIdentifier) const override {
     const std::string ShardPath =
         getShardPathFromFilePath(DiskShardRoot, ShardIdentifier);
-    auto Buffer = llvm::MemoryBuffer::getFile(ShardPath);
+    // Shards are replaced by renaming over them, which leaves existing
+    // mappings intact on POSIX. Windows can't rename over a mapped file.
+#ifdef _WIN32
+    const bool IsVolatile = true;
+#else
+    const bool IsVolatile = false;
+#endif
+    auto Buffer = llvm::MemoryBuffer::getFile(
+        ShardPath, /*FileSize=*/-1, /*RequiresNullTerminator=*/false,
+        IsVolatile);
     if (!Buffer)
       return nullptr;
-    if (auto I = readIndexFile(Buffer->get()->getBuffer()))
+    // Strings of a mapped shard are referenced in place, and the loaded slabs
+    // keep the mapping alive. Shards read onto the heap are copied out instead,
+    // so that their buffer is freed as soon as they have been read.
+    auto I = acquireMappingSlot(**Buffer)
+                 ? readIndexFile(std::shared_ptr<const llvm::MemoryBuffer>(
+                       Buffer->release(), releaseMapping))
+                 : readIndexFile((*Buffer)->getBuffer());
+    if (I)
       return std::make_unique<IndexFileIn>(std::move(*I));
     else
       elog("Error while reading shard {0}: {1}", ShardIdentifier,
@@ -74,6 +115,9 @@ public:
   llvm::Error storeShard(llvm::StringRef ShardIdentifier,
                          IndexFileOut Shard) const override {
     auto ShardPath = getShardPathFromFilePath(DiskShardRoot, ShardIdentifier);
+    // Large string tables are kept uncompressed, so that loadShard can read
+    // them in place. Such shards are always big enough to be mapped.
+    Shard.MinUncompressedStrings = MinMappedStrings;
     return llvm::writeFileAtomically(ShardPath + ".tmp.%%%%%%%%", ShardPath,
                                      [&Shard](llvm::raw_ostream &OS) {
                                        OS << Shard;
@@ -19,7 +19,6 @@
 #include "URI.h"
 #include "index/FileIndex.h"
 #include "index/IndexAction.h"
-#include "index/MemIndex.h"
 #include "index/Ref.h"
 #include "index/Relation.h"
 #include "index/Serialization.h"
@@ -48,7 +47,6 @@
 
 namespace clang {
 namespace clangd {
-
 bool BackgroundIndexRebuilder::enoughTUsToRebuild() const {
   if (!ActiveVersion)                         // never built
     return IndexedTUs == TUsBeforeFirstBuild; // use low threshold
@@ -64,7 +62,7 @@ void BackgroundIndexRebuilder::indexedTU() {
     if (ActiveVersion != StartedVersion) // currently building
       return false;                      // no urgency, avoid overlapping builds
     return enoughTUsToRebuild();
-  });
+  }, /*AllowIncremental=*/true);
 }
 
 void BackgroundIndexRebuilder::idle() {
@@ -72,7 +70,7 @@ void BackgroundIndexRebuilder::idle() {
     // rebuild if there's anything new in the index.
     // (even if currently rebuilding! this ensures eventual completeness)
     return IndexedTUs > IndexedTUsAtLastRebuild;
-  });
+  }, /*AllowIncremental=*/true);
 }
 
 void BackgroundIndexRebuilder::startLoading() {
@@ -94,7 +92,7 @@ void BackgroundIndexRebuilder::doneLoading() {
       return false; // rebuild once the last batch is done.
     // Rebuild if we loaded any shards, or if we stopped an indexedTU rebuild.
     return LoadedShards > 0 || enoughTUsToRebuild();
-  });
+  }, /*AllowIncremental=*/false);
 }
 
 void BackgroundIndexRebuilder::shutdown() {
@@ -103,25 +101,50 @@ void BackgroundIndexRebuilder::shutdown() {
 }
 
 void BackgroundIndexRebuilder::maybeRebuild(const char *Reason,
-                                            std::function<bool()> Check) {
+                                            std::function<bool()> Check,
+                                            bool AllowIncremental) {
   unsigned BuildVersion = 0;
+  // If set, only changed files are indexed, and layered over this.
+  std::shared_ptr<SymbolIndex> LayerOver;
   {
     std::lock_guard<std::mutex> Lock(Mu);
     if (!ShouldStop && Check()) {
       BuildVersion = ++StartedVersion;
       IndexedTUsAtLastRebuild = IndexedTUs;
+      // Changes are relative to the last full build *started*, so we can only
+      // layer over it once it has finished.
+      if (AllowIncremental && FullIndex &&
+          StartedFullVersion == FullIndexVersion &&
+          Source->numChangedFiles() < ChangedFilesBeforeFullRebuild)
+        LayerOver = FullIndex;
+      else
+        StartedFullVersion = BuildVersion;
     }
   }
   if (BuildVersion) {
-    std::unique_ptr<SymbolIndex> NewIndex;
+    std::shared_ptr<SymbolIndex> NewIndex;
+    std::shared_ptr<SymbolIndex> NewFullIndex;
     {
-      vlog("BackgroundIndex: building version {0} {1}", BuildVersion, Reason);
+      vlog("BackgroundIndex: building version {0} {1}{2}", BuildVersion,
+           Reason, LayerOver ? " (changed files only)" : "");
       trace::Span Tracer("RebuildBackgroundIndex");
       SPAN_ATTACH(Tracer, "reason", Reason);
-      NewIndex = Source->buildIndex(IndexType::Heavy, DuplicateHandling::Merge);
+      SPAN_ATTACH(Tracer, "incremental", bool(LayerOver));
+      if (LayerOver) {
+        NewIndex =
+            Source->buildIndexOverBase(IndexType::Heavy, std::move(LayerOver));
+      } else {
+        NewFullIndex =
+            Source->buildIndex(IndexType::Heavy, DuplicateHandling::Merge);
+        NewIndex = NewFullIndex;
+      }
     }
     {
       std::lock_guard<std::mutex> Lock(Mu);
+      if (NewFullIndex && BuildVersion > FullIndexVersion) {
+        FullIndex = std::move(NewFullIndex);
+        FullIndexVersion = BuildVersion;
+      }
       // Guard against rebuild finishing in the wrong order.
       if (BuildVersion > ActiveVersion) {
         ActiveVersion = BuildVersion;
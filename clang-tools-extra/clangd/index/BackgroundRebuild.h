@@ -40,6 +40,11 @@ namespace clangd {
 //
 // The index is rebuilt every time the queue goes idle, if it's stale.
 //
+// Rebuilds other than after loading are usually incremental: only the files
+// changed since the last full build are indexed, and served on top of it in
+// place of their old data. Once enough files have changed, everything is
+// rebuilt, as every incremental build redoes all the changes.
+//
 // All methods are threadsafe. They're called after FileSymbols is updated
 // etc. Without external locking, the rebuilt index may include more updates
 // than intended, which is fine.
@@ -73,10 +78,15 @@ public:
   // Thresholds for rebuilding as TUs get indexed.
   const unsigned TUsBeforeFirstBuild; // Typically one per worker thread.
   const unsigned TUsBeforeRebuild = 100;
+  // Rebuilds only index the changed files, on top of the last full build,
+  // until this many files have changed. Then everything is rebuilt.
+  const unsigned ChangedFilesBeforeFullRebuild = 500;
 
 private:
   // Run Check under the lock, and rebuild if it returns true.
-  void maybeRebuild(const char *Reason, std::function<bool()> Check);
+  // If AllowIncremental, only the changed files may be rebuilt.
+  void maybeRebuild(const char *Reason, std::function<bool()> Check,
+                    bool AllowIncremental);
   bool enoughTUsToRebuild() const;
 
   // All transient state is guarded by the mutex.
@@ -91,6 +101,10 @@ private:
   // Are we loading shards? May be multiple concurrent sessions.
   unsigned Loading = 0;
   unsigned LoadedShards; // In the current loading session.
+  // The last full build, which incremental builds are layered over.
+  std::shared_ptr<SymbolIndex> FullIndex;
+  unsigned FullIndexVersion = 0;
+  unsigned StartedFullVersion = 0;
 
   SwapIndex *Target;
   FileSymbols *Source;
@@ -26,7 +26,9 @@
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringRef.h"
+#include <algorithm>
 #include <memory>
+#include <set>
 
 namespace clang {
 namespace clangd {
@@ -105,6 +107,20 @@ void FileSymbols::update(PathRef Path, std::unique_ptr<SymbolSlab> Symbols,
                          std::unique_ptr<RelationSlab> Relations,
                          bool CountReferences) {
   std::lock_guard<std::mutex> Lock(Mutex);
+  auto Changed = ChangedFiles.try_emplace(Path);
+  if (Changed.second) {
+    // Remember what the last buildIndex() saw for this file.
+    FileSlabs &Old = Changed.first->second;
+    auto SymbolsIt = FileToSymbols.find(Path);
+    if (SymbolsIt != FileToSymbols.end())
+      Old.Symbols = SymbolsIt->second;
+    auto RefsIt = FileToRefs.find(Path);
+    if (RefsIt != FileToRefs.end())
+      Old.Refs = RefsIt->second;
+    auto RelationsIt = FileToRelations.find(Path);
+    if (RelationsIt != FileToRelations.end())
+      Old.Relations = RelationsIt->second;
+  }
   if (!Symbols)
     FileToSymbols.erase(Path);
   else
@@ -123,6 +139,75 @@ void FileSymbols::update(PathRef Path, std::unique_ptr<SymbolSlab> Symbols,
     FileToRelations[Path] = std::move(Relations);
 }
 
+size_t FileSymbols::numChangedFiles() const {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  return ChangedFiles.size();
+}
+
+// Groups the refs from all slabs by symbol, in contiguous ranges of Storage.
+static llvm::DenseMap<SymbolID, llvm::ArrayRef<Ref>>
+mergeRefs(llvm::ArrayRef<std::shared_ptr<RefSlab>> RefSlabs,
+          std::vector<Ref> &Storage) {
+  llvm::DenseMap<SymbolID, llvm::ArrayRef<Ref>> AllRefs;
+  llvm::DenseMap<SymbolID, llvm::SmallVector<Ref, 4>> MergedRefs;
+  size_t Count = 0;
+  for (const auto &RefSlab : RefSlabs)
+    for (const auto &Sym : *RefSlab) {
+      MergedRefs[Sym.first].append(Sym.second.begin(), Sym.second.end());
+      Count += Sym.second.size();
+    }
+  Storage.reserve(Count);
+  AllRefs.reserve(MergedRefs.size());
+  for (auto &Sym : MergedRefs) {
+    auto &SymRefs = Sym.second;
+    // Sorting isn't required, but yields more stable results over rebuilds.
+    llvm::sort(SymRefs);
+    llvm::copy(SymRefs, back_inserter(Storage));
+    AllRefs.try_emplace(Sym.first,
+                        llvm::ArrayRef<Ref>(&Storage[Storage.size() -
+                                                     SymRefs.size()],
+                                            SymRefs.size()));
+  }
+  return AllRefs;
+}
+
+// Builds an index that keeps the slabs and contiguous ranges alive.
+static std::unique_ptr<SymbolIndex>
+makeIndex(IndexType Type, std::vector<const Symbol *> AllSymbols,
+          llvm::DenseMap<SymbolID, llvm::ArrayRef<Ref>> AllRefs,
+          std::vector<Relation> AllRelations,
+          std::vector<std::shared_ptr<SymbolSlab>> SymbolSlabs,
+          std::vector<std::shared_ptr<RefSlab>> RefSlabs,
+          std::vector<std::shared_ptr<RelationSlab>> RelationSlabs,
+          std::vector<Ref> RefsStorage, std::vector<Symbol> SymsStorage) {
+  size_t StorageSize =
+      RefsStorage.size() * sizeof(Ref) + SymsStorage.size() * sizeof(Symbol);
+  for (const auto &Slab : SymbolSlabs)
+    StorageSize += Slab->bytes();
+  for (const auto &RefSlab : RefSlabs)
+    StorageSize += RefSlab->bytes();
+  for (const auto &RelationSlab : RelationSlabs)
+    StorageSize += RelationSlab->bytes();
+
+  switch (Type) {
+  case IndexType::Light:
+    return std::make_unique<MemIndex>(
+        llvm::make_pointee_range(AllSymbols), std::move(AllRefs),
+        std::move(AllRelations),
+        std::make_tuple(std::move(SymbolSlabs), std::move(RefSlabs),
+                        std::move(RefsStorage), std::move(SymsStorage)),
+        StorageSize);
+  case IndexType::Heavy:
+    return std::make_unique<dex::Dex>(
+        llvm::make_pointee_range(AllSymbols), std::move(AllRefs),
+        std::move(AllRelations),
+        std::make_tuple(std::move(SymbolSlabs), std::move(RefSlabs),
+                        std::move(RefsStorage), std::move(SymsStorage)),
+        StorageSize);
+  }
+  llvm_unreachable("Unknown clangd::IndexType");
+}
+
 std::unique_ptr<SymbolIndex>
 FileSymbols::buildIndex(IndexType Type, DuplicateHandling DuplicateHandle) {
   std::vector<std::shared_ptr<SymbolSlab>> SymbolSlabs;
@@ -140,6 +225,7 @@ FileSymbols::buildIndex(IndexType Type, DuplicateHandling DuplicateHandle) {
     }
     for (const auto &FileAndRelations : FileToRelations)
       RelationSlabs.push_back(FileAndRelations.second);
+    ChangedFiles.clear();
   }
   std::vector<const Symbol *> AllSymbols;
   std::vector<Symbol> SymsStorage;
@@ -184,28 +270,7 @@ FileSymbols::buildIndex(IndexType Type, DuplicateHandling DuplicateHandle) {
   }
 
   std::vector<Ref> RefsStorage; // Contiguous ranges for each SymbolID.
-  llvm::DenseMap<SymbolID, llvm::ArrayRef<Ref>> AllRefs;
-  {
-    llvm::DenseMap<SymbolID, llvm::SmallVector<Ref, 4>> MergedRefs;
-    size_t Count = 0;
-    for (const auto &RefSlab : RefSlabs)
-      for (const auto &Sym : *RefSlab) {
-        MergedRefs[Sym.first].append(Sym.second.begin(), Sym.second.end());
-        Count += Sym.second.size();
-      }
-    RefsStorage.reserve(Count);
-    AllRefs.reserve(MergedRefs.size());
-    for (auto &Sym : MergedRefs) {
-      auto &SymRefs = Sym.second;
-      // Sorting isn't required, but yields more stable results over rebuilds.
-      llvm::sort(SymRefs);
-      llvm::copy(SymRefs, back_inserter(RefsStorage));
-      AllRefs.try_emplace(
-          Sym.first,
-          llvm::ArrayRef<Ref>(&RefsStorage[RefsStorage.size() - SymRefs.size()],
-                              SymRefs.size()));
-    }
-  }
+  auto AllRefs = mergeRefs(RefSlabs, RefsStorage);
 
   std::vector<Relation> AllRelations;
   for (const auto &RelationSlab : RelationSlabs) {
@@ -213,33 +278,309 @@ FileSymbols::buildIndex(IndexType Type, DuplicateHandling DuplicateHandle) {
       AllRelations.push_back(R);
   }
 
-  size_t StorageSize =
-      RefsStorage.size() * sizeof(Ref) + SymsStorage.size() * sizeof(Symbol);
-  for (const auto &Slab : SymbolSlabs)
-    StorageSize += Slab->bytes();
-  for (const auto &RefSlab : RefSlabs)
-    StorageSize += RefSlab->bytes();
-  for (const auto &RelationSlab : RelationSlabs)
-    StorageSize += RelationSlab->bytes();
+  return makeIndex(Type, std::move(AllSymbols), std::move(AllRefs),
+                   std::move(AllRelations), std::move(SymbolSlabs),
+                   std::move(RefSlabs), std::move(RelationSlabs),
+                   std::move(RefsStorage), std::move(SymsStorage));
+}
 
-  // Index must keep the slabs and contiguous ranges alive.
-  switch (Type) {
-  case IndexType::Light:
-    return std::make_unique<MemIndex>(
-        llvm::make_pointee_range(AllSymbols), std::move(AllRefs),
-        std::move(AllRelations),
-        std::make_tuple(std::move(SymbolSlabs), std::move(RefSlabs),
-                        std::move(RefsStorage), std::move(SymsStorage)),
-        StorageSize);
-  case IndexType::Heavy:
-    return std::make_unique<dex::Dex>(
-        llvm::make_pointee_range(AllSymbols), std::move(AllRefs),
-        std::move(AllRelations),
-        std::make_tuple(std::move(SymbolSlabs), std::move(RefSlabs),
-                        std::move(RefsStorage), std::move(SymsStorage)),
-        StorageSize);
+namespace {
+// Serves a full build of FileSymbols, with the data of the files changed
+// since then replaced by a small index of those files.
+class LayeredIndex : public SymbolIndex {
+public:
+  // What Changes replaces in Full.
+  struct Overrides {
+    // Symbols whose data in Full is out of date. Changes has them, merged from
+    // all files, unless they were removed.
+    llvm::DenseSet<SymbolID> Symbols;
+    // Changes in Symbol::References of symbols in Full.
+    llvm::DenseMap<SymbolID, int> ReferenceDeltas;
+    // Refs of the changed files in Full, by symbol.
+    llvm::DenseMap<SymbolID, std::vector<llvm::ArrayRef<Ref>>> StaleRefs;
+    std::vector<std::shared_ptr<RefSlab>> StaleRefSlabs;
+    // All objects of the relations whose subject and predicate appear in the
+    // changed files.
+    llvm::DenseMap<std::pair<SymbolID, uint8_t>, std::vector<SymbolID>>
+        Relations;
+  };
+
+  LayeredIndex(std::unique_ptr<SymbolIndex> Changes,
+               std::shared_ptr<SymbolIndex> Full, Overrides Replaced)
+      : Changes(std::move(Changes)), Full(std::move(Full)),
+        Replaced(std::move(Replaced)) {}
+
+  bool fuzzyFind(const FuzzyFindRequest &Req,
+                 llvm::function_ref<void(const Symbol &)> Callback)
+      const override {
+    bool More = false;
+    SymbolSlab::Builder B;
+    More |= Changes->fuzzyFind(Req, [&](const Symbol &S) { B.insert(S); });
+    SymbolSlab New = std::move(B).build();
+    llvm::DenseSet<SymbolID> Seen;
+    auto OnFull = [&](const Symbol &S) {
+      if (!Replaced.Symbols.count(S.ID))
+        return Callback(withReferences(S, S.References));
+      auto It = New.find(S.ID);
+      if (It == New.end())
+        return; // Removed, or no longer matches.
+      Seen.insert(S.ID);
+      Callback(withReferences(*It, It->References + S.References));
+    };
+    More |= Full->fuzzyFind(Req, OnFull);
+    // Full counts the references of replaced symbols it has, even if the old
+    // version didn't match.
+    LookupRequest Missing;
+    for (const Symbol &S : New)
+      if (!Seen.count(S.ID))
+        Missing.IDs.insert(S.ID);
+    Full->lookup(Missing, OnFull);
+    for (const Symbol &S : New)
+      if (!Seen.count(S.ID))
+        Callback(S);
+    return More;
   }
-  llvm_unreachable("Unknown clangd::IndexType");
+
+  void lookup(const LookupRequest &Req,
+              llvm::function_ref<void(const Symbol &)> Callback) const override {
+    SymbolSlab::Builder B;
+    Changes->lookup(Req, [&](const Symbol &S) { B.insert(S); });
+    auto RemainingIDs = Req.IDs;
+    Full->lookup(Req, [&](const Symbol &S) {
+      RemainingIDs.erase(S.ID);
+      if (!Replaced.Symbols.count(S.ID))
+        return Callback(withReferences(S, S.References));
+      if (const Symbol *New = B.find(S.ID))
+        Callback(withReferences(*New, New->References + S.References));
+    });
+    // Symbols that are new since the full build count all their references.
+    for (const auto &ID : RemainingIDs)
+      if (const Symbol *New = B.find(ID))
+        Callback(*New);
+  }
+
+  bool refs(const RefsRequest &Req,
+            llvm::function_ref<void(const Ref &)> Callback) const override {
+    uint32_t Remaining =
+        Req.Limit.getValueOr(std::numeric_limits<uint32_t>::max());
+    bool More = false;
+    auto Report = [&](const Ref &R) {
+      if (Remaining == 0) {
+        More = true;
+        return;
+      }
+      --Remaining;
+      Callback(R);
+    };
+    RefsRequest Unchanged = Req;
+    Unchanged.IDs.clear();
+    for (const SymbolID &ID : Req.IDs) {
+      auto It = Replaced.StaleRefs.find(ID);
+      if (It == Replaced.StaleRefs.end()) {
+        Unchanged.IDs.insert(ID);
+        continue;
+      }
+      // Full has each stale ref once for every time a changed file had it.
+      std::multiset<Ref> Stale;
+      for (llvm::ArrayRef<Ref> Refs : It->second)
+        Stale.insert(Refs.begin(), Refs.end());
+      RefsRequest One = Req;
+      One.IDs = {ID};
+      One.Limit.reset();
+      Full->refs(One, [&](const Ref &R) {
+        auto StaleIt = Stale.find(R);
+        if (StaleIt != Stale.end())
+          Stale.erase(StaleIt);
+        else
+          Report(R);
+      });
+    }
+    if (!Unchanged.IDs.empty() && Remaining > 0) {
+      Unchanged.Limit = Remaining;
+      More |= Full->refs(Unchanged, Report);
+    }
+    if (Remaining > 0) {
+      RefsRequest New = Req;
+      New.Limit = Remaining;
+      More |= Changes->refs(New, Report);
+    } else {
+      More = true;
+    }
+    return More;
+  }
+
+  void relations(const RelationsRequest &Req,
+                 llvm::function_ref<void(const SymbolID &, const Symbol &)>
+                     Callback) const override {
+    uint32_t Remaining =
+        Req.Limit.getValueOr(std::numeric_limits<uint32_t>::max());
+    for (const SymbolID &Subject : Req.Subjects) {
+      LookupRequest Objects;
+      auto It = Replaced.Relations.find(
+          std::make_pair(Subject, static_cast<uint8_t>(Req.Predicate)));
+      if (It != Replaced.Relations.end()) {
+        Objects.IDs.insert(It->second.begin(), It->second.end());
+      } else {
+        RelationsRequest One;
+        One.Subjects = {Subject};
+        One.Predicate = Req.Predicate;
+        Full->relations(One, [&](const SymbolID &, const Symbol &Object) {
+          Objects.IDs.insert(Object.ID);
+        });
+      }
+      lookup(Objects, [&](const Symbol &Object) {
+        if (Remaining == 0)
+          return;
+        --Remaining;
+        Callback(Subject, Object);
+      });
+    }
+  }
+
+  size_t estimateMemoryUsage() const override {
+    size_t Bytes = Changes->estimateMemoryUsage() +
+                   Full->estimateMemoryUsage() +
+                   Replaced.Symbols.getMemorySize() +
+                   Replaced.ReferenceDeltas.getMemorySize() +
+                   Replaced.StaleRefs.getMemorySize() +
+                   Replaced.Relations.getMemorySize();
+    for (const auto &Slab : Replaced.StaleRefSlabs)
+      Bytes += Slab->bytes();
+    return Bytes;
+  }
+
+private:
+  // Returns S with References counted from Base and the changed files.
+  Symbol withReferences(const Symbol &S, unsigned Base) const {
+    Symbol Result = S;
+    auto It = Replaced.ReferenceDeltas.find(S.ID);
+    int Delta = It == Replaced.ReferenceDeltas.end() ? 0 : It->second;
+    Result.References = std::max(0, static_cast<int>(Base) + Delta);
+    return Result;
+  }
+
+  std::unique_ptr<SymbolIndex> Changes;
+  std::shared_ptr<SymbolIndex> Full;
+  Overrides Replaced;
+};
+} // namespace
+
+std::unique_ptr<SymbolIndex>
+FileSymbols::buildIndexOverBase(IndexType Type,
+                                std::shared_ptr<SymbolIndex> Base) {
+  LayeredIndex::Overrides Replaced;
+  std::vector<std::shared_ptr<SymbolSlab>> SymbolSlabs;
+  std::vector<std::shared_ptr<RefSlab>> RefSlabs;
+  llvm::DenseMap<SymbolID, Symbol> Merged;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    // Symbols the full build saw, among those that need merging again.
+    llvm::DenseSet<SymbolID> InBase;
+    llvm::DenseSet<std::pair<SymbolID, uint8_t>> RelationKeys;
+    for (const auto &File : ChangedFiles) {
+      const FileSlabs &Old = File.second;
+      if (Old.Symbols)
+        for (const Symbol &Sym : *Old.Symbols) {
+          Replaced.Symbols.insert(Sym.ID);
+          InBase.insert(Sym.ID);
+        }
+      auto SymbolsIt = FileToSymbols.find(File.first());
+      if (SymbolsIt != FileToSymbols.end())
+        for (const Symbol &Sym : *SymbolsIt->second)
+          Replaced.Symbols.insert(Sym.ID);
+
+      if (Old.Refs.Slab) {
+        Replaced.StaleRefSlabs.push_back(Old.Refs.Slab);
+        for (const auto &SymRefs : *Old.Refs.Slab) {
+          Replaced.StaleRefs[SymRefs.first].push_back(SymRefs.second);
+          if (Old.Refs.CountReferences)
+            Replaced.ReferenceDeltas[SymRefs.first] -= SymRefs.second.size();
+        }
+      }
+      auto RefsIt = FileToRefs.find(File.first());
+      if (RefsIt != FileToRefs.end()) {
+        RefSlabs.push_back(RefsIt->second.Slab);
+        if (RefsIt->second.CountReferences)
+          for (const auto &SymRefs : *RefsIt->second.Slab)
+            Replaced.ReferenceDeltas[SymRefs.first] += SymRefs.second.size();
+      }
+
+      auto AddRelationKeys = [&](const RelationSlab &Relations) {
+        for (const Relation &R : Relations)
+          RelationKeys.insert(std::make_pair(
+              R.Subject, static_cast<uint8_t>(R.Predicate)));
+      };
+      if (Old.Relations)
+        AddRelationKeys(*Old.Relations);
+      auto RelationsIt = FileToRelations.find(File.first());
+      if (RelationsIt != FileToRelations.end())
+        AddRelationKeys(*RelationsIt->second);
+    }
+
+    // Merge the replaced symbols from every file, in the order buildIndex()
+    // would.
+    for (const auto &FileAndSymbols : FileToSymbols) {
+      bool Unchanged = !ChangedFiles.count(FileAndSymbols.first());
+      bool Used = false;
+      for (const SymbolID &ID : Replaced.Symbols) {
+        auto It = FileAndSymbols.second->find(ID);
+        if (It == FileAndSymbols.second->end())
+          continue;
+        Used = true;
+        if (Unchanged)
+          InBase.insert(ID);
+        auto I = Merged.try_emplace(ID, *It);
+        if (!I.second)
+          I.first->second = mergeSymbol(I.first->second, *It);
+      }
+      if (Used)
+        SymbolSlabs.push_back(FileAndSymbols.second);
+    }
+
+    // The full build didn't count references to symbols it didn't have.
+    // Count all of them, rather than adjusting its count.
+    llvm::DenseSet<SymbolID> NewSymbols;
+    for (const auto &Sym : Merged)
+      if (!InBase.count(Sym.first)) {
+        NewSymbols.insert(Sym.first);
+        Replaced.ReferenceDeltas.erase(Sym.first);
+      }
+    if (!NewSymbols.empty())
+      for (const auto &FileAndRefs : FileToRefs) {
+        if (!FileAndRefs.second.CountReferences)
+          continue;
+        for (const auto &SymRefs : *FileAndRefs.second.Slab)
+          if (NewSymbols.count(SymRefs.first))
+            Merged[SymRefs.first].References += SymRefs.second.size();
+      }
+
+    for (const auto &Key : RelationKeys) {
+      auto &Objects = Replaced.Relations[Key];
+      for (const auto &FileAndRelations : FileToRelations)
+        for (const Relation &R : FileAndRelations.second->lookup(
+                 Key.first, static_cast<RelationKind>(Key.second)))
+          Objects.push_back(R.Object);
+      llvm::sort(Objects);
+      Objects.erase(std::unique(Objects.begin(), Objects.end()),
+                    Objects.end());
+    }
+  }
+
+  std::vector<const Symbol *> AllSymbols;
+  std::vector<Symbol> SymsStorage;
+  SymsStorage.reserve(Merged.size());
+  for (auto &Sym : Merged) {
+    SymsStorage.push_back(std::move(Sym.second));
+    AllSymbols.push_back(&SymsStorage.back());
+  }
+  std::vector<Ref> RefsStorage;
+  auto AllRefs = mergeRefs(RefSlabs, RefsStorage);
+  return std::make_unique<LayeredIndex>(
+      makeIndex(Type, std::move(AllSymbols), std::move(AllRefs),
+                /*AllRelations=*/{}, std::move(SymbolSlabs),
+                std::move(RefSlabs), /*RelationSlabs=*/{},
+                std::move(RefsStorage), std::move(SymsStorage)),
+      std::move(Base), std::move(Replaced));
 }
 
 FileIndex::FileIndex(bool UseDex)
@@ -22,6 +22,7 @@
 #include "index/CanonicalIncludes.h"
 #include "index/Symbol.h"
 #include "clang/Lex/Preprocessor.h"
+#include "llvm/ADT/StringMap.h"
 #include <memory>
 
 namespace clang {
@@ -75,11 +76,28 @@ public:
   buildIndex(IndexType,
              DuplicateHandling DuplicateHandle = DuplicateHandling::PickOne);
 
+  /// Like buildIndex(IndexType, DuplicateHandling::Merge), but only indexes
+  /// the files updated since the last call to buildIndex(), which returned
+  /// \p Base. The result serves \p Base with the data of those files
+  /// replaced, so it finds the same symbols, refs and relations as a full
+  /// rebuild would. The cost is proportional to the changed files, plus a
+  /// lookup in every file for each symbol they declare.
+  std::unique_ptr<SymbolIndex>
+  buildIndexOverBase(IndexType, std::shared_ptr<SymbolIndex> Base);
+
+  /// Returns the number of files updated since the last buildIndex().
+  size_t numChangedFiles() const;
+
 private:
   struct RefSlabAndCountReferences {
     std::shared_ptr<RefSlab> Slab;
     bool CountReferences = false;
   };
+  struct FileSlabs {
+    std::shared_ptr<SymbolSlab> Symbols;
+    RefSlabAndCountReferences Refs;
+    std::shared_ptr<RelationSlab> Relations;
+  };
   mutable std::mutex Mutex;
 
   /// Stores the latest symbol snapshots for all active files.
@@ -88,6 +106,8 @@ private:
   llvm::StringMap<RefSlabAndCountReferences> FileToRefs;
   /// Stores the latest relation snapshots for all active files.
   llvm::StringMap<std::shared_ptr<RelationSlab>> FileToRelations;
+  /// Files updated since the last buildIndex(), with the slabs it used.
+  llvm::StringMap<FileSlabs> ChangedFiles;
 };
 
 /// This manages symbols from files and an in-memory index on all symbols.
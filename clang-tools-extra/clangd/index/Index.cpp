@@ -17,7 +17,7 @@
 namespace clang {
 namespace clangd {
 
-void SwapIndex::reset(std::unique_ptr<SymbolIndex> Index) {
+void SwapIndex::reset(std::shared_ptr<SymbolIndex> Index) {
   // Keep the old index alive, so we don't destroy it under lock (may be slow).
   std::shared_ptr<SymbolIndex> Pin;
   {
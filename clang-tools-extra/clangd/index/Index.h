@@ -130,7 +130,9 @@ public:
   // If an index is not provided, reset() must be called.
   SwapIndex(std::unique_ptr<SymbolIndex> Index = nullptr)
       : Index(std::move(Index)) {}
-  void reset(std::unique_ptr<SymbolIndex>);
+  // The new index may be shared with other owners, e.g. indexes layered on
+  // top of it.
+  void reset(std::shared_ptr<SymbolIndex>);
 
   // SymbolIndex methods delegate to the current index, which is kept alive
   // until the call returns (even if reset() is called).
@@ -37,8 +37,10 @@ void RefSlab::Builder::insert(const SymbolID &ID, const Ref &S) {
   if (M.count(S))
     return;
   Ref R = S;
-  R.Location.FileURI =
-      UniqueStrings.save(R.Location.FileURI).data();
+  // URIs read from a mapped shard are null-terminated in the buffer already.
+  if (!Backing || R.Location.FileURI < Backing->getBufferStart() ||
+      R.Location.FileURI >= Backing->getBufferEnd())
+    R.Location.FileURI = UniqueStrings.save(R.Location.FileURI).data();
   M.insert(std::move(R));
 }
 
@@ -53,7 +55,8 @@ RefSlab RefSlab::Builder::build() && {
     NumRefs += SymRefs.size();
     Result.emplace_back(Sym.first, llvm::ArrayRef<Ref>(SymRefs).copy(Arena));
   }
-  return RefSlab(std::move(Result), std::move(Arena), NumRefs);
+  return RefSlab(std::move(Result), std::move(Arena), NumRefs,
+                 std::move(Backing));
 }
 
 } // namespace clangd
@@ -13,9 +13,11 @@
 #include "SymbolLocation.h"
 #include "clang/Index/IndexSymbol.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/StringSaver.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cstdint>
+#include <memory>
 #include <set>
 #include <utility>
 
@@ -95,6 +97,11 @@ public:
     Builder() : UniqueStrings(Arena) {}
     /// Adds a ref to the slab. Deep copy: Strings will be owned by the slab.
     void insert(const SymbolID &ID, const Ref &S);
+    /// File URIs that point into Buffer are referenced rather than copied,
+    /// and the built slab keeps Buffer alive.
+    void setBackingStorage(std::shared_ptr<const llvm::MemoryBuffer> Buffer) {
+      Backing = std::move(Buffer);
+    }
     /// Consumes the builder to finalize the slab.
     RefSlab build() &&;
 
@@ -102,17 +109,21 @@ public:
     llvm::BumpPtrAllocator Arena;
     llvm::UniqueStringSaver UniqueStrings; // Contents on the arena.
     llvm::DenseMap<SymbolID, std::set<Ref>> Refs;
+    std::shared_ptr<const llvm::MemoryBuffer> Backing;
   };
 
 private:
   RefSlab(std::vector<value_type> Refs, llvm::BumpPtrAllocator Arena,
-          size_t NumRefs)
-      : Arena(std::move(Arena)), Refs(std::move(Refs)), NumRefs(NumRefs) {}
+          size_t NumRefs, std::shared_ptr<const llvm::MemoryBuffer> Backing)
+      : Arena(std::move(Arena)), Refs(std::move(Refs)), NumRefs(NumRefs),
+        Backing(std::move(Backing)) {}
 
   llvm::BumpPtrAllocator Arena;
   std::vector<value_type> Refs;
   /// Number of all references.
   size_t NumRefs = 0;
+  /// Owns FileURIs that live in a mapped index file, if any.
+  std::shared_ptr<const llvm::MemoryBuffer> Backing;
 };
 
 } // namespace clangd
@@ -143,6 +143,7 @@ void writeVar(uint32_t I, llvm::raw_ostream &OS) {
 // CompressedData is a zlib-compressed byte[UncompressedSize].
 // It contains a sequence of null-terminated strings, e.g. "foo\0bar\0".
 // These are sorted to improve compression.
+// Uncompressed tables can be referenced in place when the file is mapped.
 
 // Maps each string to a canonical representation.
 // Strings remain owned externally (e.g. by SymbolSlab).
@@ -161,7 +162,8 @@ public:
   // Add a string to the table. Overwrites S if an identical string exists.
   void intern(llvm::StringRef &S) { S = *Unique.insert(S).first; };
   // Finalize the table and write it to OS. No more strings may be added.
-  void finalize(llvm::raw_ostream &OS) {
+  // Tables of at least MinUncompressed bytes are written uncompressed.
+  void finalize(llvm::raw_ostream &OS, size_t MinUncompressed) {
     Sorted = {Unique.begin(), Unique.end()};
     llvm::sort(Sorted);
     for (unsigned I = 0; I < Sorted.size(); ++I)
@@ -172,7 +174,7 @@ public:
       RawTable.append(S);
       RawTable.push_back(0);
     }
-    if (llvm::zlib::isAvailable()) {
+    if (RawTable.size() < MinUncompressed && llvm::zlib::isAvailable()) {
       llvm::SmallString<1> Compressed;
       llvm::cantFail(llvm::zlib::compress(RawTable, Compressed));
       write32(RawTable.size(), OS);
@@ -193,9 +195,14 @@ public:
 struct StringTableIn {
   llvm::BumpPtrAllocator Arena;
   std::vector<llvm::StringRef> Strings;
+  // Strings point into the backing buffer rather than the arena.
+  bool InPlace = false;
 };
 
-llvm::Expected<StringTableIn> readStringTable(llvm::StringRef Data) {
+// If Backing holds Data and the table is uncompressed, strings are referenced
+// in place instead of being copied.
+llvm::Expected<StringTableIn>
+readStringTable(llvm::StringRef Data, const llvm::MemoryBuffer *Backing) {
   Reader R(Data);
   size_t UncompressedSize = R.consume32();
   if (R.err())
@@ -213,13 +220,15 @@ llvm::Expected<StringTableIn> readStringTable(llvm::StringRef Data) {
   }
 
   StringTableIn Table;
+  Table.InPlace = Backing && UncompressedSize == 0;
   llvm::StringSaver Saver(Table.Arena);
   R = Reader(Uncompressed);
   for (Reader R(Uncompressed); !R.eof();) {
     auto Len = R.rest().find(0);
     if (Len == llvm::StringRef::npos)
       return makeError("Bad string table: not null terminated");
-    Table.Strings.push_back(Saver.save(R.consume(Len)));
+    llvm::StringRef S = R.consume(Len);
+    Table.Strings.push_back(Table.InPlace ? S : Saver.save(S));
     R.consume8();
   }
   if (R.err())
@@ -421,7 +430,10 @@ readCompileCommand(Reader CmdReader, llvm::ArrayRef<llvm::StringRef> Strings) {
 // data. Later we may want to support some backward compatibility.
 constexpr static uint32_t Version = 12;
 
-llvm::Expected<IndexFileIn> readRIFF(llvm::StringRef Data) {
+// If Backing is set, Data must be its contents. Strings may then refer to it.
+llvm::Expected<IndexFileIn>
+readRIFF(llvm::StringRef Data,
+         std::shared_ptr<const llvm::MemoryBuffer> Backing = nullptr) {
   auto RIFF = riff::readFile(Data);
   if (!RIFF)
     return RIFF.takeError();
@@ -440,9 +452,11 @@ llvm::Expected<IndexFileIn> readRIFF(llvm::StringRef Data) {
   if (Meta.consume32() != Version)
     return makeError("wrong version");
 
-  auto Strings = readStringTable(Chunks.lookup("stri"));
+  auto Strings = readStringTable(Chunks.lookup("stri"), Backing.get());
   if (!Strings)
     return Strings.takeError();
+  if (!Strings->InPlace)
+    Backing = nullptr;
 
   IndexFileIn Result;
   if (Chunks.count("srcs")) {
@@ -465,6 +479,8 @@ llvm::Expected<IndexFileIn> readRIFF(llvm::StringRef Data) {
   if (Chunks.count("symb")) {
     Reader SymbolReader(Chunks.lookup("symb"));
     SymbolSlab::Builder Symbols;
+    if (Backing)
+      Symbols.setBackingStorage(Backing);
     while (!SymbolReader.eof())
       Symbols.insert(readSymbol(SymbolReader, Strings->Strings));
     if (SymbolReader.err())
@@ -474,6 +490,8 @@ llvm::Expected<IndexFileIn> readRIFF(llvm::StringRef Data) {
   if (Chunks.count("refs")) {
     Reader RefsReader(Chunks.lookup("refs"));
     RefSlab::Builder Refs;
+    if (Backing)
+      Refs.setBackingStorage(Backing);
     while (!RefsReader.eof()) {
       auto RefsBundle = readRefs(RefsReader, Strings->Strings);
       for (const auto &Ref : RefsBundle.second) // FIXME: bulk insert?
@@ -577,7 +595,7 @@ void writeRIFF(const IndexFileOut &Data, llvm::raw_ostream &OS) {
   std::string StringSection;
   {
     llvm::raw_string_ostream StringOS(StringSection);
-    Strings.finalize(StringOS);
+    Strings.finalize(StringOS, Data.MinUncompressedStrings);
   }
   RIFF.Chunks.push_back({riff::fourCC("stri"), StringSection});
 
@@ -660,6 +678,14 @@ llvm::Expected<IndexFileIn> readIndexFile(llvm::StringRef Data) {
   }
 }
 
+llvm::Expected<IndexFileIn>
+readIndexFile(std::shared_ptr<const llvm::MemoryBuffer> Buffer) {
+  llvm::StringRef Data = Buffer->getBuffer();
+  if (Data.startswith("RIFF"))
+    return readRIFF(Data, std::move(Buffer));
+  return readIndexFile(Data);
+}
+
 std::unique_ptr<SymbolIndex> loadIndex(llvm::StringRef SymbolFilename,
                                        bool UseDex) {
   trace::Span OverallTracer("LoadIndex");
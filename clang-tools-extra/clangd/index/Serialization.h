@@ -10,7 +10,7 @@
 //
 // It writes sections:
 //  - metadata such as version info
-//  - a string table (which is compressed)
+//  - a string table (which may be compressed)
 //  - lists of encoded symbols
 //
 // The format has a simple versioning scheme: the format version number is
@@ -29,6 +29,9 @@
 #include "index/Symbol.h"
 #include "clang/Tooling/CompilationDatabase.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <limits>
+#include <memory>
 
 namespace clang {
 namespace clangd {
@@ -50,6 +53,10 @@ struct IndexFileIn {
 };
 // Parse an index file. The input must be a RIFF or YAML file.
 llvm::Expected<IndexFileIn> readIndexFile(llvm::StringRef);
+// As above, but strings in an uncompressed RIFF string table are referenced
+// from Buffer rather than copied. The returned slabs keep Buffer alive.
+llvm::Expected<IndexFileIn>
+readIndexFile(std::shared_ptr<const llvm::MemoryBuffer> Buffer);
 
 // Specifies the contents of an index file to be written.
 struct IndexFileOut {
@@ -61,6 +68,10 @@ struct IndexFileOut {
   // TODO: Support serializing Dex posting lists.
   IndexFileFormat Format = IndexFileFormat::RIFF;
   const tooling::CompileCommand *Cmd = nullptr;
+  // String tables of at least this many bytes are written uncompressed, so
+  // that they can be read in place from a mapped file. Smaller tables, and by
+  // default all of them, are compressed.
+  size_t MinUncompressedStrings = std::numeric_limits<size_t>::max();
 
   IndexFileOut() = default;
   IndexFileOut(const IndexFileIn &I)
@@ -42,13 +42,23 @@ SymbolSlab::const_iterator SymbolSlab::find(const SymbolID &ID) const {
   return Symbols.end();
 }
 
+static bool isWithin(llvm::StringRef S, const llvm::MemoryBuffer *Buffer) {
+  return Buffer && S.begin() >= Buffer->getBufferStart() &&
+         S.end() <= Buffer->getBufferEnd();
+}
+
 // Copy the underlying data of the symbol into the owned arena.
-static void own(Symbol &S, llvm::UniqueStringSaver &Strings) {
-  visitStrings(S, [&](llvm::StringRef &V) { V = Strings.save(V); });
+// Strings already living in the backing buffer are left in place.
+static void own(Symbol &S, llvm::UniqueStringSaver &Strings,
+                const llvm::MemoryBuffer *Backing) {
+  visitStrings(S, [&](llvm::StringRef &V) {
+    if (!isWithin(V, Backing))
+      V = Strings.save(V);
+  });
 }
 
 void SymbolSlab::Builder::insert(const Symbol &S) {
-  own(Symbols[S.ID] = S, UniqueStrings);
+  own(Symbols[S.ID] = S, UniqueStrings, Backing.get());
 }
 
 SymbolSlab SymbolSlab::Builder::build() && {
@@ -63,8 +73,9 @@ SymbolSlab SymbolSlab::Builder::build() && {
   llvm::BumpPtrAllocator NewArena;
   llvm::UniqueStringSaver Strings(NewArena);
   for (auto &S : SortedSymbols)
-    own(S, Strings);
-  return SymbolSlab(std::move(NewArena), std::move(SortedSymbols));
+    own(S, Strings, Backing.get());
+  return SymbolSlab(std::move(NewArena), std::move(SortedSymbols),
+                    std::move(Backing));
 }
 
 } // namespace clangd
@@ -14,7 +14,9 @@
 #include "SymbolOrigin.h"
 #include "clang/Index/IndexSymbol.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/StringSaver.h"
+#include <memory>
 
 namespace clang {
 namespace clangd {
@@ -213,6 +215,12 @@ public:
       return I == Symbols.end() ? nullptr : &I->second;
     }
 
+    /// Strings that point into Buffer are referenced rather than copied, and
+    /// the built slab keeps Buffer alive. Used when reading mapped shards.
+    void setBackingStorage(std::shared_ptr<const llvm::MemoryBuffer> Buffer) {
+      Backing = std::move(Buffer);
+    }
+
     /// Consumes the builder to finalize the slab.
     SymbolSlab build() &&;
 
@@ -222,14 +230,19 @@ public:
     llvm::UniqueStringSaver UniqueStrings;
     /// Values are indices into Symbols vector.
     llvm::DenseMap<SymbolID, Symbol> Symbols;
+    std::shared_ptr<const llvm::MemoryBuffer> Backing;
   };
 
 private:
-  SymbolSlab(llvm::BumpPtrAllocator Arena, std::vector<Symbol> Symbols)
-      : Arena(std::move(Arena)), Symbols(std::move(Symbols)) {}
+  SymbolSlab(llvm::BumpPtrAllocator Arena, std::vector<Symbol> Symbols,
+             std::shared_ptr<const llvm::MemoryBuffer> Backing)
+      : Arena(std::move(Arena)), Symbols(std::move(Symbols)),
+        Backing(std::move(Backing)) {}
 
   llvm::BumpPtrAllocator Arena; // Owns Symbol data that the Symbols do not.
   std::vector<Symbol> Symbols;  // Sorted by SymbolID to allow lookup.
+  // Owns Symbol data that lives in a mapped index file, if any.
+  std::shared_ptr<const llvm::MemoryBuffer> Backing;
 };
 
 } // namespace clangd
@@ -10,6 +10,7 @@
 #include "Iterator.h"
 #include "Token.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/Endian.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/MathExtras.h"
 
@@ -99,16 +100,28 @@ private:
   }
 
   /// Advances CurrentChunk to the chunk which might contain ID.
+  ///
+  /// Intersections mostly request IDs close to the cursor, so this gallops
+  /// forward (1, 2, 4, ... chunks) to bracket ID before binary searching,
+  /// rather than searching the whole remainder of the list.
   void advanceToChunk(DocID ID) {
-    if ((CurrentChunk != Chunks.end() - 1) &&
-        ((CurrentChunk + 1)->Head <= ID)) {
-      CurrentChunk =
-          std::partition_point(CurrentChunk + 1, Chunks.end(),
-                               [&](const Chunk &C) { return C.Head < ID; });
-      --CurrentChunk;
-      DecompressedChunk = CurrentChunk->decompress();
-      CurrentID = DecompressedChunk.begin();
+    if ((CurrentChunk == Chunks.end() - 1) || ((CurrentChunk + 1)->Head > ID))
+      return;
+    // Invariant: Low->Head <= ID.
+    auto Low = CurrentChunk + 1;
+    size_t Step = 1;
+    while (Step < static_cast<size_t>(Chunks.end() - Low) &&
+           (Low + Step)->Head <= ID) {
+      Low += Step;
+      Step *= 2;
     }
+    auto High = Low + std::min(Step, static_cast<size_t>(Chunks.end() - Low));
+    CurrentChunk =
+        std::partition_point(Low + 1, High,
+                             [&](const Chunk &C) { return C.Head <= ID; });
+    --CurrentChunk;
+    DecompressedChunk = CurrentChunk->decompress();
+    CurrentID = DecompressedChunk.begin();
   }
 
   const Token *Tok;
@@ -182,6 +195,20 @@ std::vector<Chunk> encodeStream(llvm::ArrayRef<DocID> Documents) {
   return std::vector<Chunk>(Result); // no move, shrink-to-fit
 }
 
+/// Returns true if the next 8 bytes of Bytes are all complete single-byte
+/// encodings, i.e. none is zero (end of stream) or has the continuation bit.
+/// Most deltas in dense posting lists are below 128, so this lets decompress()
+/// handle a word of the payload at a time.
+bool isSingleByteRun(llvm::ArrayRef<uint8_t> Bytes) {
+  if (Bytes.size() < sizeof(uint64_t))
+    return false;
+  uint64_t Word = llvm::support::endian::read64le(Bytes.data());
+  constexpr uint64_t Low = 0x0101010101010101ULL;
+  constexpr uint64_t High = 0x8080808080808080ULL;
+  bool HasZeroByte = (Word - Low) & ~Word & High;
+  return !HasZeroByte && (Word & High) == 0;
+}
+
 /// Reads variable length DocID from the buffer and updates the buffer size. If
 /// the stream is terminated, return None.
 llvm::Optional<DocID> readVByte(llvm::ArrayRef<uint8_t> &Bytes) {
@@ -207,13 +234,20 @@ llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Chunk::decompress() const {
   llvm::ArrayRef<uint8_t> Bytes(Payload);
   DocID Delta;
   for (DocID Current = Head; !Bytes.empty(); Current += Delta) {
+    if (isSingleByteRun(Bytes)) {
+      for (unsigned I = 0; I < sizeof(uint64_t); ++I)
+        Result.push_back(Current += Bytes[I]);
+      Bytes = Bytes.drop_front(sizeof(uint64_t));
+      Delta = 0;
+      continue;
+    }
     auto MaybeDelta = readVByte(Bytes);
     if (!MaybeDelta)
       break;
     Delta = *MaybeDelta;
     Result.push_back(Current + Delta);
   }
-  return llvm::SmallVector<DocID, Chunk::PayloadSize + 1>{Result};
+  return Result;
 }
 
 PostingList::PostingList(llvm::ArrayRef<DocID> Documents)
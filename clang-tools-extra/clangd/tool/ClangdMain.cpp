@@ -322,6 +322,15 @@ opt<PCHStorageFlag> PCHStorage{
     init(PCHStorageFlag::Disk),
 };
 
+opt<unsigned> RetainedPreamblesMB{
+    "retained-preambles-mb",
+    cat(Misc),
+    desc("Keep preambles of recently closed files, up to this many megabytes "
+         "in total, so that reopening them is faster"),
+    init(128),
+    Hidden,
+};
+
 opt<bool> Sync{
     "sync",
     cat(Misc),
@@ -609,6 +618,8 @@ clangd accepts flags on the commandline, and in the CLANGD_FLAGS environment var
     Opts.StorePreamblesInMemory = false;
     break;
   }
+  Opts.RetentionPolicy.MaxRetainedPreambleBytes =
+      size_t(RetainedPreamblesMB) * 1024 * 1024;
   if (!ResourceDir.empty())
     Opts.ResourceDir = ResourceDir;
   Opts.BuildDynamicSymbolIndex = EnableIndex;
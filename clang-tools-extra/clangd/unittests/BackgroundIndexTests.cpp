@@ -644,6 +644,60 @@ TEST_F(BackgroundIndexRebuilderTest, LoadingShards) {
   EXPECT_TRUE(checkRebuild([&] { Rebuilder.doneLoading(); }));
 }
 
+TEST_F(BackgroundIndexRebuilderTest, IncrementalRebuilds) {
+  Symbol Removed;
+  Removed.ID = SymbolID("removed");
+  Removed.Name = "removed";
+  auto UpdateF = [&](bool WithRemoved) {
+    SymbolSlab::Builder SB;
+    if (WithRemoved)
+      SB.insert(Removed);
+    Source.update("f", std::make_unique<SymbolSlab>(std::move(SB).build()),
+                  nullptr, nullptr, false);
+  };
+  auto HasRemoved = [&] {
+    bool Found = false;
+    LookupRequest Req;
+    Req.IDs.insert(Removed.ID);
+    Target.lookup(Req, [&](const Symbol &) { Found = true; });
+    return Found;
+  };
+  auto Rebuild = [&] {
+    return checkRebuild([&] {
+      Rebuilder.indexedTU();
+      Rebuilder.idle();
+    });
+  };
+
+  // Loading always rebuilds everything.
+  UpdateF(/*WithRemoved=*/true);
+  Rebuilder.startLoading();
+  Rebuilder.loadedShard(1);
+  EXPECT_TRUE(checkRebuild([&] { Rebuilder.doneLoading(); }));
+  EXPECT_TRUE(HasRemoved());
+  EXPECT_EQ(0u, Source.numChangedFiles());
+
+  // A few changed files are indexed on their own and served in place of their
+  // data in the full build, which still has the symbol removed from "f".
+  UpdateF(/*WithRemoved=*/false);
+  EXPECT_TRUE(Rebuild());
+  EXPECT_FALSE(HasRemoved());
+  EXPECT_NE(0u, Source.numChangedFiles()); // Not a full rebuild.
+  UpdateF(/*WithRemoved=*/true);
+  EXPECT_TRUE(Rebuild());
+  EXPECT_TRUE(HasRemoved());
+  EXPECT_NE(0u, Source.numChangedFiles());
+
+  // Once enough files changed, everything is rebuilt.
+  UpdateF(/*WithRemoved=*/false);
+  for (unsigned I = 0; I < Rebuilder.ChangedFilesBeforeFullRebuild; ++I)
+    Source.update(std::to_string(I), std::make_unique<SymbolSlab>(), nullptr,
+                  nullptr, false);
+  EXPECT_TRUE(Rebuild());
+  EXPECT_FALSE(HasRemoved());
+  EXPECT_EQ(0u, Source.numChangedFiles());
+}
+
 TEST(BackgroundQueueTest, Priority) {
   // Create high and low priority tasks.
   // Once a bunch of high priority tasks have run, the queue is stopped.
@@ -68,6 +68,31 @@ TEST(DexIterators, DocumentIterator) {
   EXPECT_TRUE(DocIterator->reachedEnd());
 }
 
+TEST(DexIterators, DocumentIteratorManyChunks) {
+  // Mix single-byte and multi-byte deltas so chunks hold varying counts.
+  std::vector<DocID> IDs;
+  for (DocID I = 0, ID = 0; I < 5000; ++I)
+    IDs.push_back(ID += (I % 7 == 0) ? 300 : 1 + I % 5);
+  const PostingList L(IDs);
+
+  auto DocIterator = L.iterator();
+  EXPECT_EQ(consumeIDs(*DocIterator), IDs);
+
+  DocIterator = L.iterator();
+  for (size_t I = 3; I < IDs.size(); I += I / 2) {
+    DocIterator->advanceTo(IDs[I]);
+    ASSERT_FALSE(DocIterator->reachedEnd());
+    EXPECT_EQ(DocIterator->peek(), IDs[I]);
+    // An ID between two documents lands on the next one.
+    if (I + 1 < IDs.size() && IDs[I + 1] > IDs[I] + 1) {
+      DocIterator->advanceTo(IDs[I] + 1);
+      EXPECT_EQ(DocIterator->peek(), IDs[I + 1]);
+    }
+  }
+  DocIterator->advanceTo(IDs.back() + 1);
+  EXPECT_TRUE(DocIterator->reachedEnd());
+}
+
 TEST(DexIterators, AndTwoLists) {
   Corpus C{10000};
   const PostingList L0({0, 5, 7, 10, 42, 320, 9000});
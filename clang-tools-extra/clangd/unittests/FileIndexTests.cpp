@@ -144,6 +144,121 @@ TEST(FileSymbolsTest, SnapshotAliveAfterRemove) {
   EXPECT_THAT(getRefs(*Symbols, ID), RefsAre({FileURI("f1.cc")}));
 }
 
+TEST(FileSymbolsTest, ChangedFiles) {
+  FileSymbols FS;
+  FS.update("f1", numSlab(1, 3), nullptr, nullptr, false);
+  FS.update("f2", numSlab(4, 5), nullptr, nullptr, false);
+  EXPECT_EQ(FS.numChangedFiles(), 2u);
+  std::shared_ptr<SymbolIndex> Base =
+      FS.buildIndex(IndexType::Light, DuplicateHandling::Merge);
+  EXPECT_THAT(runFuzzyFind(*Base, ""),
+              UnorderedElementsAre(QName("1"), QName("2"), QName("3"),
+                                   QName("4"), QName("5")));
+  EXPECT_EQ(FS.numChangedFiles(), 0u);
+
+  FS.update("f2", numSlab(6, 6), nullptr, nullptr, false);
+  EXPECT_EQ(FS.numChangedFiles(), 1u);
+  for (auto Type : {IndexType::Light, IndexType::Heavy})
+    EXPECT_THAT(runFuzzyFind(*FS.buildIndexOverBase(Type, Base), ""),
+                UnorderedElementsAre(QName("1"), QName("2"), QName("3"),
+                                     QName("6")));
+  // Only a full build resets the changes.
+  EXPECT_EQ(FS.numChangedFiles(), 1u);
+}
+
+TEST(FileSymbolsTest, BuildIndexOverBase) {
+  auto Refs = [](std::vector<const char *> IDs, const char *Path) {
+    RefSlab::Builder Slab;
+    Ref R;
+    R.Location.FileURI = Path;
+    R.Kind = RefKind::Reference;
+    for (const char *ID : IDs)
+      Slab.insert(SymbolID(ID), R);
+    return std::make_unique<RefSlab>(std::move(Slab).build());
+  };
+  auto BaseOf = [](const char *Subject, const char *Object) {
+    RelationSlab::Builder Slab;
+    Slab.insert(
+        Relation{SymbolID(Subject), RelationKind::BaseOf, SymbolID(Object)});
+    return std::make_unique<RelationSlab>(std::move(Slab).build());
+  };
+  auto Symbols = [](const SymbolIndex &Index) {
+    std::vector<std::string> Result;
+    for (const Symbol &Sym : runFuzzyFind(Index, ""))
+      Result.push_back((Sym.Name + ":" + llvm::Twine(Sym.References)).str());
+    llvm::sort(Result);
+    return Result;
+  };
+  auto Lookup = [](const SymbolIndex &Index, const char *ID) {
+    std::vector<std::string> Result;
+    LookupRequest Req;
+    Req.IDs.insert(SymbolID(ID));
+    Index.lookup(Req, [&](const Symbol &Sym) {
+      Result.push_back((Sym.Name + ":" + llvm::Twine(Sym.References)).str());
+    });
+    return Result;
+  };
+  auto RefFiles = [](const SymbolIndex &Index, const char *ID) {
+    std::vector<std::string> Result;
+    RefsRequest Req;
+    Req.IDs.insert(SymbolID(ID));
+    Index.refs(Req, [&](const Ref &R) { Result.push_back(R.Location.FileURI); });
+    llvm::sort(Result);
+    return Result;
+  };
+  auto Derived = [](const SymbolIndex &Index, const char *ID) {
+    std::vector<std::string> Result;
+    RelationsRequest Req;
+    Req.Subjects.insert(SymbolID(ID));
+    Req.Predicate = RelationKind::BaseOf;
+    Index.relations(Req, [&](const SymbolID &, const Symbol &Object) {
+      Result.push_back(Object.Name);
+    });
+    llvm::sort(Result);
+    return Result;
+  };
+
+  for (auto Type : {IndexType::Light, IndexType::Heavy}) {
+    FileSymbols FS;
+    FS.update("f1", numSlab(1, 3), Refs({"5"}, "f1.cc"), BaseOf("1", "5"),
+              /*CountReferences=*/true);
+    FS.update("f2", numSlab(3, 5), Refs({"1"}, "f2.h"), BaseOf("3", "4"),
+              /*CountReferences=*/false);
+    std::shared_ptr<SymbolIndex> Base =
+        FS.buildIndex(Type, DuplicateHandling::Merge);
+    EXPECT_THAT(Symbols(*Base),
+                ElementsAre("1:0", "2:0", "3:0", "4:0", "5:1"));
+
+    // "3" is still declared in f1, "5" is removed, "6" is new. Only the data
+    // of f2 that Base has is replaced, however often f2 changes.
+    FS.update("f2", numSlab(4, 6), Refs({"2"}, "f2.h"), BaseOf("3", "6"),
+              /*CountReferences=*/false);
+    FS.update("f2", numSlab(4, 4), Refs({"2"}, "f2.h"), BaseOf("3", "6"),
+              /*CountReferences=*/false);
+    FS.update("f3", numSlab(6, 6), Refs({"1", "6"}, "f3.cc"), nullptr,
+              /*CountReferences=*/true);
+    auto Over = FS.buildIndexOverBase(Type, Base);
+    auto Full = FS.buildIndex(Type, DuplicateHandling::Merge);
+
+    EXPECT_THAT(Symbols(*Over),
+                ElementsAre("1:1", "2:0", "3:0", "4:0", "6:1"));
+    EXPECT_EQ(Symbols(*Full), Symbols(*Over));
+    EXPECT_THAT(Lookup(*Over, "5"), IsEmpty());
+    EXPECT_THAT(Lookup(*Over, "6"), ElementsAre("6:1"));
+    EXPECT_THAT(Lookup(*Over, "1"), ElementsAre("1:1"));
+
+    EXPECT_THAT(RefFiles(*Over, "1"), ElementsAre("f3.cc"));
+    EXPECT_THAT(RefFiles(*Over, "2"), ElementsAre("f2.h"));
+    for (const char *ID : {"1", "2", "3", "4", "5", "6"})
+      EXPECT_EQ(RefFiles(*Full, ID), RefFiles(*Over, ID)) << ID;
+
+    EXPECT_THAT(Derived(*Over, "1"), IsEmpty());
+    EXPECT_THAT(Derived(*Over, "3"), ElementsAre("6"));
+    for (const char *ID : {"1", "3"})
+      EXPECT_EQ(Derived(*Full, ID), Derived(*Over, ID)) << ID;
+  }
+}
+
 // Adds Basename.cpp, which includes Basename.h, which contains Code.
 void update(FileIndex &M, llvm::StringRef Basename, llvm::StringRef Code) {
   TestTU File;
@@ -10,6 +10,8 @@
 #include "index/Index.h"
 #include "index/Serialization.h"
 #include "clang/Tooling/CompilationDatabase.h"
+#include "llvm/Support/Compression.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/ScopedPrinter.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -201,6 +203,59 @@ TEST(SerializationTest, BinaryConversions) {
               UnorderedElementsAreArray(YAMLFromRelations(*In->Relations)));
 }
 
+TEST(SerializationTest, InPlaceStrings) {
+  auto In = readIndexFile(YAML);
+  ASSERT_TRUE(bool(In)) << In.takeError();
+
+  IndexFileOut Out(*In);
+  Out.Format = IndexFileFormat::RIFF;
+  Out.MinUncompressedStrings = 0;
+  std::shared_ptr<const llvm::MemoryBuffer> Buffer =
+      llvm::MemoryBuffer::getMemBufferCopy(llvm::to_string(Out));
+  const llvm::MemoryBuffer *Raw = Buffer.get();
+  auto Within = [&](llvm::StringRef S) {
+    return S.begin() >= Raw->getBufferStart() &&
+           S.end() <= Raw->getBufferEnd();
+  };
+
+  auto In2 = readIndexFile(std::move(Buffer));
+  ASSERT_TRUE(bool(In2)) << In2.takeError();
+  ASSERT_TRUE(In2->Symbols);
+  ASSERT_TRUE(In2->Refs);
+  // The slabs keep the buffer alive, and strings are not copied out of it.
+  for (const Symbol &Sym : *In2->Symbols) {
+    EXPECT_TRUE(Within(Sym.Name)) << Sym.Name;
+    EXPECT_TRUE(Within(Sym.CanonicalDeclaration.FileURI));
+  }
+  for (const auto &SymRefs : *In2->Refs)
+    for (const Ref &R : SymRefs.second)
+      EXPECT_TRUE(Within(R.Location.FileURI));
+
+  EXPECT_THAT(YAMLFromSymbols(*In2->Symbols),
+              UnorderedElementsAreArray(YAMLFromSymbols(*In->Symbols)));
+  EXPECT_THAT(YAMLFromRefs(*In2->Refs),
+              UnorderedElementsAreArray(YAMLFromRefs(*In->Refs)));
+}
+
+TEST(SerializationTest, CompressedStringsAreCopied) {
+  auto In = readIndexFile(YAML);
+  ASSERT_TRUE(bool(In)) << In.takeError();
+
+  IndexFileOut Out(*In);
+  Out.Format = IndexFileFormat::RIFF;
+  std::shared_ptr<const llvm::MemoryBuffer> Buffer =
+      llvm::MemoryBuffer::getMemBufferCopy(llvm::to_string(Out));
+
+  auto In2 = readIndexFile(Buffer);
+  ASSERT_TRUE(bool(In2)) << In2.takeError();
+  ASSERT_TRUE(In2->Symbols);
+  // Strings were decompressed into the slabs, which don't hold the buffer.
+  if (llvm::zlib::isAvailable())
+    EXPECT_EQ(Buffer.use_count(), 1);
+  EXPECT_THAT(YAMLFromSymbols(*In2->Symbols),
+              UnorderedElementsAreArray(YAMLFromSymbols(*In->Symbols)));
+}
+
 TEST(SerializationTest, SrcsTest) {
   auto In = readIndexFile(YAML);
   EXPECT_TRUE(bool(In)) << In.takeError();
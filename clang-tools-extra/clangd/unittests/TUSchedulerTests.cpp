@@ -556,6 +556,48 @@ TEST_F(TUSchedulerTests, EmptyPreamble) {
       });
 }
 
+TEST_F(TUSchedulerTests, RetainsPreamblesOfClosedFiles) {
+  class CountPreambles : public ParsingCallbacks {
+  public:
+    CountPreambles(std::atomic<int> &Count) : Count(Count) {}
+    void onPreambleAST(PathRef Path, ASTContext &Ctx,
+                       std::shared_ptr<clang::Preprocessor> PP,
+                       const CanonicalIncludes &) override {
+      ++Count;
+    }
+
+  private:
+    std::atomic<int> &Count;
+  };
+
+  auto Foo = testPath("foo.cpp");
+  auto Header = testPath("foo.h");
+  Files[Header] = "void foo();";
+  Timestamps[Header] = time_t(0);
+  auto Contents = R"cpp(
+    #include "foo.h"
+    int main() { foo(); }
+  )cpp";
+
+  for (bool Retain : {false, true}) {
+    std::atomic<int> PreambleBuilds(0);
+    ASTRetentionPolicy Policy;
+    Policy.MaxRetainedPreambleBytes = Retain ? 1 << 30 : 0;
+    TUScheduler S(
+        CDB, /*AsyncThreadsCount=*/4, /*StorePreambleInMemory=*/true,
+        std::make_unique<CountPreambles>(PreambleBuilds),
+        /*UpdateDebounce=*/std::chrono::steady_clock::duration::zero(), Policy);
+
+    S.update(Foo, getInputs(Foo, Contents), WantDiagnostics::Auto);
+    ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+    S.remove(Foo);
+    // Reopening the file only rebuilds the preamble if it wasn't retained.
+    S.update(Foo, getInputs(Foo, Contents), WantDiagnostics::Auto);
+    ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+    EXPECT_EQ(PreambleBuilds, Retain ? 1 : 2) << "Retain=" << Retain;
+  }
+}
+
 TEST_F(TUSchedulerTests, RunWaitsForPreamble) {
   // Testing strategy: we update the file and schedule a few preamble reads at
   // the same time. All reads should get the same non-null preamble.
@@ -0,0 +1,16 @@
+// RUN: rm -rf %t
+// RUN: mkdir -p %t
+// RUN: echo 'int *H = 0;' > %t/h.h
+// RUN: echo '#include "h.h"' > %t/a.cpp
+// RUN: echo '#include "h.h"' > %t/b.cpp
+// RUN: clang-tidy -j=2 -checks='-*,modernize-use-nullptr' -header-filter='.*' %t/a.cpp %t/b.cpp -- 2>&1 | FileCheck %s -implicit-check-not='{{warning:|error:}}'
+// RUN: clang-tidy -j=2 -checks='-*,modernize-use-nullptr' -header-filter='.*' %t/a.cpp %t/b.cpp -fix -- 2>&1 | FileCheck %s -check-prefix=CHECK-FIX-MESSAGES -implicit-check-not='{{warning:|error:}}'
+// RUN: FileCheck -input-file=%t/h.h %s -check-prefix=CHECK-FIX
+
+// A diagnostic in a header included by several files is reported and fixed
+// once, as in a sequential run.
+// CHECK: h.h:1:10: warning: use nullptr [modernize-use-nullptr]
+
+// CHECK-FIX-MESSAGES: h.h:1:10: warning: use nullptr [modernize-use-nullptr]
+// CHECK-FIX-MESSAGES: clang-tidy applied 1 of 1 suggested fixes.
+// CHECK-FIX: int *H = nullptr;
@@ -0,0 +1,20 @@
+// RUN: rm -rf %t
+// RUN: mkdir -p %t
+// RUN: echo 'int *A = 0;' > %t/a.cpp
+// RUN: echo 'int *B = 0;' > %t/b.cpp
+// RUN: echo 'int *C = 0;' > %t/c.cpp
+// RUN: clang-tidy -j=2 -checks='-*,modernize-use-nullptr' %t/a.cpp %t/b.cpp %t/c.cpp -- 2>&1 | FileCheck %s -implicit-check-not='{{warning:|error:}}'
+// RUN: clang-tidy -j=2 -checks='-*,modernize-use-nullptr' %t/a.cpp %t/b.cpp %t/c.cpp -fix -- 2>&1
+// RUN: FileCheck -input-file=%t/a.cpp %s -check-prefix=CHECK-FIX-A
+// RUN: FileCheck -input-file=%t/b.cpp %s -check-prefix=CHECK-FIX-B
+// RUN: FileCheck -input-file=%t/c.cpp %s -check-prefix=CHECK-FIX-C
+
+// Diagnostics are reported in the same order as in a sequential run,
+// independently of which thread finished first.
+// CHECK: a.cpp:1:10: warning: use nullptr [modernize-use-nullptr]
+// CHECK: b.cpp:1:10: warning: use nullptr [modernize-use-nullptr]
+// CHECK: c.cpp:1:10: warning: use nullptr [modernize-use-nullptr]
+
+// CHECK-FIX-A: int *A = nullptr;
+// CHECK-FIX-B: int *B = nullptr;
+// CHECK-FIX-C: int *C = nullptr;
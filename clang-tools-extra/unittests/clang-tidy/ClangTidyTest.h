@@ -140,6 +140,7 @@ runCheckOnCode(StringRef Code, std::vector<ClangTidyError> *Errors = nullptr,
 
   tooling::Replacements Fixes;
   std::vector<ClangTidyError> Diags = DiagConsumer.take();
+  finalizeErrors(Diags);
   for (const ClangTidyError &Error : Diags) {
     if (const auto *ChosenFix = tooling::selectFirstFix(Error))
       for (const auto &FileAndFixes : *ChosenFix) {
@@ -0,0 +1,94 @@
+//===--- LexerBenchmark.cpp - Raw lexer benchmarks --------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Basic/LangOptions.h"
+#include "clang/Basic/SourceLocation.h"
+#include "clang/Lex/Lexer.h"
+#include "benchmark/benchmark.h"
+#include <string>
+
+using namespace clang;
+
+namespace {
+
+enum class CodeKind {
+  Identifiers,
+  LineComments,
+  BlockComments,
+  Strings,
+  Indentation
+};
+
+// Returns about 1MB of code of the given kind, in which each identifier,
+// comment, string or run of indentation is Length characters long.
+std::string makeCode(CodeKind Kind, size_t Length) {
+  std::string Code;
+  for (unsigned I = 0; Code.size() < (1 << 20); ++I) {
+    std::string Identifier = "id" + std::to_string(I);
+    Identifier.resize(Length, '_');
+    std::string Text;
+    while (Text.size() < Length)
+      Text += "some words ";
+    Text.resize(Length);
+    switch (Kind) {
+    case CodeKind::Identifiers:
+      Code += Identifier + ' ';
+      break;
+    case CodeKind::LineComments:
+      Code += "//" + Text + '\n';
+      break;
+    case CodeKind::BlockComments:
+      Code += "/*" + Text + "*/\n";
+      break;
+    case CodeKind::Strings:
+      Code += '"' + Text + "\" ";
+      break;
+    case CodeKind::Indentation:
+      Code += std::string(Length, ' ') + "x\n";
+      break;
+    }
+  }
+  return Code;
+}
+
+// Lexes code in raw mode, with State.range(0) as the length of each of its
+// identifiers, comments, strings or runs of indentation.  Each kind goes
+// through a different vector scan in the lexer.
+void lexCode(benchmark::State &State, CodeKind Kind) {
+  const std::string Code = makeCode(Kind, State.range(0));
+  LangOptions LangOpts;
+  for (auto _ : State) {
+    // std::string keeps a nul terminator after the end, as the lexer needs.
+    Lexer L(SourceLocation(), LangOpts, Code.data(), Code.data(),
+            Code.data() + Code.size());
+    Token Tok;
+    do
+      L.LexFromRawLexer(Tok);
+    while (Tok.isNot(tok::eof));
+  }
+  State.SetBytesProcessed(int64_t(State.iterations()) * Code.size());
+}
+BENCHMARK_CAPTURE(lexCode, identifiers, CodeKind::Identifiers)
+    ->RangeMultiplier(4)
+    ->Range(4, 256);
+BENCHMARK_CAPTURE(lexCode, line_comments, CodeKind::LineComments)
+    ->RangeMultiplier(4)
+    ->Range(4, 256);
+BENCHMARK_CAPTURE(lexCode, block_comments, CodeKind::BlockComments)
+    ->RangeMultiplier(4)
+    ->Range(4, 256);
+BENCHMARK_CAPTURE(lexCode, strings, CodeKind::Strings)
+    ->RangeMultiplier(4)
+    ->Range(4, 256);
+BENCHMARK_CAPTURE(lexCode, indentation, CodeKind::Indentation)
+    ->RangeMultiplier(4)
+    ->Range(4, 256);
+
+} // namespace
+
+BENCHMARK_MAIN();
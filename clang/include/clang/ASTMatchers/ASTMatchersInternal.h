@@ -287,6 +287,15 @@ public:
   virtual llvm::Optional<ast_type_traits::TraversalKind> TraversalKind() const {
     return llvm::None;
   }
+
+  /// If this matcher can only match named declarations with one of a fixed
+  /// set of names, appends these names, as passed to \c hasName(), to
+  /// \p Names and returns true.
+  ///
+  /// Used by \c MatchFinder to skip matchers on declarations they can't match.
+  virtual bool getRequiredNames(std::vector<std::string> &Names) const {
+    return false;
+  }
 };
 
 /// Generic interface for matchers on an AST node of type T.
@@ -395,6 +404,13 @@ public:
   /// return \c true.
   bool canMatchNodesOfKind(ast_type_traits::ASTNodeKind Kind) const;
 
+  /// Appends the names that nodes matched by this matcher must have to
+  /// \p Names, see \c DynMatcherInterface::getRequiredNames().
+  /// \return \c false if the name of the matched node is not constrained.
+  bool getRequiredNames(std::vector<std::string> &Names) const {
+    return Implementation->getRequiredNames(Names);
+  }
+
   /// Return a matcher that points to the same implementation, but
   ///   restricts the node types for \p Kind.
   DynTypedMatcher dynCastTo(const ast_type_traits::ASTNodeKind Kind) const;
@@ -720,6 +736,8 @@ class HasNameMatcher : public SingleNodeMatcherInterface<NamedDecl> {
 
   bool matchesNode(const NamedDecl &Node) const override;
 
+  bool getRequiredNames(std::vector<std::string> &Result) const override;
+
  private:
   /// Unqualified match routine.
   ///
@@ -674,6 +674,10 @@ class SourceManager : public RefCountedBase<SourceManager> {
   /// starts at 2^31.
   static const unsigned MaxLoadedOffset = 1U << 31U;
 
+  /// Whether running out of local source locations has been reported. No
+  /// local FileIDs or expansion locations are created after that.
+  mutable bool SLocSpaceExhausted = false;
+
   /// A bitmap that indicates whether the entries of LoadedSLocEntryTable
   /// have already been loaded from the external source.
   ///
@@ -827,7 +831,9 @@ public:
   /// Create a new FileID that represents the specified file
   /// being \#included from the specified IncludePosition.
   ///
-  /// This translates NULL into standard input.
+  /// This translates NULL into standard input. Returns an invalid FileID,
+  /// after emitting a fatal error, if the source location address space is
+  /// exhausted.
   FileID createFileID(const FileEntry *SourceFile, SourceLocation IncludePos,
                       SrcMgr::CharacteristicKind FileCharacter,
                       int LoadedID = 0, unsigned LoadedOffset = 0) {
@@ -897,7 +903,8 @@ public:
 
   /// Return a new SourceLocation that encodes the fact
   /// that a token from SpellingLoc should actually be referenced from
-  /// ExpansionLoc.
+  /// ExpansionLoc. Returns an invalid SourceLocation, after emitting a fatal
+  /// error, if the source location address space is exhausted.
   SourceLocation createExpansionLoc(SourceLocation Loc,
                                     SourceLocation ExpansionLocStart,
                                     SourceLocation ExpansionLocEnd,
@@ -1672,6 +1679,11 @@ public:
   /// Print statistics to stderr.
   void PrintStats() const;
 
+  /// Emit notes breaking down which files and macro expansions use up the
+  /// source location address space, showing at most \p MaxNotes files.
+  void noteSLocAddressSpaceUsage(DiagnosticsEngine &Diag,
+                                 unsigned MaxNotes = 32) const;
+
   void dump() const;
 
   /// Get the number of local SLocEntries we have.
@@ -1707,6 +1719,10 @@ public:
 
   unsigned getNextLocalOffset() const { return NextLocalOffset; }
 
+  /// Whether the local source location address space has run out. From then
+  /// on, creating a FileID or an expansion location fails.
+  bool hasRunOutOfSLocSpace() const { return SLocSpaceExhausted; }
+
   void setExternalSLocEntrySource(ExternalSLocEntrySource *Source) {
     assert(LoadedSLocEntryTable.empty() &&
            "Invalidating existing loaded entries");
@@ -1785,6 +1801,11 @@ private:
     return getLoadedSLocEntry(static_cast<unsigned>(-ID - 2), Invalid);
   }
 
+  /// Reports that the local source location address space is exhausted,
+  /// along with a summary of its users. The error is fatal, so callers that
+  /// get an invalid FileID or SourceLocation back can stop processing.
+  void reportSLocSpaceExhausted(SourceLocation Loc) const;
+
   /// Implements the common elements of storing an expansion info struct into
   /// the SLocEntry table and producing a source location that refers to it.
   SourceLocation createExpansionLocImpl(const SrcMgr::ExpansionInfo &Expansion,
@@ -124,6 +124,16 @@ class Compilation {
   /// Whether to keep temporary files regardless of -save-temps.
   bool ForceKeepTempFiles = false;
 
+  /// The number of independent jobs which may run concurrently.
+  unsigned ParallelJobs = 1;
+
+  /// Executes the jobs with up to ParallelJobs of them at a time, replaying
+  /// their output in job order. Returns false if the jobs could not be set up
+  /// to run concurrently, before any of them has run.
+  bool ExecuteJobsInParallel(
+      const JobList &Jobs,
+      SmallVectorImpl<std::pair<int, const Command *>> &FailingCommands) const;
+
 public:
   Compilation(const Driver &D, const ToolChain &DefaultToolChain,
               llvm::opt::InputArgList *Args,
@@ -294,6 +304,10 @@ public:
   /// Return true if we're compiling for diagnostics.
   bool isForDiagnostics() const { return ForDiagnostics; }
 
+  /// Set the number of independent jobs which may run concurrently (-j).
+  void setParallelJobs(unsigned N) { ParallelJobs = N; }
+  unsigned getParallelJobs() const { return ParallelJobs; }
+
   /// Return whether an error during the parsing of the input args.
   bool containsError() const { return ContainsError; }
 
@@ -19,6 +19,7 @@
 #include "clang/Tooling/Inclusions/IncludeStyle.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/Support/Regex.h"
+#include <memory>
 #include <system_error>
 
 namespace llvm {
@@ -2336,6 +2337,44 @@ tooling::Replacements reformat(const FormatStyle &Style, StringRef Code,
                                ArrayRef<tooling::Range> Ranges,
                                StringRef FileName, bool *IncompleteFormat);
 
+class IncrementalFormatCache;
+
+/// Same as ``reformat()``, except only the part of \p Code that surrounds the
+/// \p Ranges is lexed and parsed, if the style and the code allow that.
+///
+/// The part starts and ends between two top-level declarations (possibly
+/// inside namespaces that are not indented) that are separated by an empty
+/// line, so that the result is the same as formatting the whole file. If no
+/// such part is found, the whole file is formatted.
+///
+/// If ``Cache`` is non-null, the result for the part is remembered and reused
+/// when the same part is formatted again, e.g. by an editor that formats the
+/// code on every keystroke.
+tooling::Replacements
+reformatIncrementally(const FormatStyle &Style, StringRef Code,
+                      ArrayRef<tooling::Range> Ranges,
+                      StringRef FileName = "<stdin>",
+                      FormattingAttemptStatus *Status = nullptr,
+                      IncrementalFormatCache *Cache = nullptr);
+
+/// Remembers the results of the most recent ``reformatIncrementally()`` calls.
+/// It is safe to share one cache between threads.
+class IncrementalFormatCache {
+public:
+  explicit IncrementalFormatCache(unsigned MaxEntries = 16);
+  ~IncrementalFormatCache();
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> Cached;
+
+  friend tooling::Replacements
+  reformatIncrementally(const FormatStyle &Style, StringRef Code,
+                        ArrayRef<tooling::Range> Ranges, StringRef FileName,
+                        FormattingAttemptStatus *Status,
+                        IncrementalFormatCache *Cache);
+};
+
 /// Clean up any erroneous/redundant code in the given \p Ranges in \p
 /// Code.
 ///
@@ -77,6 +77,11 @@ struct SkippedRange {
   int Length;
 };
 
+/// The version of the minimized output. Bump it whenever a change to the
+/// minimizer changes its output or the skipped ranges, so that on-disk caches
+/// of minimized sources do not return stale results.
+constexpr unsigned OutputVersion = 1;
+
 /// Computes the potential source ranges that can be skipped by the preprocessor
 /// when skipping a directive like #if, #ifdef or #elsif.
 ///
@@ -1210,6 +1210,72 @@ public:
   /// The number of SFINAE diagnostics that have been trapped.
   unsigned NumSFINAEErrors;
 
+  /// A successful substitution into an alias template, identified by the
+  /// alias template, the canonical template arguments and the context in
+  /// which the substitution was performed.
+  class AliasTemplateSubstitution : public llvm::FoldingSetNode {
+    llvm::FoldingSetNodeIDRef ID;
+
+  public:
+    QualType Type;
+
+    AliasTemplateSubstitution(llvm::FoldingSetNodeIDRef ID, QualType Type)
+        : ID(ID), Type(Type) {}
+
+    void Profile(llvm::FoldingSetNodeID &ID) const { ID = this->ID; }
+  };
+
+  /// Successful substitutions into alias templates whose pattern does not
+  /// depend on the declarations visible where the alias is named.
+  ///
+  /// Metaprogramming libraries name the same alias template specialization
+  /// many times over (often once per candidate in an overload set), and each
+  /// of those names otherwise re-substitutes into the alias pattern.
+  llvm::FoldingSet<AliasTemplateSubstitution> AliasTemplateSubstitutions;
+
+  /// Whether substituting into an alias template can give a different type
+  /// depending on where it is named, e.g. because its pattern calls a
+  /// function found by argument-dependent lookup.
+  llvm::DenseMap<const TypeAliasTemplateDecl *, bool>
+      AliasTemplateDependsOnLookup;
+
+  /// The number of alias template specializations whose type was found in
+  /// \c AliasTemplateSubstitutions rather than substituted again.
+  unsigned NumAliasTemplateSubstitutionsReused = 0;
+
+  /// The aggregated cost of instantiating the specializations of one
+  /// template pattern.
+  struct TemplateInstantiationProfile {
+    /// The number of specializations instantiated from the pattern.
+    unsigned NumInstantiations = 0;
+
+    /// The wall time spent instantiating them, in seconds, including any
+    /// instantiations they triggered in turn.
+    double Seconds = 0;
+  };
+
+  /// Per-pattern instantiation costs, collected when \c CollectStats is set
+  /// and reported by \c PrintStats().
+  llvm::MapVector<const Decl *, TemplateInstantiationProfile>
+      TemplateInstantiationProfiles;
+
+  /// RAII object that charges the time spent in its scope to the given
+  /// template pattern's instantiation profile.
+  class TemplateInstantiationProfileScope {
+    Sema &S;
+    const Decl *Pattern;
+    double StartTime;
+
+  public:
+    TemplateInstantiationProfileScope(Sema &S, const Decl *Pattern);
+    ~TemplateInstantiationProfileScope();
+
+    TemplateInstantiationProfileScope(
+        const TemplateInstantiationProfileScope &) = delete;
+    TemplateInstantiationProfileScope &
+    operator=(const TemplateInstantiationProfileScope &) = delete;
+  };
+
   typedef llvm::DenseMap<ParmVarDecl *, llvm::TinyPtrVector<ParmVarDecl *>>
     UnparsedDefaultArgInstantiationsMap;
 
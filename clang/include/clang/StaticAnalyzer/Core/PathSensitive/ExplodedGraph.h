@@ -328,9 +328,17 @@ protected:
   /// NumNodes - The number of nodes in the graph.
   int64_t NumNodes = 0;
 
+  /// The largest number of nodes that were in the graph at the same time.
+  int64_t PeakNumNodes = 0;
+
   /// A list of recently allocated nodes that can potentially be recycled.
   NodeVector ChangedNodes;
 
+  /// Nodes that were on the frontier of the graph during the last round of
+  /// reclamation. They had no successor yet, so they are given one more
+  /// chance to be recycled during the next round.
+  NodeVector DeferredNodes;
+
   /// A list of nodes that can be reused.
   NodeVector FreeNodes;
 
@@ -385,6 +393,10 @@ public:
   bool empty() const { return NumNodes == 0; }
   unsigned size() const { return NumNodes; }
 
+  /// Returns the largest number of nodes that were in the graph at the same
+  /// time, before reclamation removed some of them.
+  unsigned getPeakSize() const { return PeakNumNodes; }
+
   void reserve(unsigned NodeCount) { Nodes.reserve(NodeCount); }
 
   // Iterators.
@@ -422,6 +434,10 @@ public:
   const_eop_iterator eop_end() const { return EndNodes.end(); }
 
   llvm::BumpPtrAllocator & getAllocator() { return BVC.getAllocator(); }
+
+  /// Returns the number of bytes allocated for nodes, program states and
+  /// their bindings. The allocator never shrinks, so this is also its peak.
+  size_t getAllocatedBytes() { return getAllocator().getTotalMemory(); }
   BumpVectorContext &getNodeAllocator() { return BVC; }
 
   using NodeMap = llvm::DenseMap<const ExplodedNode *, ExplodedNode *>;
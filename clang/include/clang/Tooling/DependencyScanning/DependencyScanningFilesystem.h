@@ -11,17 +11,21 @@
 
 #include "clang/Basic/LLVM.h"
 #include "clang/Lex/PreprocessorExcludedConditionalDirectiveSkipMapping.h"
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringSet.h"
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/ErrorOr.h"
 #include "llvm/Support/VirtualFileSystem.h"
+#include <atomic>
 #include <mutex>
 
 namespace clang {
 namespace tooling {
 namespace dependencies {
 
+class DependencyScanningPersistentCache;
+
 /// An in-memory representation of a file system entity that is of interest to
 /// the dependency scanning filesystem.
 ///
@@ -46,9 +50,13 @@ public:
   /// mismatching size of the file. If file is not minimized, the full file is
   /// read and copied into memory to ensure that it's not memory mapped to avoid
   /// running out of file descriptors.
-  static CachedFileSystemEntry createFileEntry(StringRef Filename,
-                                               llvm::vfs::FileSystem &FS,
-                                               bool Minimize = true);
+  ///
+  /// If \p PersistentCache is given, the minimized contents are looked up in
+  /// it before running the minimizer, and stored into it afterwards.
+  static CachedFileSystemEntry
+  createFileEntry(StringRef Filename, llvm::vfs::FileSystem &FS,
+                  bool Minimize = true,
+                  DependencyScanningPersistentCache *PersistentCache = nullptr);
 
   /// Create an entry that represents a directory on the filesystem.
   static CachedFileSystemEntry createDirectoryEntry(llvm::vfs::Status &&Stat);
@@ -65,6 +73,8 @@ public:
       return MaybeStat.getError();
     assert(!MaybeStat->isDirectory() && "not a file");
     assert(isValid() && "not initialized");
+    if (PersistentCacheBuffer)
+      return PersistentCacheContents;
     return StringRef(Contents);
   }
 
@@ -99,11 +109,86 @@ private:
   // Note: small size of 1 allows us to store an empty string with an implicit
   // null terminator without any allocations.
   llvm::SmallString<1> Contents;
+  /// The mapped entry of the persistent cache that holds the minimized
+  /// contents, if they were found there. \c PersistentCacheContents points
+  /// into this buffer and is null terminated.
+  std::unique_ptr<llvm::MemoryBuffer> PersistentCacheBuffer;
+  StringRef PersistentCacheContents;
   PreprocessorSkippedRangeMapping PPSkippedRangeMapping;
 };
 
-/// This class is a shared cache, that caches the 'stat' and 'open' calls to the
-/// underlying real file system.
+/// An on-disk cache of minimized source files that is shared by all the
+/// dependency scanning processes that point at the same directory.
+///
+/// Entries are keyed by the original file contents and the version of the
+/// scanner, so an unchanged header is only minimized once across the whole
+/// build, no matter how many scanner processes look at it or where it is
+/// found. Entries are named by a hash of the key, and store the full key,
+/// which is compared on lookup. Each entry stores the minimized contents along
+/// with the skipped preprocessor ranges, and is read back through a memory
+/// mapped, read-only buffer.
+///
+/// New entries are written to a unique temporary file that is then renamed
+/// into place, so concurrent processes never observe a partially written
+/// entry. Any I/O failure or malformed entry is treated as a cache miss.
+///
+/// This is a thread safe class.
+class DependencyScanningPersistentCache {
+public:
+  /// A minimized file read back from the cache.
+  struct Entry {
+    /// The mapped cache entry that owns \c MinimizedContents.
+    std::unique_ptr<llvm::MemoryBuffer> Buffer;
+    /// The minimized contents; null terminated.
+    StringRef MinimizedContents;
+    PreprocessorSkippedRangeMapping PPSkippedRangeMapping;
+  };
+
+  /// \param ScannerVersion Identifies the minimizer that produced the
+  /// entries; entries of other versions are never returned.
+  explicit DependencyScanningPersistentCache(
+      StringRef CacheDirectory,
+      std::string ScannerVersion = getDefaultScannerVersion())
+      : CacheDirectory(CacheDirectory),
+        ScannerVersion(std::move(ScannerVersion)) {}
+
+  /// \returns The clang version and the minimizer output version.
+  static std::string getDefaultScannerVersion();
+
+  StringRef getCacheDirectory() const { return CacheDirectory; }
+
+  /// The number of lookups that found a valid entry.
+  unsigned getNumHits() const { return NumHits; }
+
+  /// The number of lookups that did not find a valid entry.
+  unsigned getNumMisses() const { return NumMisses; }
+
+  /// Looks up the minimized form of a file with the given original contents.
+  ///
+  /// \returns None if there is no valid entry for the contents.
+  llvm::Optional<Entry> lookup(StringRef OriginalContents) const;
+
+  /// Stores the minimized form of a file with the given original contents.
+  ///
+  /// This is a best-effort operation; failures are silently ignored.
+  void store(StringRef OriginalContents, StringRef MinimizedContents,
+             const PreprocessorSkippedRangeMapping &Mapping) const;
+
+private:
+  /// Computes the path of the entry for the given original contents.
+  void getEntryPath(StringRef OriginalContents,
+                    SmallVectorImpl<char> &Path) const;
+
+  llvm::Optional<Entry> lookupImpl(StringRef OriginalContents) const;
+
+  std::string CacheDirectory;
+  std::string ScannerVersion;
+  mutable std::atomic<unsigned> NumHits{0};
+  mutable std::atomic<unsigned> NumMisses{0};
+};
+
+/// This class is a shared cache, that caches the 'stat', 'open' and 'realpath'
+/// calls to the underlying real file system.
 ///
 /// It is sharded based on the hash of the key to reduce the lock contention for
 /// the worker threads.
@@ -114,6 +199,13 @@ public:
     CachedFileSystemEntry Value;
   };
 
+  struct SharedRealPathEntry {
+    std::mutex ValueLock;
+    /// The real path, or the error of the 'realpath' call. None until the
+    /// first worker that asks for it computes it.
+    llvm::Optional<llvm::ErrorOr<std::string>> Value;
+  };
+
   DependencyScanningFilesystemSharedCache();
 
   /// Returns a cache entry for the corresponding key.
@@ -122,10 +214,17 @@ public:
   /// thread safe call.
   SharedFileSystemEntry &get(StringRef Key);
 
+  /// Returns the real path cache entry for the corresponding absolute path.
+  ///
+  /// A new cache entry is created if the key is not in the cache. This is a
+  /// thread safe call.
+  SharedRealPathEntry &getRealPath(StringRef Key);
+
 private:
   struct CacheShard {
     std::mutex CacheLock;
     llvm::StringMap<SharedFileSystemEntry, llvm::BumpPtrAllocator> Cache;
+    llvm::StringMap<SharedRealPathEntry, llvm::BumpPtrAllocator> RealPaths;
   };
   std::unique_ptr<CacheShard[]> CacheShards;
   unsigned NumShards;
@@ -145,13 +244,16 @@ public:
   DependencyScanningWorkerFilesystem(
       DependencyScanningFilesystemSharedCache &SharedCache,
       IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS,
-      ExcludedPreprocessorDirectiveSkipMapping *PPSkipMappings)
+      ExcludedPreprocessorDirectiveSkipMapping *PPSkipMappings,
+      DependencyScanningPersistentCache *PersistentCache = nullptr)
       : ProxyFileSystem(std::move(FS)), SharedCache(SharedCache),
-        PPSkipMappings(PPSkipMappings) {}
+        PPSkipMappings(PPSkipMappings), PersistentCache(PersistentCache) {}
 
   llvm::ErrorOr<llvm::vfs::Status> status(const Twine &Path) override;
   llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>>
   openFileForRead(const Twine &Path) override;
+  std::error_code getRealPath(const Twine &Path,
+                              SmallVectorImpl<char> &Output) const override;
 
   /// The set of files that should not be minimized.
   llvm::StringSet<> IgnoredFiles;
@@ -175,10 +277,17 @@ private:
   /// The local cache is used by the worker thread to cache file system queries
   /// locally instead of querying the global cache every time.
   llvm::StringMap<const CachedFileSystemEntry *, llvm::BumpPtrAllocator> Cache;
+  /// The real paths this worker has already looked up, keyed by absolute
+  /// path. The values are owned by the shared cache.
+  mutable llvm::StringMap<const llvm::ErrorOr<std::string> *,
+                          llvm::BumpPtrAllocator>
+      RealPathCache;
   /// The optional mapping structure which records information about the
   /// excluded conditional directive skip mappings that are used by the
   /// currently active preprocessor.
   ExcludedPreprocessorDirectiveSkipMapping *PPSkipMappings;
+  /// The optional on-disk cache of minimized files shared across processes.
+  DependencyScanningPersistentCache *PersistentCache;
 };
 
 } // end namespace dependencies
@@ -48,7 +48,8 @@ class DependencyScanningService {
 public:
   DependencyScanningService(ScanningMode Mode, ScanningOutputFormat Format,
                             bool ReuseFileManager = true,
-                            bool SkipExcludedPPRanges = true);
+                            bool SkipExcludedPPRanges = true,
+                            StringRef PersistentCacheDirectory = StringRef());
 
   ScanningMode getMode() const { return Mode; }
 
@@ -62,6 +63,12 @@ public:
     return SharedCache;
   }
 
+  /// \returns The on-disk cache of minimized files, or null if the scanner
+  /// should not use one.
+  DependencyScanningPersistentCache *getPersistentCache() {
+    return PersistentCache.get();
+  }
+
 private:
   const ScanningMode Mode;
   const ScanningOutputFormat Format;
@@ -72,6 +79,9 @@ private:
   const bool SkipExcludedPPRanges;
   /// The global file system cache.
   DependencyScanningFilesystemSharedCache SharedCache;
+  /// The optional on-disk cache of minimized files that is shared with other
+  /// scanner processes.
+  std::unique_ptr<DependencyScanningPersistentCache> PersistentCache;
 };
 
 } // end namespace dependencies
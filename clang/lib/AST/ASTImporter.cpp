@@ -8725,7 +8725,9 @@ Expected<FileID> ASTImporter::Import(FileID FromID, bool IsBuiltin) {
     }
   }
 
-  assert(ToID.isValid() && "Unexpected invalid fileID was created.");
+  // The "to" source manager may have run out of source locations.
+  if (ToID.isInvalid())
+    return llvm::make_error<ImportError>(ImportError::Unknown);
 
   ImportedFileIDs[FromID] = ToID;
 
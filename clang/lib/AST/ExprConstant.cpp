@@ -13663,10 +13663,15 @@ static bool EvaluateInPlace(APValue &Result, EvalInfo &Info, const LValue &This,
 /// EvaluateAsRValue - Try to evaluate this expression, performing an implicit
 /// lvalue-to-rvalue cast if it is an lvalue.
 static bool EvaluateAsRValue(EvalInfo &Info, const Expr *E, APValue &Result) {
+  interp::InterpResult IR = interp::InterpResult::Bail;
   if (Info.EnableNewConstInterp) {
-    if (!Info.Ctx.getInterpContext().evaluateAsRValue(Info, E, Result))
+    IR = Info.Ctx.getInterpContext().evaluateAsRValue(Info, E, Result);
+    if (IR == interp::InterpResult::Fail)
       return false;
-  } else {
+  }
+
+  // Constructs the VM cannot compile are evaluated by walking the AST.
+  if (IR == interp::InterpResult::Bail) {
     if (E->getType().isNull())
       return false;
 
@@ -13891,11 +13896,15 @@ bool Expr::EvaluateAsInitializer(APValue &Value, const ASTContext &Ctx,
   SourceLocation DeclLoc = VD->getLocation();
   QualType DeclTy = VD->getType();
 
+  interp::InterpResult IR = interp::InterpResult::Bail;
   if (Info.EnableNewConstInterp) {
     auto &InterpCtx = const_cast<ASTContext &>(Ctx).getInterpContext();
-    if (!InterpCtx.evaluateAsInitializer(Info, VD, Value))
+    IR = InterpCtx.evaluateAsInitializer(Info, VD, Value);
+    if (IR == interp::InterpResult::Fail)
       return false;
-  } else {
+  }
+
+  if (IR == interp::InterpResult::Bail) {
     LValue LVal;
     LVal.set(VD);
 
@@ -14661,10 +14670,11 @@ bool Expr::isPotentialConstantExpr(const FunctionDecl *FD,
   Info.CheckingPotentialConstantExpression = true;
 
   // The constexpr VM attempts to compile all methods to bytecode here.
-  if (Info.EnableNewConstInterp) {
-    Info.Ctx.getInterpContext().isPotentialConstantExpr(Info, FD);
+  // Functions it cannot compile are checked by the AST walker instead.
+  if (Info.EnableNewConstInterp &&
+      Info.Ctx.getInterpContext().isPotentialConstantExpr(Info, FD) !=
+          interp::InterpResult::Bail)
     return Diags.empty();
-  }
 
   const CXXMethodDecl *MD = dyn_cast<CXXMethodDecl>(FD);
   const CXXRecordDecl *RD = MD ? MD->getParent()->getCanonicalDecl() : nullptr;
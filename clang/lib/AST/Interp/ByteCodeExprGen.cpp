@@ -115,6 +115,19 @@ bool ByteCodeExprGen<Emitter>::VisitCastExpr(const CastExpr *CE) {
   case CK_UserDefinedConversion:
     return this->Visit(SubExpr);
 
+  case CK_IntegralCast:
+  case CK_IntegralToBoolean: {
+    if (DiscardResult)
+      return discard(SubExpr);
+    Optional<PrimType> FromT = classify(SubExpr->getType());
+    Optional<PrimType> ToT = classify(CE->getType());
+    if (!FromT || !ToT || *FromT == PT_Ptr || *ToT == PT_Ptr)
+      return this->bail(CE);
+    if (!visit(SubExpr))
+      return false;
+    return *FromT == *ToT ? true : this->emitCast(*FromT, *ToT, CE);
+  }
+
   case CK_ToVoid:
     return discard(SubExpr);
 
@@ -137,6 +150,14 @@ bool ByteCodeExprGen<Emitter>::VisitIntegerLiteral(const IntegerLiteral *LE) {
   return this->bail(LE);
 }
 
+template <class Emitter>
+bool ByteCodeExprGen<Emitter>::VisitCXXBoolLiteralExpr(
+    const CXXBoolLiteralExpr *BE) {
+  if (DiscardResult)
+    return true;
+  return this->emitConstBool(BE->getValue(), BE);
+}
+
 template <class Emitter>
 bool ByteCodeExprGen<Emitter>::VisitParenExpr(const ParenExpr *PE) {
   return this->Visit(PE->getSubExpr());
@@ -155,6 +176,16 @@ bool ByteCodeExprGen<Emitter>::VisitBinaryOperator(const BinaryOperator *BO) {
     if (!this->Visit(RHS))
       return false;
     return true;
+  case BO_Assign:
+  case BO_AddAssign:
+  case BO_SubAssign:
+  case BO_MulAssign:
+  case BO_DivAssign:
+  case BO_RemAssign:
+    return visitAssignment(BO);
+  case BO_LAnd:
+  case BO_LOr:
+    return visitLogicalOperator(BO);
   default:
     break;
   }
@@ -197,6 +228,10 @@ bool ByteCodeExprGen<Emitter>::VisitBinaryOperator(const BinaryOperator *BO) {
       return Discard(this->emitAdd(*T, BO));
     case BO_Mul:
       return Discard(this->emitMul(*T, BO));
+    case BO_Div:
+      return Discard(this->emitDiv(*T, BO));
+    case BO_Rem:
+      return Discard(this->emitRem(*T, BO));
     default:
       return this->bail(BO);
     }
@@ -205,6 +240,215 @@ bool ByteCodeExprGen<Emitter>::VisitBinaryOperator(const BinaryOperator *BO) {
   return this->bail(BO);
 }
 
+template <class Emitter>
+bool ByteCodeExprGen<Emitter>::VisitUnaryOperator(const UnaryOperator *UO) {
+  const Expr *SubExpr = UO->getSubExpr();
+  switch (UO->getOpcode()) {
+  case UO_PreInc:
+  case UO_PreDec:
+  case UO_PostInc:
+  case UO_PostDec:
+    return visitIncDec(UO);
+  case UO_Plus:
+    return this->Visit(SubExpr);
+  default:
+    break;
+  }
+
+  Optional<PrimType> T = classify(UO->getType());
+  if (!T || *T == PT_Ptr || classify(SubExpr->getType()) != T)
+    return this->bail(UO);
+
+  switch (UO->getOpcode()) {
+  case UO_Minus:
+    // Negation is a subtraction from zero, which diagnoses overflow.
+    if (!visitZeroInitializer(*T, UO))
+      return false;
+    if (!visit(SubExpr))
+      return false;
+    if (!this->emitSub(*T, UO))
+      return false;
+    return DiscardResult ? this->emitPop(*T, UO) : true;
+  case UO_LNot:
+    if (*T != PT_Bool)
+      return this->bail(UO);
+    if (!visit(SubExpr))
+      return false;
+    if (!this->emitConstBool(false, UO))
+      return false;
+    if (!this->emitEQ(PT_Bool, UO))
+      return false;
+    return DiscardResult ? this->emitPop(PT_Bool, UO) : true;
+  default:
+    return this->bail(UO);
+  }
+}
+
+template <class Emitter>
+bool ByteCodeExprGen<Emitter>::VisitCallExpr(const CallExpr *CE) {
+  // Only direct calls to free functions on primitive values are lowered.
+  const FunctionDecl *FD = CE->getDirectCallee();
+  if (!FD || isa<CXXMethodDecl>(FD) || FD->getBuiltinID() || FD->isVariadic())
+    return this->bail(CE);
+
+  QualType RetTy = FD->getReturnType();
+  Optional<PrimType> T = classify(RetTy);
+  if (RetTy->isVoidType() ? !DiscardResult : (!T || *T == PT_Ptr))
+    return this->bail(CE);
+  for (const ParmVarDecl *PD : FD->parameters()) {
+    Optional<PrimType> ParamT = classify(PD->getType());
+    if (!ParamT || *ParamT == PT_Ptr)
+      return this->bail(CE);
+  }
+
+  Expected<Function *> Func = P.getOrCreateFunction(FD);
+  if (!Func) {
+    llvm::consumeError(Func.takeError());
+    return this->bail(CE);
+  }
+
+  // A function which failed to compile is left to the AST walker, with the
+  // exception of the one being compiled: it only runs if compilation succeeds.
+  if (!*Func ||
+      (!(*Func)->isConstexpr() && (*Func)->getDecl() != CurrentFunction))
+    return this->bail(CE);
+
+  for (const Expr *Arg : CE->arguments())
+    if (!visit(Arg))
+      return false;
+  if (!this->emitCall(*Func, CE))
+    return false;
+  return DiscardResult && T ? this->emitPop(*T, CE) : true;
+}
+
+template <class Emitter>
+bool ByteCodeExprGen<Emitter>::VisitExpr(const Expr *E) {
+  // Constructs without a lowering are left to the AST walker.
+  return this->bail(E);
+}
+
+template <class Emitter>
+bool ByteCodeExprGen<Emitter>::visitAssignment(const BinaryOperator *BO) {
+  const Expr *LHS = BO->getLHS();
+  const Expr *RHS = BO->getRHS();
+
+  Optional<PrimType> T = classify(LHS->getType());
+  if (!T || LHS->refersToBitField() || classify(RHS->getType()) != T)
+    return this->bail(BO);
+
+  if (BO->getOpcode() == BO_Assign) {
+    return dereference(
+        LHS, DerefKind::Write, [this, RHS](PrimType) { return visit(RHS); },
+        [this, RHS, BO](PrimType T) {
+          if (!visit(RHS))
+            return false;
+          return DiscardResult ? this->emitStorePop(T, BO)
+                               : this->emitStore(T, BO);
+        });
+  }
+
+  // Compound assignments are only compiled if they involve no conversions.
+  auto *CAO = cast<CompoundAssignOperator>(BO);
+  if (*T == PT_Ptr || *T == PT_Bool ||
+      classify(CAO->getComputationLHSType()) != T ||
+      classify(CAO->getComputationResultType()) != T)
+    return this->bail(BO);
+
+  auto Compute = [this, CAO](PrimType T) {
+    switch (CAO->getOpcode()) {
+    case BO_AddAssign:
+      return this->emitAdd(T, CAO);
+    case BO_SubAssign:
+      return this->emitSub(T, CAO);
+    case BO_MulAssign:
+      return this->emitMul(T, CAO);
+    case BO_DivAssign:
+      return this->emitDiv(T, CAO);
+    case BO_RemAssign:
+      return this->emitRem(T, CAO);
+    default:
+      return this->bail(CAO);
+    }
+  };
+
+  return dereference(
+      LHS, DerefKind::ReadWrite,
+      [this, RHS, &Compute](PrimType T) { return visit(RHS) && Compute(T); },
+      [this, RHS, BO, &Compute](PrimType T) {
+        if (!this->emitLoad(T, BO))
+          return false;
+        if (!visit(RHS) || !Compute(T))
+          return false;
+        return DiscardResult ? this->emitStorePop(T, BO)
+                             : this->emitStore(T, BO);
+      });
+}
+
+template <class Emitter>
+bool ByteCodeExprGen<Emitter>::visitLogicalOperator(const BinaryOperator *BO) {
+  if (classify(BO->getLHS()->getType()) != PT_Bool ||
+      classify(BO->getRHS()->getType()) != PT_Bool)
+    return this->bail(BO);
+
+  // The value of the LHS is the result if it decides the outcome.
+  LabelTy EndLabel = this->getLabel();
+  if (!visitBool(BO->getLHS()))
+    return false;
+  if (!this->emitDup(PT_Bool, BO))
+    return false;
+  if (BO->getOpcode() == BO_LAnd) {
+    if (!this->jumpFalse(EndLabel))
+      return false;
+  } else {
+    if (!this->jumpTrue(EndLabel))
+      return false;
+  }
+  if (!this->emitPop(PT_Bool, BO))
+    return false;
+  if (!visitBool(BO->getRHS()))
+    return false;
+  if (!this->fallthrough(EndLabel))
+    return false;
+
+  return DiscardResult ? this->emitPop(PT_Bool, BO) : true;
+}
+
+template <class Emitter>
+bool ByteCodeExprGen<Emitter>::visitIncDec(const UnaryOperator *UO) {
+  const Expr *SubExpr = UO->getSubExpr();
+  Optional<PrimType> T = classify(SubExpr->getType());
+  if (!T || *T == PT_Ptr || *T == PT_Bool || SubExpr->refersToBitField())
+    return this->bail(UO);
+
+  // A postfix operation whose value is used yields the old value: read it
+  // first, then update the operand as if the result was discarded. This is
+  // only done for plain variable references, which can be evaluated twice.
+  if (UO->isPostfix() && !DiscardResult) {
+    if (!isa<DeclRefExpr>(SubExpr))
+      return this->bail(UO);
+    auto Read = dereference(
+        SubExpr, DerefKind::Read, [](PrimType) { return true; },
+        [this, UO](PrimType T) { return this->emitLoadPop(T, UO); });
+    return Read && discard(UO);
+  }
+
+  auto Step = [this, UO](PrimType T) {
+    if (!this->emitConst(UO, 1))
+      return false;
+    return UO->isIncrementOp() ? this->emitAdd(T, UO) : this->emitSub(T, UO);
+  };
+
+  return dereference(
+      SubExpr, DerefKind::ReadWrite, Step, [this, UO, &Step](PrimType T) {
+        if (!this->emitLoad(T, UO))
+          return false;
+        if (!Step(T))
+          return false;
+        return DiscardResult ? this->emitStorePop(T, UO)
+                             : this->emitStore(T, UO);
+      });
+}
+
 template <class Emitter>
 bool ByteCodeExprGen<Emitter>::discard(const Expr *E) {
   OptionScope<Emitter> Scope(this, /*discardResult=*/true);
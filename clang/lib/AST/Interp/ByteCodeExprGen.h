@@ -68,8 +68,12 @@ public:
   // Expression visitors - result returned on stack.
   bool VisitCastExpr(const CastExpr *E);
   bool VisitIntegerLiteral(const IntegerLiteral *E);
+  bool VisitCXXBoolLiteralExpr(const CXXBoolLiteralExpr *E);
   bool VisitParenExpr(const ParenExpr *E);
   bool VisitBinaryOperator(const BinaryOperator *E);
+  bool VisitUnaryOperator(const UnaryOperator *E);
+  bool VisitCallExpr(const CallExpr *E);
+  bool VisitExpr(const Expr *E);
 
 protected:
   bool visitExpr(const Expr *E) override;
@@ -166,6 +170,13 @@ private:
   /// Emits a zero initializer.
   bool visitZeroInitializer(PrimType T, const Expr *E);
 
+  /// Compiles simple and compound assignments.
+  bool visitAssignment(const BinaryOperator *BO);
+  /// Compiles a short-circuiting logical operator.
+  bool visitLogicalOperator(const BinaryOperator *BO);
+  /// Compiles an increment or a decrement.
+  bool visitIncDec(const UnaryOperator *UO);
+
   enum class DerefKind {
     /// Value is read and pushed to stack.
     Read,
@@ -229,6 +240,9 @@ protected:
   /// Flag indicating if return value is to be discarded.
   bool DiscardResult = false;
 
+  /// Function whose body is being compiled, if any.
+  const FunctionDecl *CurrentFunction = nullptr;
+
   /// Expression being initialized.
   llvm::Optional<InitFnRef> InitFn = {};
 };
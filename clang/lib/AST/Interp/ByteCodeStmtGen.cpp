@@ -42,19 +42,27 @@ public:
   LoopScope(ByteCodeStmtGen<Emitter> *Ctx, LabelTy BreakLabel,
             LabelTy ContinueLabel)
       : LabelScope<Emitter>(Ctx), OldBreakLabel(Ctx->BreakLabel),
-        OldContinueLabel(Ctx->ContinueLabel) {
+        OldContinueLabel(Ctx->ContinueLabel),
+        OldBreakVarScope(Ctx->BreakVarScope),
+        OldContinueVarScope(Ctx->ContinueVarScope) {
     this->Ctx->BreakLabel = BreakLabel;
     this->Ctx->ContinueLabel = ContinueLabel;
+    this->Ctx->BreakVarScope = Ctx->VarScope;
+    this->Ctx->ContinueVarScope = Ctx->VarScope;
   }
 
   ~LoopScope() {
     this->Ctx->BreakLabel = OldBreakLabel;
     this->Ctx->ContinueLabel = OldContinueLabel;
+    this->Ctx->BreakVarScope = OldBreakVarScope;
+    this->Ctx->ContinueVarScope = OldContinueVarScope;
   }
 
 private:
   OptLabelTy OldBreakLabel;
   OptLabelTy OldContinueLabel;
+  VariableScope<Emitter> *OldBreakVarScope;
+  VariableScope<Emitter> *OldContinueVarScope;
 };
 
 // Sets the context for a switch scope, mapping labels.
@@ -93,6 +101,7 @@ template <class Emitter>
 bool ByteCodeStmtGen<Emitter>::visitFunc(const FunctionDecl *F) {
   // Classify the return type.
   ReturnType = this->classify(F->getReturnType());
+  this->CurrentFunction = F;
 
   // Set up fields and context if a constructor.
   if (auto *MD = dyn_cast<CXXMethodDecl>(F))
@@ -120,6 +129,16 @@ bool ByteCodeStmtGen<Emitter>::visitStmt(const Stmt *S) {
     return visitReturnStmt(cast<ReturnStmt>(S));
   case Stmt::IfStmtClass:
     return visitIfStmt(cast<IfStmt>(S));
+  case Stmt::WhileStmtClass:
+    return visitWhileStmt(cast<WhileStmt>(S));
+  case Stmt::DoStmtClass:
+    return visitDoStmt(cast<DoStmt>(S));
+  case Stmt::ForStmtClass:
+    return visitForStmt(cast<ForStmt>(S));
+  case Stmt::BreakStmtClass:
+    return visitBreakStmt(cast<BreakStmt>(S));
+  case Stmt::ContinueStmtClass:
+    return visitContinueStmt(cast<ContinueStmt>(S));
   case Stmt::NullStmtClass:
     return true;
   default: {
@@ -224,6 +243,119 @@ bool ByteCodeStmtGen<Emitter>::visitIfStmt(const IfStmt *IS) {
   return true;
 }
 
+template <class Emitter>
+bool ByteCodeStmtGen<Emitter>::visitWhileStmt(const WhileStmt *S) {
+  LabelTy CondLabel = this->getLabel();
+  LabelTy EndLabel = this->getLabel();
+  LoopScope<Emitter> LS(this, EndLabel, CondLabel);
+
+  this->emitLabel(CondLabel);
+  {
+    BlockScope<Emitter> CondScope(this);
+    if (const DeclStmt *CondDecl = S->getConditionVariableDeclStmt())
+      if (!visitDeclStmt(CondDecl))
+        return false;
+    if (!this->visitBool(S->getCond()))
+      return false;
+    if (!this->jumpFalse(EndLabel))
+      return false;
+    if (!visitStmt(S->getBody()))
+      return false;
+  }
+  if (!this->emitLoopStep(S))
+    return false;
+  if (!this->jump(CondLabel))
+    return false;
+  this->emitLabel(EndLabel);
+  return true;
+}
+
+template <class Emitter>
+bool ByteCodeStmtGen<Emitter>::visitDoStmt(const DoStmt *S) {
+  LabelTy StartLabel = this->getLabel();
+  LabelTy CondLabel = this->getLabel();
+  LabelTy EndLabel = this->getLabel();
+  LoopScope<Emitter> LS(this, EndLabel, CondLabel);
+
+  this->emitLabel(StartLabel);
+  if (!visitStmt(S->getBody()))
+    return false;
+  this->emitLabel(CondLabel);
+  if (!this->visitBool(S->getCond()))
+    return false;
+  if (!this->jumpFalse(EndLabel))
+    return false;
+  if (!this->emitLoopStep(S))
+    return false;
+  if (!this->jump(StartLabel))
+    return false;
+  this->emitLabel(EndLabel);
+  return true;
+}
+
+template <class Emitter>
+bool ByteCodeStmtGen<Emitter>::visitForStmt(const ForStmt *S) {
+  // The scope of the loop variables extends over the whole statement.
+  BlockScope<Emitter> ForScope(this);
+  if (const Stmt *Init = S->getInit())
+    if (!visitStmt(Init))
+      return false;
+
+  LabelTy CondLabel = this->getLabel();
+  LabelTy IncLabel = this->getLabel();
+  LabelTy EndLabel = this->getLabel();
+  LoopScope<Emitter> LS(this, EndLabel, IncLabel);
+
+  this->emitLabel(CondLabel);
+  {
+    BlockScope<Emitter> CondScope(this);
+    if (const DeclStmt *CondDecl = S->getConditionVariableDeclStmt())
+      if (!visitDeclStmt(CondDecl))
+        return false;
+    if (const Expr *Cond = S->getCond()) {
+      if (!this->visitBool(Cond))
+        return false;
+      if (!this->jumpFalse(EndLabel))
+        return false;
+    }
+    if (!visitStmt(S->getBody()))
+      return false;
+  }
+  this->emitLabel(IncLabel);
+  if (const Expr *Inc = S->getInc())
+    if (!this->discard(Inc))
+      return false;
+  if (!this->emitLoopStep(S))
+    return false;
+  if (!this->jump(CondLabel))
+    return false;
+  this->emitLabel(EndLabel);
+  return true;
+}
+
+template <class Emitter>
+bool ByteCodeStmtGen<Emitter>::visitBreakStmt(const BreakStmt *S) {
+  if (!BreakLabel)
+    return this->bail(S);
+  emitScopeExit(BreakVarScope);
+  return this->jump(*BreakLabel);
+}
+
+template <class Emitter>
+bool ByteCodeStmtGen<Emitter>::visitContinueStmt(const ContinueStmt *S) {
+  if (!ContinueLabel)
+    return this->bail(S);
+  emitScopeExit(ContinueVarScope);
+  return this->jump(*ContinueLabel);
+}
+
+template <class Emitter>
+void ByteCodeStmtGen<Emitter>::emitScopeExit(VariableScope<Emitter> *Target) {
+  for (VariableScope<Emitter> *C = this->VarScope; C != Target;
+       C = C->getParent())
+    C->emitDestruction();
+}
+
 template <class Emitter>
 bool ByteCodeStmtGen<Emitter>::visitVarDecl(const VarDecl *VD) {
   auto DT = VD->getType();
@@ -233,8 +365,15 @@ bool ByteCodeStmtGen<Emitter>::visitVarDecl(const VarDecl *VD) {
     return true;
   }
 
+  // Frames construct their locals once, so storage which is torn down at the
+  // end of a loop iteration cannot be set up again by the next one. Only
+  // locals without destructors can be declared inside loops.
+  Optional<PrimType> T = this->classify(DT);
+  if (ContinueLabel && (!T || *T == PT_Ptr))
+    return this->bail(VD);
+
   // Integers, pointers, primitives.
-  if (Optional<PrimType> T = this->classify(DT)) {
+  if (T) {
     auto Off = this->allocateLocalPrimitive(VD, *T, DT.isConstQualified());
     // Compile the initialiser in its own scope.
     {
@@ -62,6 +62,14 @@ private:
   bool visitDeclStmt(const DeclStmt *DS);
   bool visitReturnStmt(const ReturnStmt *RS);
   bool visitIfStmt(const IfStmt *IS);
+  bool visitWhileStmt(const WhileStmt *S);
+  bool visitDoStmt(const DoStmt *S);
+  bool visitForStmt(const ForStmt *S);
+  bool visitBreakStmt(const BreakStmt *S);
+  bool visitContinueStmt(const ContinueStmt *S);
+
+  /// Emits the destruction of all scopes nested in the target of a jump.
+  void emitScopeExit(VariableScope<Emitter> *Target);
 
   /// Compiles a variable declaration.
   bool visitVarDecl(const VarDecl *VD);
@@ -77,6 +85,10 @@ private:
   OptLabelTy BreakLabel;
   /// Point to continue to.
   OptLabelTy ContinueLabel;
+  /// Scope enclosing the break target.
+  VariableScope<Emitter> *BreakVarScope = nullptr;
+  /// Scope enclosing the continue target.
+  VariableScope<Emitter> *ContinueVarScope = nullptr;
   /// Default case label.
   OptLabelTy DefaultLabel;
 };
@@ -9,6 +9,7 @@
 #include "Context.h"
 #include "ByteCodeEmitter.h"
 #include "ByteCodeExprGen.h"
+#include "ByteCodeGenError.h"
 #include "ByteCodeStmtGen.h"
 #include "EvalEmitter.h"
 #include "Interp.h"
@@ -16,6 +17,7 @@
 #include "InterpStack.h"
 #include "PrimType.h"
 #include "Program.h"
+#include "clang/AST/ASTDiagnostic.h"
 #include "clang/AST/Expr.h"
 
 using namespace clang;
@@ -25,35 +27,39 @@ Context::Context(ASTContext &Ctx) : Ctx(Ctx), P(new Program(*this)) {}
 
 Context::~Context() {}
 
-bool Context::isPotentialConstantExpr(State &Parent, const FunctionDecl *FD) {
+InterpResult Context::isPotentialConstantExpr(State &Parent,
+                                              const FunctionDecl *FD) {
   Function *Func = P->getFunction(FD);
   if (!Func) {
-    if (auto R = ByteCodeStmtGen<ByteCodeEmitter>(*this, *P).compileFunc(FD)) {
-      Func = *R;
-    } else {
-      handleAllErrors(R.takeError(), [&Parent](ByteCodeGenError &Err) {
-        Parent.FFDiag(Err.getLoc(), diag::err_experimental_clang_interp_failed);
-      });
-      return false;
-    }
+    auto R = ByteCodeStmtGen<ByteCodeEmitter>(*this, *P).compileFunc(FD);
+    if (!R)
+      return BailOut(Parent, R.takeError());
+    Func = *R;
   }
 
-  if (!Func->isConstexpr())
-    return false;
+  // Functions which failed to compile before are left to the AST walker.
+  if (!Func || !Func->isConstexpr())
+    return BailOut(Parent, llvm::make_error<ByteCodeGenError>(FD));
 
   APValue Dummy;
-  return Run(Parent, Func, Dummy);
+  return Run(Parent, Func, Dummy) ? InterpResult::Success : InterpResult::Fail;
 }
 
-bool Context::evaluateAsRValue(State &Parent, const Expr *E, APValue &Result) {
+InterpResult Context::evaluateAsRValue(State &Parent, const Expr *E,
+                                       APValue &Result) {
   ByteCodeExprGen<EvalEmitter> C(*this, *P, Parent, Stk, Result);
   return Check(Parent, C.interpretExpr(E));
 }
 
-bool Context::evaluateAsInitializer(State &Parent, const VarDecl *VD,
-                                    APValue &Result) {
+InterpResult Context::evaluateAsInitializer(State &Parent, const VarDecl *VD,
+                                            APValue &Result) {
   ByteCodeExprGen<EvalEmitter> C(*this, *P, Parent, Stk, Result);
-  return Check(Parent, C.interpretDecl(VD));
+  llvm::Expected<bool> Flag = C.interpretDecl(VD);
+  // The global was created before the initializer bailed out and will never
+  // hold a value. Forget it so that uses of the variable bail out as well.
+  if (!Flag)
+    P->forgetGlobal(VD);
+  return Check(Parent, std::move(Flag));
 }
 
 const LangOptions &Context::getLangOpts() const { return Ctx.getLangOpts(); }
@@ -118,11 +124,22 @@ bool Context::Run(State &Parent, Function *Func, APValue &Result) {
   return false;
 }
 
-bool Context::Check(State &Parent, llvm::Expected<bool> &&Flag) {
+InterpResult Context::Check(State &Parent, llvm::Expected<bool> &&Flag) {
   if (Flag)
-    return *Flag;
-  handleAllErrors(Flag.takeError(), [&Parent](ByteCodeGenError &Err) {
-    Parent.FFDiag(Err.getLoc(), diag::err_experimental_clang_interp_failed);
+    return *Flag ? InterpResult::Success : InterpResult::Fail;
+  // Values left behind by the partially evaluated expression are dropped.
+  Stk.clear();
+  return BailOut(Parent, Flag.takeError());
+}
+
+InterpResult Context::BailOut(State &Parent, llvm::Error &&Err) {
+  if (!getLangOpts().ForceNewConstInterp) {
+    llvm::consumeError(std::move(Err));
+    return InterpResult::Bail;
+  }
+  // Without the AST walker to fall back to, unsupported constructs are errors.
+  llvm::handleAllErrors(std::move(Err), [&Parent](const ByteCodeGenError &E) {
+    Parent.FFDiag(E.getLoc(), diag::err_experimental_clang_interp_failed);
   });
-  return false;
+  return InterpResult::Fail;
 }
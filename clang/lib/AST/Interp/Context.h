@@ -20,6 +20,7 @@
 #include "InterpStack.h"
 #include "clang/AST/APValue.h"
 #include "llvm/ADT/PointerIntPair.h"
+#include "llvm/Support/Error.h"
 
 namespace clang {
 class ASTContext;
@@ -34,6 +35,17 @@ class Program;
 class State;
 enum PrimType : unsigned;
 
+/// Outcome of handing a construct to the VM.
+enum class InterpResult {
+  /// The construct was evaluated.
+  Success,
+  /// The construct is not a constant expression.
+  Fail,
+  /// The construct cannot be compiled and should be evaluated by the AST
+  /// walker instead.
+  Bail,
+};
+
 /// Holds all information required to evaluate constexpr code in a module.
 class Context {
 public:
@@ -44,13 +56,16 @@ public:
   ~Context();
 
   /// Checks if a function is a potential constant expression.
-  bool isPotentialConstantExpr(State &Parent, const FunctionDecl *FnDecl);
+  InterpResult isPotentialConstantExpr(State &Parent,
+                                       const FunctionDecl *FnDecl);
 
   /// Evaluates a toplevel expression as an rvalue.
-  bool evaluateAsRValue(State &Parent, const Expr *E, APValue &Result);
+  InterpResult evaluateAsRValue(State &Parent, const Expr *E,
+                                APValue &Result);
 
   /// Evaluates a toplevel initializer.
-  bool evaluateAsInitializer(State &Parent, const VarDecl *VD, APValue &Result);
+  InterpResult evaluateAsInitializer(State &Parent, const VarDecl *VD,
+                                     APValue &Result);
 
   /// Returns the AST context.
   ASTContext &getASTContext() const { return Ctx; }
@@ -69,7 +84,11 @@ private:
   bool Run(State &Parent, Function *Func, APValue &Result);
 
   /// Checks a result fromt the interpreter.
-  bool Check(State &Parent, llvm::Expected<bool> &&R);
+  InterpResult Check(State &Parent, llvm::Expected<bool> &&R);
+
+  /// Handles a construct the VM cannot compile. It is left to the AST walker,
+  /// unless the VM is forced, in which case it is diagnosed as a failure.
+  InterpResult BailOut(State &Parent, llvm::Error &&Err);
 
 private:
   /// Current compilation context.
@@ -244,6 +244,22 @@ bool EvalEmitter::emitDestroy(uint32_t I, const SourceInfo &Info) {
   return true;
 }
 
+bool EvalEmitter::emitCall(Function *Func, const SourceInfo &Info) {
+  if (!isActive())
+    return true;
+
+  CurrentSource = Info;
+  if (!CheckCallDepth(S, OpPC))
+    return false;
+
+  // Run the callee to completion: returning to the dummy root frame stops
+  // the interpreter with the result on top of the stack.
+  ++S.CallStackDepth;
+  S.Current = new InterpFrame(S, Func, S.Current, CodePtr(), {});
+  APValue Dummy;
+  return Interpret(S, Dummy);
+}
+
 //===----------------------------------------------------------------------===//
 // Opcode evaluators
 //===----------------------------------------------------------------------===//
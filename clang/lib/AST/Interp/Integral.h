@@ -204,6 +204,26 @@ public:
     return CheckMulUB(A.V, B.V, R->V);
   }
 
+  /// The divisor must be nonzero. Returns true if INT_MIN / -1 overflows.
+  static bool div(Integral A, Integral B, unsigned OpBits, Integral *R) {
+    if (A.isMin() && B.isMinusOne()) {
+      *R = A;
+      return true;
+    }
+    *R = Integral(A.V / B.V);
+    return false;
+  }
+
+  /// The divisor must be nonzero. Returns true if INT_MIN % -1 overflows.
+  static bool rem(Integral A, Integral B, unsigned OpBits, Integral *R) {
+    if (A.isMin() && B.isMinusOne()) {
+      *R = zero();
+      return true;
+    }
+    *R = Integral(A.V % B.V);
+    return false;
+  }
+
 private:
   template <typename T>
   static typename std::enable_if<std::is_signed<T>::value, bool>::type
@@ -36,7 +36,7 @@ static bool Ret(InterpState &S, CodePtr &PC, APValue &Result) {
   const T &Ret = S.Stk.pop<T>();
 
   assert(S.Current->getFrameOffset() == S.Stk.size() && "Invalid frame");
-  if (!S.checkingPotentialConstantExpression())
+  if (!S.checkingPotentialConstantExpression() || S.Current->Caller)
     S.Current->popArgs();
 
   if (InterpFrame *Caller = S.Current->Caller) {
@@ -57,7 +57,7 @@ static bool RetVoid(InterpState &S, CodePtr &PC, APValue &Result) {
   S.CallStackDepth--;
 
   assert(S.Current->getFrameOffset() == S.Stk.size() && "Invalid frame");
-  if (!S.checkingPotentialConstantExpression())
+  if (!S.checkingPotentialConstantExpression() || S.Current->Caller)
     S.Current->popArgs();
 
   if (InterpFrame *Caller = S.Current->Caller) {
@@ -75,6 +75,21 @@ static bool RetValue(InterpState &S, CodePtr &Pt, APValue &Result) {
   llvm::report_fatal_error("Interpreter cannot return values");
 }
 
+//===----------------------------------------------------------------------===//
+// Call
+//===----------------------------------------------------------------------===//
+
+static bool Call(InterpState &S, CodePtr &PC, Function *Func) {
+  // Diagnostics are attached to the offset following the opcode.
+  if (!CheckCallDepth(S, PC - sizeof(Function *)))
+    return false;
+
+  ++S.CallStackDepth;
+  S.Current = new InterpFrame(S, Func, S.Current, PC, {});
+  PC = S.Current->getPC();
+  return true;
+}
+
 //===----------------------------------------------------------------------===//
 // Jmp, Jt, Jf
 //===----------------------------------------------------------------------===//
@@ -398,6 +413,16 @@ bool CheckPure(InterpState &S, CodePtr OpPC, const CXXMethodDecl *MD) {
   S.Note(MD->getLocation(), diag::note_declared_at);
   return false;
 }
+bool CheckCallDepth(InterpState &S, CodePtr OpPC) {
+  unsigned Limit = S.getLangOpts().ConstexprCallDepth;
+  if (S.CallStackDepth <= Limit)
+    return true;
+
+  S.FFDiag(S.Current->getSource(OpPC), diag::note_constexpr_depth_limit_exceeded)
+      << Limit;
+  return false;
+}
+
 bool Interpret(InterpState &S, APValue &Result) {
   CodePtr PC = S.Current->getPC();
 
@@ -91,10 +91,13 @@ bool CheckThis(InterpState &S, CodePtr OpPC, const Pointer &This);
 /// Checks if a method is pure virtual.
 bool CheckPure(InterpState &S, CodePtr OpPC, const CXXMethodDecl *MD);
 
+/// Checks if another call fits within the constexpr call depth limit.
+bool CheckCallDepth(InterpState &S, CodePtr OpPC);
+
 template <typename T> inline bool IsTrue(const T &V) { return !V.isZero(); }
 
 //===----------------------------------------------------------------------===//
-// Add, Sub, Mul
+// Add, Sub, Mul, Div, Rem
 //===----------------------------------------------------------------------===//
 
 template <typename T, bool (*OpFW)(T, T, unsigned, T *),
@@ -152,6 +155,50 @@ bool Mul(InterpState &S, CodePtr OpPC) {
   return AddSubMulHelper<T, T::mul, std::multiplies>(S, OpPC, Bits, LHS, RHS);
 }
 
+template <typename T, bool (*OpFW)(T, T, unsigned, T *)>
+bool DivRemHelper(InterpState &S, CodePtr OpPC) {
+  const T &RHS = S.Stk.pop<T>();
+  const T &LHS = S.Stk.pop<T>();
+  const Expr *E = S.Current->getExpr(OpPC);
+  if (RHS.isZero()) {
+    S.FFDiag(E, diag::note_expr_divide_by_zero);
+    return false;
+  }
+
+  // Fast path - only INT_MIN / -1 and INT_MIN % -1 can overflow.
+  T Result;
+  if (!OpFW(LHS, RHS, RHS.bitWidth(), &Result)) {
+    S.Stk.push<T>(Result);
+    return true;
+  }
+
+  // If for some reason evaluation continues, use the wrapped result.
+  S.Stk.push<T>(Result);
+
+  // Report the overflow the way the AST walker does, with the value -INT_MIN.
+  APSInt Value = -LHS.toAPSInt(LHS.bitWidth() + 1);
+  QualType Type = E->getType();
+  if (S.checkingForUndefinedBehavior()) {
+    auto Trunc = Value.trunc(Result.bitWidth()).toString(10);
+    S.report(E->getExprLoc(), diag::warn_integer_constant_overflow)
+        << Trunc << Type;
+    return true;
+  } else {
+    S.CCEDiag(E, diag::note_constexpr_overflow) << Value << Type;
+    return S.noteUndefinedBehavior();
+  }
+}
+
+template <PrimType Name, class T = typename PrimConv<Name>::T>
+bool Div(InterpState &S, CodePtr OpPC) {
+  return DivRemHelper<T, T::div>(S, OpPC);
+}
+
+template <PrimType Name, class T = typename PrimConv<Name>::T>
+bool Rem(InterpState &S, CodePtr OpPC) {
+  return DivRemHelper<T, T::rem>(S, OpPC);
+}
+
 //===----------------------------------------------------------------------===//
 // EQ, NE, GT, GE, LT, LE
 //===----------------------------------------------------------------------===//
@@ -314,7 +361,7 @@ bool SetLocal(InterpState &S, CodePtr OpPC, uint32_t I) {
 
 template <PrimType Name, class T = typename PrimConv<Name>::T>
 bool GetParam(InterpState &S, CodePtr OpPC, uint32_t I) {
-  if (S.checkingPotentialConstantExpression()) {
+  if (S.checkingPotentialConstantExpression() && !S.Current->Caller) {
     return false;
   }
   S.Stk.push<T>(S.Current->getParam<T>(I));
@@ -793,14 +840,37 @@ inline bool Destroy(InterpState &S, CodePtr OpPC, uint32_t I) {
   return true;
 }
 
+//===----------------------------------------------------------------------===//
+// LoopStep
+//===----------------------------------------------------------------------===//
+
+inline bool LoopStep(InterpState &S, CodePtr OpPC) {
+  if (S.StepsLeft == 0) {
+    const SourceInfo &Loc = S.Current->getSource(OpPC);
+    S.FFDiag(Loc, diag::note_constexpr_step_limit_exceeded);
+    return false;
+  }
+  --S.StepsLeft;
+  return true;
+}
+
 //===----------------------------------------------------------------------===//
 // Cast, CastFP
 //===----------------------------------------------------------------------===//
 
+template <typename U, typename T> U castPrimitive(const T &Value) {
+  return U::from(Value);
+}
+
+/// Integrals cannot be built from booleans directly, go through unsigned.
+template <typename U> U castPrimitive(const Boolean &Value) {
+  return U::from(static_cast<unsigned>(Value));
+}
+
 template <PrimType TIn, PrimType TOut> bool Cast(InterpState &S, CodePtr OpPC) {
   using T = typename PrimConv<TIn>::T;
   using U = typename PrimConv<TOut>::T;
-  S.Stk.push<U>(U::from(S.Stk.pop<T>()));
+  S.Stk.push<U>(castPrimitive<U>(S.Stk.pop<T>()));
   return true;
 }
 
@@ -8,6 +8,7 @@
 
 #include "InterpState.h"
 #include <limits>
+#include "Context.h"
 #include "Function.h"
 #include "InterpFrame.h"
 #include "InterpStack.h"
@@ -24,7 +25,8 @@ using APSInt = llvm::APSInt;
 InterpState::InterpState(State &Parent, Program &P, InterpStack &Stk,
                          Context &Ctx, SourceMapper *M)
     : Parent(Parent), M(M), P(P), Stk(Stk), Ctx(Ctx), Current(nullptr),
-      CallStackDepth(Parent.getCallStackDepth() + 1) {}
+      CallStackDepth(Parent.getCallStackDepth() + 1),
+      StepsLeft(Ctx.getLangOpts().ConstexprStepLimit) {}
 
 InterpState::~InterpState() {
   while (Current) {
@@ -104,6 +104,8 @@ public:
   InterpFrame *Current = nullptr;
   /// Call stack depth.
   unsigned CallStackDepth;
+  /// Number of loop iterations left before evaluation is abandoned.
+  unsigned StepsLeft;
 };
 
 } // namespace interp
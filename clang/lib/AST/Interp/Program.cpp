@@ -155,6 +155,11 @@ llvm::Optional<unsigned> Program::createGlobal(const ValueDecl *VD) {
   return {};
 }
 
+void Program::forgetGlobal(const ValueDecl *VD) {
+  for (const Decl *P = VD; P; P = P->getPreviousDecl())
+    GlobalIndices.erase(P);
+}
+
 llvm::Optional<unsigned> Program::createGlobal(const Expr *E) {
   return createGlobal(E, E->getType(), /*isStatic=*/true, /*isExtern=*/false);
 }
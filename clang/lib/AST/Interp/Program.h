@@ -71,6 +71,10 @@ public:
   /// Creates a global from a lifetime-extended temporary.
   llvm::Optional<unsigned> createGlobal(const Expr *E);
 
+  /// Drops the mapping from a declaration and its redeclarations to their
+  /// global, which was left uninitialized.
+  void forgetGlobal(const ValueDecl *VD);
+
   /// Creates a new function from a code range.
   template <typename... Ts>
   Function *createFunction(const FunctionDecl *Def, Ts &&... Args) {
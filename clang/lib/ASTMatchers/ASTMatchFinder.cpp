@@ -20,7 +20,9 @@
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/RecursiveASTVisitor.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/Support/Timer.h"
 #include <deque>
 #include <memory>
@@ -612,15 +614,49 @@ private:
     }
   }
 
+  /// Indices of the \c Decl and \c Stmt matchers that can match a node kind.
+  struct MatcherFilter {
+    /// All matchers that pass the toplevel restrict check.
+    std::vector<unsigned short> All;
+    /// The subset of \c All that can match any node of the kind.
+    std::vector<unsigned short> Unnamed;
+    /// The remaining matchers of \c All, keyed by the unqualified names they
+    /// require the matched declaration to have.
+    llvm::StringMap<std::vector<unsigned short>> ByName;
+  };
+
   void matchWithFilter(const ast_type_traits::DynTypedNode &DynNode) {
     auto Kind = DynNode.getNodeKind();
     auto it = MatcherFiltersMap.find(Kind);
     const auto &Filter =
         it != MatcherFiltersMap.end() ? it->second : getFilterForKind(Kind);
 
-    if (Filter.empty())
+    if (Filter.All.empty())
       return;
 
+    if (Filter.ByName.empty())
+      return runFilteredMatchers(DynNode, Filter.All);
+
+    // Only run the matchers that are constrained to the name of this
+    // declaration, along with the unconstrained ones.
+    llvm::SmallString<128> Scratch;
+    StringRef Name = getUnqualifiedName(*DynNode.get<NamedDecl>(), Scratch);
+    if (Name.contains("::"))
+      return runFilteredMatchers(DynNode, Filter.All);
+    auto ByName = Filter.ByName.find(Name);
+    if (ByName == Filter.ByName.end())
+      return runFilteredMatchers(DynNode, Filter.Unnamed);
+
+    // Keep running the matchers in the order they were added.
+    llvm::SmallVector<unsigned short, 16> Indices;
+    std::merge(Filter.Unnamed.begin(), Filter.Unnamed.end(),
+               ByName->second.begin(), ByName->second.end(),
+               std::back_inserter(Indices));
+    runFilteredMatchers(DynNode, Indices);
+  }
+
+  void runFilteredMatchers(const ast_type_traits::DynTypedNode &DynNode,
+                           ArrayRef<unsigned short> Filter) {
     const bool EnableCheckProfiling = Options.CheckProfiling.hasValue();
     TimeBucketRegion Timer;
     auto &Matchers = this->Matchers->DeclOrStmt;
@@ -636,15 +672,52 @@ private:
     }
   }
 
-  const std::vector<unsigned short> &
-  getFilterForKind(ast_type_traits::ASTNodeKind Kind) {
+  /// Returns the name of \p Node as the last component of the names passed
+  /// to \c hasName() is compared to it.
+  static StringRef getUnqualifiedName(const NamedDecl &Node,
+                                      llvm::SmallString<128> &Scratch) {
+    if (Node.getIdentifier())
+      return Node.getName();
+    if (Node.getDeclName()) {
+      llvm::raw_svector_ostream OS(Scratch);
+      Node.printName(OS);
+      return OS.str();
+    }
+    return "(anonymous)";
+  }
+
+  const MatcherFilter &getFilterForKind(ast_type_traits::ASTNodeKind Kind) {
     auto &Filter = MatcherFiltersMap[Kind];
     auto &Matchers = this->Matchers->DeclOrStmt;
     assert((Matchers.size() < USHRT_MAX) && "Too many matchers.");
+    const bool IsNamedDecl =
+        ast_type_traits::ASTNodeKind::getFromNodeKind<NamedDecl>().isBaseOf(
+            Kind);
+    if (IsNamedDecl && RequiredNames.empty()) {
+      RequiredNames.resize(Matchers.size());
+      for (unsigned I = 0, E = Matchers.size(); I != E; ++I) {
+        std::vector<std::string> Names;
+        if (!Matchers[I].first.getRequiredNames(Names))
+          continue;
+        // Only the last component of a qualified name has to be equal to the
+        // name of the declaration.
+        for (StringRef Name : Names) {
+          size_t Pos = Name.rfind("::");
+          RequiredNames[I].insert(Pos == StringRef::npos ? Name
+                                                         : Name.substr(Pos + 2));
+        }
+      }
+    }
     for (unsigned I = 0, E = Matchers.size(); I != E; ++I) {
-      if (Matchers[I].first.canMatchNodesOfKind(Kind)) {
-        Filter.push_back(I);
+      if (!Matchers[I].first.canMatchNodesOfKind(Kind))
+        continue;
+      Filter.All.push_back(I);
+      if (!IsNamedDecl || RequiredNames[I].empty()) {
+        Filter.Unnamed.push_back(I);
+        continue;
       }
+      for (const auto &Name : RequiredNames[I])
+        Filter.ByName[Name.getKey()].push_back(I);
     }
     return Filter;
   }
@@ -860,9 +933,14 @@ private:
   /// \c Decl and \c Stmt toplevel matchers usually apply to a specific node
   /// kind (and derived kinds) so it is a waste to try every matcher on every
   /// node.
-  /// We precalculate a list of matchers that pass the toplevel restrict check.
-  llvm::DenseMap<ast_type_traits::ASTNodeKind, std::vector<unsigned short>>
-      MatcherFiltersMap;
+  /// We precalculate a list of matchers that pass the toplevel restrict check,
+  /// and for named declarations further split it by the names passed to
+  /// \c hasName(), which most declaration matchers of tools are restricted to.
+  llvm::DenseMap<ast_type_traits::ASTNodeKind, MatcherFilter> MatcherFiltersMap;
+
+  /// The unqualified names required by each \c Decl and \c Stmt matcher,
+  /// computed on first use. Empty for matchers that don't constrain the name.
+  std::vector<llvm::StringSet<>> RequiredNames;
 
   const MatchFinder::MatchFinderOptions &Options;
   ASTContext *ActiveASTContext;
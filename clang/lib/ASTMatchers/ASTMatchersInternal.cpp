@@ -99,6 +99,26 @@ public:
     return Func(DynNode, Finder, Builder, InnerMatchers);
   }
 
+  bool getRequiredNames(std::vector<std::string> &Names) const override {
+    // allOf() only matches nodes that every inner matcher matches, so the
+    // constraint of any of them applies.
+    if (Func == AllOfVariadicOperator)
+      return llvm::any_of(InnerMatchers, [&](const DynTypedMatcher &M) {
+        return M.getRequiredNames(Names);
+      });
+    // anyOf() and eachOf() match nodes that at least one inner matcher
+    // matches, so every one of them must be constrained.
+    if (Func == AnyOfVariadicOperator || Func == EachOfVariadicOperator) {
+      std::vector<std::string> AllNames;
+      for (const DynTypedMatcher &M : InnerMatchers)
+        if (!M.getRequiredNames(AllNames))
+          return false;
+      Names.insert(Names.end(), AllNames.begin(), AllNames.end());
+      return true;
+    }
+    return false;
+  }
+
 private:
   std::vector<DynTypedMatcher> InnerMatchers;
 };
@@ -122,6 +142,10 @@ public:
     return InnerMatcher->TraversalKind();
   }
 
+  bool getRequiredNames(std::vector<std::string> &Names) const override {
+    return InnerMatcher->getRequiredNames(Names);
+  }
+
 private:
   const std::string ID;
   const IntrusiveRefCntPtr<DynMatcherInterface> InnerMatcher;
@@ -598,6 +622,11 @@ bool HasNameMatcher::matchesNode(const NamedDecl &Node) const {
   return matchesNodeFullFast(Node);
 }
 
+bool HasNameMatcher::getRequiredNames(std::vector<std::string> &Result) const {
+  Result.insert(Result.end(), Names.begin(), Names.end());
+  return true;
+}
+
 } // end namespace internal
 
 const internal::VariadicDynCastAllOfMatcher<Stmt, ObjCAutoreleasePoolStmt>
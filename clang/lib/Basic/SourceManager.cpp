@@ -386,6 +386,7 @@ void SourceManager::clearIDTables() {
   // Use up FileID #0 as an invalid expansion.
   NextLocalOffset = 0;
   CurrentLoadedOffset = MaxLoadedOffset;
+  SLocSpaceExhausted = false;
   createExpansionLoc(SourceLocation(), SourceLocation(), SourceLocation(), 1);
 }
 
@@ -577,13 +578,16 @@ FileID SourceManager::createFileID(const ContentCache *File, StringRef Filename,
     SLocEntryLoaded[Index] = true;
     return FileID::get(LoadedID);
   }
+  unsigned FileSize = File->getSize();
+  if (SLocSpaceExhausted ||
+      !(NextLocalOffset + FileSize + 1 > NextLocalOffset &&
+        NextLocalOffset + FileSize + 1 <= CurrentLoadedOffset)) {
+    reportSLocSpaceExhausted(IncludePos);
+    return FileID();
+  }
   LocalSLocEntryTable.push_back(
       SLocEntry::get(NextLocalOffset,
                      FileInfo::get(IncludePos, File, FileCharacter, Filename)));
-  unsigned FileSize = File->getSize();
-  assert(NextLocalOffset + FileSize + 1 > NextLocalOffset &&
-         NextLocalOffset + FileSize + 1 <= CurrentLoadedOffset &&
-         "Ran out of source locations!");
   // We do a +1 here because we want a SourceLocation that means "the end of the
   // file", e.g. for the "no newline at the end of the file" diagnostic.
   NextLocalOffset += FileSize + 1;
@@ -640,15 +644,27 @@ SourceManager::createExpansionLocImpl(const ExpansionInfo &Info,
     SLocEntryLoaded[Index] = true;
     return SourceLocation::getMacroLoc(LoadedOffset);
   }
+  if (SLocSpaceExhausted ||
+      !(NextLocalOffset + TokLength + 1 > NextLocalOffset &&
+        NextLocalOffset + TokLength + 1 <= CurrentLoadedOffset)) {
+    reportSLocSpaceExhausted(Info.getExpansionLocStart());
+    return SourceLocation();
+  }
   LocalSLocEntryTable.push_back(SLocEntry::get(NextLocalOffset, Info));
-  assert(NextLocalOffset + TokLength + 1 > NextLocalOffset &&
-         NextLocalOffset + TokLength + 1 <= CurrentLoadedOffset &&
-         "Ran out of source locations!");
   // See createFileID for that +1.
   NextLocalOffset += TokLength + 1;
   return SourceLocation::getMacroLoc(NextLocalOffset - (TokLength + 1));
 }
 
+void SourceManager::reportSLocSpaceExhausted(SourceLocation Loc) const {
+  // The error is fatal, so report it, and compute the usage summary, once.
+  if (SLocSpaceExhausted)
+    return;
+  SLocSpaceExhausted = true;
+  Diag.Report(Loc, diag::err_sloc_space_too_large);
+  noteSLocAddressSpaceUsage(Diag);
+}
+
 const llvm::MemoryBuffer *
 SourceManager::getMemoryBufferForFile(const FileEntry *File, bool *Invalid) {
   const SrcMgr::ContentCache *IR = getOrCreateContentCache(File);
@@ -2054,6 +2070,31 @@ void SourceManager::PrintStats() const {
                << MaxLoadedOffset - CurrentLoadedOffset
                << "B of Sloc address space used.\n";
 
+  // Break the local address space down by the kind of entry using it.
+  unsigned NumFileEntries = 0, NumMacroExpansions = 0, NumMacroArgExpansions = 0;
+  unsigned FileSpace = 0, MacroExpansionSpace = 0, MacroArgExpansionSpace = 0;
+  for (unsigned I = 1, N = LocalSLocEntryTable.size(); I != N; ++I) {
+    const SrcMgr::SLocEntry &Entry = LocalSLocEntryTable[I];
+    unsigned End = I + 1 == N ? NextLocalOffset
+                              : LocalSLocEntryTable[I + 1].getOffset();
+    unsigned Size = End - Entry.getOffset();
+    if (Entry.isFile()) {
+      ++NumFileEntries;
+      FileSpace += Size;
+    } else if (Entry.getExpansion().isMacroArgExpansion()) {
+      ++NumMacroArgExpansions;
+      MacroArgExpansionSpace += Size;
+    } else {
+      ++NumMacroExpansions;
+      MacroExpansionSpace += Size;
+    }
+  }
+  llvm::errs() << NumFileEntries << " file entries (" << FileSpace << "B), "
+               << NumMacroExpansions << " macro expansions ("
+               << MacroExpansionSpace << "B), " << NumMacroArgExpansions
+               << " macro argument expansions (" << MacroArgExpansionSpace
+               << "B) of local Sloc address space.\n";
+
   unsigned NumLineNumsComputed = 0;
   unsigned NumFileBytesMapped = 0;
   for (fileinfo_iterator I = fileinfo_begin(), E = fileinfo_end(); I != E; ++I){
@@ -2069,6 +2110,56 @@ void SourceManager::PrintStats() const {
                << NumBinaryProbes << " binary.\n";
 }
 
+void SourceManager::noteSLocAddressSpaceUsage(DiagnosticsEngine &Diag,
+                                              unsigned MaxNotes) const {
+  struct FileUsage {
+    SourceLocation FirstLoc;
+    unsigned Inclusions = 0;
+    unsigned Size = 0;
+  };
+
+  // Every inclusion of the same file is accounted together.
+  llvm::DenseMap<const SrcMgr::ContentCache *, FileUsage> Usage;
+  unsigned NumExpansions = 0, ExpansionSize = 0;
+  for (unsigned I = 1, N = LocalSLocEntryTable.size(); I != N; ++I) {
+    const SrcMgr::SLocEntry &Entry = LocalSLocEntryTable[I];
+    unsigned End = I + 1 == N ? NextLocalOffset
+                              : LocalSLocEntryTable[I + 1].getOffset();
+    unsigned Size = End - Entry.getOffset();
+    if (Entry.isFile()) {
+      FileUsage &U = Usage[Entry.getFile().getContentCache()];
+      if (!U.Inclusions++)
+        U.FirstLoc = SourceLocation::getFileLoc(Entry.getOffset());
+      U.Size += Size;
+    } else {
+      ++NumExpansions;
+      ExpansionSize += Size;
+    }
+  }
+
+  uint64_t LoadedSize = MaxLoadedOffset - CurrentLoadedOffset;
+  uint64_t TotalSize = NextLocalOffset + LoadedSize;
+  Diag.Report(SourceLocation(), diag::note_sloc_usage_total)
+      << NextLocalOffset << unsigned(LoadedSize) << unsigned(TotalSize)
+      << unsigned(TotalSize * 100 / MaxLoadedOffset);
+
+  std::vector<FileUsage> Files;
+  Files.reserve(Usage.size());
+  for (const auto &U : Usage)
+    Files.push_back(U.second);
+  llvm::sort(Files, [](const FileUsage &LHS, const FileUsage &RHS) {
+    return std::tie(LHS.Size, RHS.FirstLoc) > std::tie(RHS.Size, LHS.FirstLoc);
+  });
+  if (Files.size() > MaxNotes)
+    Files.resize(MaxNotes);
+  for (const FileUsage &U : Files)
+    Diag.Report(U.FirstLoc, diag::note_sloc_usage_file)
+        << U.Inclusions << U.Size;
+
+  Diag.Report(SourceLocation(), diag::note_sloc_usage_expansions)
+      << NumExpansions << ExpansionSize;
+}
+
 LLVM_DUMP_METHOD void SourceManager::dump() const {
   llvm::raw_ostream &out = llvm::errs();
 
@@ -15,18 +15,26 @@
 #include "clang/Driver/Options.h"
 #include "clang/Driver/ToolChain.h"
 #include "clang/Driver/Util.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/None.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Triple.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/Option/ArgList.h"
 #include "llvm/Option/OptSpecifier.h"
 #include "llvm/Option/Option.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cassert>
+#include <condition_variable>
+#include <mutex>
 #include <string>
 #include <system_error>
+#include <thread>
 #include <utility>
 
 using namespace clang;
@@ -220,8 +228,173 @@ static bool InputsOk(const Command &C,
   return !ActionFailed(&C.getSource(), FailingCommands);
 }
 
+namespace {
+/// A job scheduled by Compilation::ExecuteJobsInParallel.
+struct ParallelJob {
+  enum StateKind { Pending, Running, Finished, Collected, Skipped };
+
+  const Command *Cmd;
+  StateKind State = Pending;
+  /// Jobs producing the inputs of this one.
+  SmallVector<unsigned, 4> Deps;
+  /// Files capturing stdout and stderr until they are replayed in order.
+  SmallString<128> OutPath, ErrPath;
+  std::thread Thread;
+  int Res = 0;
+  std::string Error;
+};
+} // namespace
+
+static void replayCapturedOutput(StringRef Path, raw_ostream &OS) {
+  if (auto Buf = llvm::MemoryBuffer::getFile(Path)) {
+    OS << (*Buf)->getBuffer();
+    OS.flush();
+  }
+  llvm::sys::fs::remove(Path);
+}
+
+bool Compilation::ExecuteJobsInParallel(
+    const JobList &Jobs, FailingCommandList &FailingCommands) const {
+#if LLVM_ENABLE_THREADS
+  std::vector<ParallelJob> Work(Jobs.size());
+  llvm::DenseMap<const Action *, SmallVector<unsigned, 1>> JobsForAction;
+  unsigned Idx = 0;
+  for (const auto &Job : Jobs) {
+    Work[Idx].Cmd = &Job;
+    JobsForAction[&Job.getSource()].push_back(Idx++);
+  }
+
+  // A job depends on the jobs which create any of the actions it consumes.
+  // Precompiled headers are consumed through command line flags instead of
+  // actions, so every later job waits for them.
+  SmallVector<unsigned, 2> Barriers;
+  for (unsigned I = 0, E = Work.size(); I != E; ++I) {
+    ParallelJob &J = Work[I];
+    J.Deps.append(Barriers.begin(), Barriers.end());
+    SmallVector<const Action *, 8> Worklist(J.Cmd->getSource().inputs());
+    llvm::SmallPtrSet<const Action *, 16> Visited;
+    while (!Worklist.empty()) {
+      const Action *A = Worklist.pop_back_val();
+      if (!Visited.insert(A).second)
+        continue;
+      auto It = JobsForAction.find(A);
+      if (It != JobsForAction.end())
+        for (unsigned Dep : It->second)
+          if (Dep != I)
+            J.Deps.push_back(Dep);
+      Worklist.append(A->input_begin(), A->input_end());
+    }
+    if (isa<PrecompileJobAction>(J.Cmd->getSource()))
+      Barriers.push_back(I);
+  }
+
+  // Capture the output of every job so that it can be replayed in order.
+  for (ParallelJob &J : Work) {
+    if (!llvm::sys::fs::createTemporaryFile("clang-job", "out", J.OutPath) &&
+        !llvm::sys::fs::createTemporaryFile("clang-job", "err", J.ErrPath))
+      continue;
+    for (ParallelJob &Created : Work) {
+      if (!Created.OutPath.empty())
+        llvm::sys::fs::remove(Created.OutPath);
+      if (!Created.ErrPath.empty())
+        llvm::sys::fs::remove(Created.ErrPath);
+    }
+    return false;
+  }
+
+  std::mutex Mutex;
+  std::condition_variable JobFinished;
+  std::unique_lock<std::mutex> Lock(Mutex);
+  SmallVector<std::pair<int, const Command *>, 4> Failures;
+  unsigned NumRunning = 0, NextToReplay = 0;
+  while (NextToReplay != Work.size()) {
+    bool Progress = false;
+
+    // Collect the jobs which finished since the last round.
+    for (ParallelJob &J : Work) {
+      if (J.State != ParallelJob::Finished)
+        continue;
+      J.Thread.join();
+      J.State = ParallelJob::Collected;
+      --NumRunning;
+      if (J.Res)
+        Failures.push_back(std::make_pair(J.Res, J.Cmd));
+      Progress = true;
+    }
+
+    // Replay the output of finished jobs in job order, as if the jobs had run
+    // one after another.
+    for (; NextToReplay != Work.size(); ++NextToReplay) {
+      ParallelJob &J = Work[NextToReplay];
+      if (J.State == ParallelJob::Skipped)
+        continue;
+      if (J.State != ParallelJob::Collected)
+        break;
+      replayCapturedOutput(J.OutPath, llvm::outs());
+      replayCapturedOutput(J.ErrPath, llvm::errs());
+      if (!J.Error.empty()) {
+        assert(J.Res && "Error string set with 0 result code!");
+        getDriver().Diag(diag::err_drv_command_failure) << J.Error;
+      }
+      if (J.Res)
+        FailingCommands.push_back(std::make_pair(J.Res, J.Cmd));
+    }
+
+    // Start the jobs whose inputs are available, and skip those whose inputs
+    // are missing due to failures.
+    for (ParallelJob &J : Work) {
+      if (NumRunning == ParallelJobs)
+        break;
+      if (J.State != ParallelJob::Pending ||
+          llvm::any_of(J.Deps, [&](unsigned Dep) {
+            return Work[Dep].State != ParallelJob::Collected &&
+                   Work[Dep].State != ParallelJob::Skipped;
+          }))
+        continue;
+      Progress = true;
+      if (!InputsOk(*J.Cmd, Failures)) {
+        J.State = ParallelJob::Skipped;
+        llvm::sys::fs::remove(J.OutPath);
+        llvm::sys::fs::remove(J.ErrPath);
+        continue;
+      }
+      J.State = ParallelJob::Running;
+      ++NumRunning;
+      J.Thread = std::thread([&J, &Mutex, &JobFinished] {
+        Optional<StringRef> Redirects[] = {None, StringRef(J.OutPath),
+                                           StringRef(J.ErrPath)};
+        std::string Error;
+        bool ExecutionFailed = false;
+        int Res = J.Cmd->Execute(Redirects, &Error, &ExecutionFailed);
+        std::lock_guard<std::mutex> Guard(Mutex);
+        J.Res = ExecutionFailed ? 1 : Res;
+        J.Error = std::move(Error);
+        J.State = ParallelJob::Finished;
+        JobFinished.notify_one();
+      });
+    }
+
+    if (!Progress) {
+      assert(NumRunning && "job dependencies form a cycle");
+      JobFinished.wait(Lock);
+    }
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
 void Compilation::ExecuteJobs(const JobList &Jobs,
                               FailingCommandList &FailingCommands) const {
+  // Independent jobs can run concurrently when their output is not needed
+  // interleaved with anything else the driver prints.
+  if (ParallelJobs > 1 && Jobs.size() > 1 && !TheDriver.IsCLMode() &&
+      Redirects.empty() && !getDriver().CCPrintOptions &&
+      !getArgs().hasArg(options::OPT_v) &&
+      ExecuteJobsInParallel(Jobs, FailingCommands))
+    return;
+
   // According to UNIX standard, driver need to continue compiling all the
   // inputs on the command line even one of them failed.
   // In all but CLMode, execute all the jobs unless the necessary inputs for the
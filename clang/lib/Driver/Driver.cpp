@@ -1121,6 +1121,15 @@ Compilation *Driver::BuildCompilation(ArrayRef<const char *> ArgList) {
   Compilation *C = new Compilation(*this, TC, UArgs.release(), TranslatedArgs,
                                    ContainsError);
 
+  if (Arg *A = C->getArgs().getLastArg(options::OPT_j)) {
+    unsigned N;
+    if (StringRef(A->getValue()).getAsInteger(10, N) || N == 0)
+      Diag(clang::diag::err_drv_invalid_int_value)
+          << A->getAsString(C->getArgs()) << A->getValue();
+    else
+      C->setParallelJobs(N);
+  }
+
   if (!HandleImmediateArgs(*C))
     return C;
 
@@ -6001,6 +6001,22 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
     CmdArgs.push_back(Args.MakeArgString(Str));
   }
 
+  // With -j, split the analysis of the file into one shard per job, so that
+  // the driver runs them concurrently. The shard options go right before the
+  // output, unless the user already picked the shards.
+  unsigned AnalyzerShards = 1;
+  size_t AnalyzerShardArgIdx = CmdArgs.size();
+  if (isa<AnalyzeJobAction>(JA) && C.getParallelJobs() > 1) {
+    auto IsShardConfig = [](StringRef Value) {
+      return Value.contains("shard-count") || Value.contains("shard-index");
+    };
+    if (llvm::none_of(Args.getAllArgValues(options::OPT_Xclang),
+                      IsShardConfig) &&
+        llvm::none_of(Args.getAllArgValues(options::OPT_Xanalyzer),
+                      IsShardConfig))
+      AnalyzerShards = C.getParallelJobs();
+  }
+
   // Add the "-o out -x type src.c" flags last. This is done primarily to make
   // the -cc1 command easier to edit when reproducing compiler crashes.
   if (Output.getType() == types::TY_Dependencies) {
@@ -6036,7 +6052,39 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
   }
 
   // Finally add the compile command to the compilation.
-  if (Args.hasArg(options::OPT__SLASH_fallback) &&
+  if (AnalyzerShards > 1) {
+    // Every shard writes its own plist file, next to the requested one. HTML
+    // reports have unique names, so the shards can share a directory.
+    StringRef Format = Args.getLastArgValue(options::OPT__analyzer_output,
+                                            "plist");
+    bool SeparateOutputs = Output.isFilename() &&
+                           (Format.startswith("plist") || Format == "sarif");
+    for (unsigned I = 0; I != AnalyzerShards; ++I) {
+      ArgStringList ShardArgs(CmdArgs);
+      if (I != 0 && SeparateOutputs) {
+        SmallString<128> ShardOutput(Output.getFilename());
+        StringRef Ext = llvm::sys::path::extension(Output.getFilename());
+        llvm::sys::path::replace_extension(ShardOutput,
+                                           "shard" + Twine(I) + Ext);
+        assert(ShardArgs[AnalyzerShardArgIdx + 1] == Output.getFilename() &&
+               "Expected the output right after the shard options");
+        ShardArgs[AnalyzerShardArgIdx + 1] =
+            C.addResultFile(Args.MakeArgString(ShardOutput), &JA);
+      }
+      const char *ShardConfig[] = {
+          "-analyzer-config",
+          Args.MakeArgString("shard-count=" + Twine(AnalyzerShards) +
+                             ",shard-index=" + Twine(I))};
+      ShardArgs.insert(ShardArgs.begin() + AnalyzerShardArgIdx,
+                       std::begin(ShardConfig), std::end(ShardConfig));
+      if (D.CC1Main && !D.CCGenDiagnostics)
+        C.addCommand(
+            std::make_unique<CC1Command>(JA, *this, Exec, ShardArgs, Inputs));
+      else
+        C.addCommand(
+            std::make_unique<Command>(JA, *this, Exec, ShardArgs, Inputs));
+    }
+  } else if (Args.hasArg(options::OPT__SLASH_fallback) &&
       Output.getType() == types::TY_Object &&
       (InputType == types::TY_C || InputType == types::TY_CXX)) {
     auto CLCommand =
@@ -17,6 +17,7 @@
 #include "ContinuationIndenter.h"
 #include "FormatInternal.h"
 #include "FormatTokenLexer.h"
+#include "IncrementalFormat.h"
 #include "NamespaceEndCommentsFixer.h"
 #include "SortJavaScriptImports.h"
 #include "TokenAnalyzer.h"
@@ -39,6 +40,7 @@
 #include "llvm/Support/VirtualFileSystem.h"
 #include "llvm/Support/YAMLTraits.h"
 #include <algorithm>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -1251,6 +1253,12 @@ FormatStyle::GetLanguageStyle(FormatStyle::LanguageKind Language) const {
   return StyleSet.Get(Language);
 }
 
+static bool inputUsesCRLF(StringRef Text, bool DefaultToCRLF) {
+  size_t LF = Text.count('\n');
+  size_t CR = Text.count('\r') * 2;
+  return LF == CR ? DefaultToCRLF : CR > LF;
+}
+
 namespace {
 
 class JavaScriptRequoter : public TokenAnalyzer {
@@ -1385,12 +1393,6 @@ public:
   }
 
 private:
-  static bool inputUsesCRLF(StringRef Text, bool DefaultToCRLF) {
-    size_t LF = Text.count('\n');
-    size_t CR = Text.count('\r') * 2;
-    return LF == CR ? DefaultToCRLF : CR > LF;
-  }
-
   bool
   hasCpp03IncompatibleFormat(const SmallVectorImpl<AnnotatedLine *> &Lines) {
     for (const AnnotatedLine *Line : Lines) {
@@ -2488,6 +2490,107 @@ tooling::Replacements reformat(const FormatStyle &Style, StringRef Code,
   return Result;
 }
 
+struct IncrementalFormatCache::Impl {
+  struct Entry {
+    FormatStyle Style;
+    std::string FileName;
+    std::string Code;
+    std::vector<tooling::Range> Ranges;
+    tooling::Replacements Result;
+    FormattingAttemptStatus Status;
+  };
+
+  explicit Impl(unsigned MaxEntries) : MaxEntries(MaxEntries) {}
+
+  unsigned MaxEntries;
+  std::mutex Mutex;
+  // Most recently used first.
+  std::list<Entry> Entries;
+};
+
+IncrementalFormatCache::IncrementalFormatCache(unsigned MaxEntries)
+    : Cached(std::make_unique<Impl>(MaxEntries)) {}
+
+IncrementalFormatCache::~IncrementalFormatCache() = default;
+
+tooling::Replacements reformatIncrementally(const FormatStyle &Style,
+                                            StringRef Code,
+                                            ArrayRef<tooling::Range> Ranges,
+                                            StringRef FileName,
+                                            FormattingAttemptStatus *Status,
+                                            IncrementalFormatCache *Cache) {
+  llvm::Optional<internal::FormattingRegion> Region =
+      isLikelyXml(Code) ? None
+                        : internal::findFormattingRegion(Style, Code, Ranges);
+  if (!Region)
+    return reformat(Style, Code, Ranges, FileName, Status);
+
+  // The line ending is derived from the whole file, as the region may use a
+  // different one than most of the file.
+  FormatStyle RegionStyle = Style;
+  if (Style.DeriveLineEnding) {
+    RegionStyle.DeriveLineEnding = false;
+    RegionStyle.UseCRLF = inputUsesCRLF(Code, Style.UseCRLF);
+  }
+
+  // Copied, as the formatter's source buffers must be null-terminated.
+  std::string RegionCode = Code.substr(Region->Offset, Region->Length);
+  std::vector<tooling::Range> RegionRanges;
+  for (const tooling::Range &R : Ranges)
+    RegionRanges.push_back(
+        tooling::Range(R.getOffset() - Region->Offset, R.getLength()));
+
+  tooling::Replacements RegionResult;
+  FormattingAttemptStatus RegionStatus;
+  bool Found = false;
+  if (Cache) {
+    IncrementalFormatCache::Impl &C = *Cache->Cached;
+    std::lock_guard<std::mutex> Lock(C.Mutex);
+    for (auto I = C.Entries.begin(), E = C.Entries.end(); I != E; ++I) {
+      if (I->Ranges == RegionRanges && I->FileName == FileName &&
+          I->Code == RegionCode && I->Style == RegionStyle) {
+        RegionResult = I->Result;
+        RegionStatus = I->Status;
+        C.Entries.splice(C.Entries.begin(), C.Entries, I);
+        Found = true;
+        break;
+      }
+    }
+  }
+  if (!Found) {
+    RegionResult =
+        reformat(RegionStyle, RegionCode, RegionRanges, FileName,
+                 &RegionStatus);
+    if (Cache) {
+      IncrementalFormatCache::Impl &C = *Cache->Cached;
+      std::lock_guard<std::mutex> Lock(C.Mutex);
+      C.Entries.push_front({RegionStyle, FileName, RegionCode, RegionRanges,
+                            RegionResult, RegionStatus});
+      if (C.Entries.size() > C.MaxEntries)
+        C.Entries.pop_back();
+    }
+  }
+
+  if (Status) {
+    *Status = RegionStatus;
+    if (!RegionStatus.FormatComplete)
+      Status->Line += Region->LinesBefore;
+  }
+  tooling::Replacements Result;
+  for (const tooling::Replacement &R : RegionResult) {
+    auto Err = Result.add(tooling::Replacement(
+        FileName, Region->Offset + R.getOffset(), R.getLength(),
+        R.getReplacementText()));
+    // FIXME: handle error. For now, print error message and skip the
+    // replacement for release version.
+    if (Err) {
+      llvm::errs() << llvm::toString(std::move(Err)) << "\n";
+      assert(false);
+    }
+  }
+  return Result;
+}
+
 tooling::Replacements fixNamespaceEndComments(const FormatStyle &Style,
                                               StringRef Code,
                                               ArrayRef<tooling::Range> Ranges,
@@ -0,0 +1,509 @@
+//===--- IncrementalFormat.cpp - Format Code Incrementally ------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file implements findFormattingRegion, which finds a part of a file that
+/// can be formatted on its own, without lexing and parsing the whole file.
+///
+//===----------------------------------------------------------------------===//
+
+#include "IncrementalFormat.h"
+#include "clang/Basic/CharInfo.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "format-incremental"
+
+namespace clang {
+namespace format {
+namespace internal {
+
+namespace {
+
+const unsigned NoScope = ~0u;
+
+// A line that may start a formatting region.
+struct Boundary {
+  // Offset of the first character of the line.
+  unsigned Offset;
+  // Offset right after the last non-whitespace character before the line.
+  unsigned PrevCodeEnd;
+  // Offset of the innermost open namespace or extern block brace, if any.
+  unsigned Scope;
+  // Offset of the innermost open preprocessor conditional branch, if any.
+  unsigned PPScope;
+};
+
+// Scans code for lines that start a new top-level declaration after an empty
+// line. This only looks at characters; it does not run the lexer, so it gives
+// up rather than guess on code it does not understand.
+class BoundaryScanner {
+public:
+  BoundaryScanner(const FormatStyle &Style, StringRef Code)
+      : Style(Style), Code(Code) {}
+
+  llvm::Optional<std::vector<Boundary>> scan() {
+    while (Pos < Code.size()) {
+      if (!scanLine())
+        return None;
+    }
+    return std::move(Boundaries);
+  }
+
+private:
+  struct Bracket {
+    char Kind;
+    unsigned Offset;
+    // Whether the bracket opens a namespace or extern block that does not add
+    // a level of indentation, so its contents are formatted as top-level code.
+    bool Transparent;
+    // Whether the bracket is a '{' following a ')' at the top level, e.g. a
+    // function body.
+    bool AfterParen;
+  };
+
+  // The state saved at #if and restored at #else and #elif.
+  struct PPState {
+    SmallVector<Bracket, 8> Brackets;
+    bool StatementComplete;
+    unsigned StatementBegin;
+    bool StatementHasEquals;
+    bool Unreachable;
+  };
+
+  void restore(const PPState &Saved) {
+    Brackets = Saved.Brackets;
+    StatementComplete = Saved.StatementComplete;
+    StatementBegin = Saved.StatementBegin;
+    StatementHasEquals = Saved.StatementHasEquals;
+    Unreachable = Saved.Unreachable;
+  }
+
+  bool atTopLevel() const {
+    return Brackets.empty() || Brackets.back().Transparent;
+  }
+
+  unsigned scope() const {
+    return Brackets.empty() ? NoScope : Brackets.back().Offset;
+  }
+
+  unsigned ppScope() const {
+    return PPScopes.empty() ? NoScope : PPScopes.back();
+  }
+
+  char peek(unsigned Offset = 0) const {
+    return Pos + Offset < Code.size() ? Code[Pos + Offset] : '\0';
+  }
+
+  void sawCode(unsigned End) {
+    PrevCodeEnd = End;
+    SawEmptyLine = false;
+  }
+
+  // Scans one line, starting at its first character. Returns false if the
+  // code cannot be scanned reliably.
+  bool scanLine() {
+    unsigned LineBegin = Pos;
+    while (peek() == ' ' || peek() == '\t' || peek() == '\r' ||
+           peek() == '\f' || peek() == '\v')
+      ++Pos;
+    if (Pos == Code.size())
+      return true;
+    if (peek() == '\n') {
+      SawEmptyLine = true;
+      ++Pos;
+      return true;
+    }
+
+    char First = peek();
+    bool StartsComment = First == '/' && (peek(1) == '/' || peek(1) == '*');
+    if (Pos == LineBegin && SawEmptyLine && StatementComplete &&
+        !FormattingOff && !Unreachable && atTopLevel() &&
+        (isLetter(First) || First == '_' || First == '#' || StartsComment))
+      Boundaries.push_back({LineBegin, PrevCodeEnd, scope(), ppScope()});
+
+    if (First == '#')
+      return scanPPDirective();
+    return scanCode();
+  }
+
+  StringRef scanPPToken() {
+    while (peek() == ' ' || peek() == '\t')
+      ++Pos;
+    unsigned Begin = Pos;
+    while (isIdentifierBody(peek(), /*AllowDollar=*/true))
+      ++Pos;
+    return Code.slice(Begin, Pos);
+  }
+
+  // Scans a preprocessor directive, including its continuation lines. Braces
+  // in directives do not affect the code around them.
+  bool scanPPDirective() {
+    unsigned Hash = Pos++;
+    StringRef Name = scanPPToken();
+    if (Name == "if" || Name == "ifdef" || Name == "ifndef") {
+      PPStack.push_back({Brackets, StatementComplete, StatementBegin,
+                         StatementHasEquals, Unreachable});
+      PPScopes.push_back(Hash);
+      // UnwrappedLineParser::parsePPIf leaves these branches unformatted, but
+      // a region starting inside one would lose the #if and format them.
+      StringRef Condition = scanPPToken();
+      if ((Name == "if" && (Condition == "0" || Condition == "false")) ||
+          (Name == "ifdef" && Condition == "SWIG"))
+        Unreachable = true;
+    } else if (Name == "else" || Name == "elif") {
+      if (PPStack.empty())
+        return false;
+      restore(PPStack.back());
+      PPScopes.back() = Hash;
+    } else if (Name == "endif") {
+      if (PPStack.empty())
+        return false;
+      // Brackets in an unreachable branch are not seen by the formatter.
+      if (Unreachable)
+        restore(PPStack.back());
+      PPStack.pop_back();
+      PPScopes.pop_back();
+    }
+    sawCode(Pos);
+
+    while (Pos < Code.size()) {
+      char C = peek();
+      if (C == '\n')
+        break;
+      if (C == '\\' &&
+          (peek(1) == '\n' || (peek(1) == '\r' && peek(2) == '\n'))) {
+        Pos += peek(1) == '\r' ? 3 : 2;
+        continue;
+      }
+      if (C == '/' && peek(1) == '*') {
+        if (!skipBlockComment())
+          return false;
+        continue;
+      }
+      if (C == '/' && peek(1) == '/') {
+        skipLineComment();
+        break;
+      }
+      if (C == '"' || C == '\'') {
+        skipQuoted(C);
+        continue;
+      }
+      if (!isWhitespace(C))
+        sawCode(Pos + 1);
+      ++Pos;
+    }
+    if (peek() == '\n')
+      ++Pos;
+    return true;
+  }
+
+  // Scans the rest of a line of code, and any lines spanned by comments or
+  // literals that start on it.
+  bool scanCode() {
+    while (Pos < Code.size()) {
+      char C = peek();
+      if (C == '\n') {
+        ++Pos;
+        return true;
+      }
+      if (isWhitespace(C)) {
+        ++Pos;
+        continue;
+      }
+      if (C == '/' && peek(1) == '/') {
+        skipLineComment();
+        continue;
+      }
+      if (C == '/' && peek(1) == '*') {
+        if (!skipBlockComment())
+          return false;
+        continue;
+      }
+      if (!handleCodeChar())
+        return false;
+    }
+    return true;
+  }
+
+  void skipLineComment() {
+    unsigned Begin = Pos;
+    while (Pos < Code.size() && peek() != '\n') {
+      // A backslash at the end of a line comment continues it on the next
+      // line.
+      if (peek() == '\\' && peek(1) == '\n')
+        ++Pos;
+      ++Pos;
+    }
+    StringRef Text = Code.slice(Begin, Pos).rtrim();
+    checkFormattingToggle(Text);
+    sawCode(Begin + Text.size());
+  }
+
+  bool skipBlockComment() {
+    unsigned Begin = Pos;
+    size_t End = Code.find("*/", Pos + 2);
+    if (End == StringRef::npos)
+      return false;
+    Pos = End + 2;
+    checkFormattingToggle(Code.slice(Begin, Pos));
+    sawCode(Pos);
+    return true;
+  }
+
+  void checkFormattingToggle(StringRef Comment) {
+    if (Comment == "// clang-format off" || Comment == "/* clang-format off */")
+      FormattingOff = true;
+    else if (Comment == "// clang-format on" ||
+             Comment == "/* clang-format on */")
+      FormattingOff = false;
+  }
+
+  // Skips a string or character literal, which ends at the matching quote or,
+  // if unterminated, at the end of the line.
+  void skipQuoted(char Quote) {
+    ++Pos;
+    while (Pos < Code.size() && peek() != Quote && peek() != '\n') {
+      if (peek() == '\\')
+        ++Pos;
+      ++Pos;
+    }
+    if (peek() == Quote)
+      ++Pos;
+    sawCode(Pos);
+  }
+
+  // Skips a raw string literal starting at the opening quote. Returns false if
+  // it is not well-formed.
+  bool skipRawString() {
+    unsigned DelimiterBegin = Pos + 1;
+    size_t Paren = Code.find('(', DelimiterBegin);
+    if (Paren == StringRef::npos || Paren - DelimiterBegin > 16)
+      return false;
+    StringRef Delimiter = Code.slice(DelimiterBegin, Paren);
+    if (Delimiter.find_first_of(" \t\n\\)\"") != StringRef::npos)
+      return false;
+    std::string Terminator = (")" + Delimiter + "\"").str();
+    size_t End = Code.find(Terminator, Paren + 1);
+    if (End == StringRef::npos)
+      return false;
+    Pos = End + Terminator.size();
+    sawCode(Pos);
+    return true;
+  }
+
+  void beginStatementPart(unsigned Offset) {
+    if (!atTopLevel())
+      return;
+    if (StatementComplete) {
+      StatementComplete = false;
+      StatementBegin = Offset;
+      StatementHasEquals = false;
+    }
+  }
+
+  void completeStatement() {
+    StatementComplete = true;
+    StatementHasEquals = false;
+  }
+
+  bool isTransparentBrace(unsigned Brace) const {
+    StringRef Head = Code.slice(StatementBegin, Brace).trim();
+    if (Head.startswith("extern") && (Head.endswith("\"C\"") ||
+                                      Head.endswith("\"C++\"")))
+      return !Style.BraceWrapping.AfterExternBlock;
+    if (Head.consume_front("inline"))
+      Head = Head.ltrim();
+    if (!Head.consume_front("namespace") ||
+        (!Head.empty() && isIdentifierBody(Head.front())))
+      return false;
+    if (Head.find_first_of("()=") != StringRef::npos)
+      return false;
+    if (Style.NamespaceIndentation == FormatStyle::NI_None)
+      return true;
+    if (Style.NamespaceIndentation == FormatStyle::NI_Inner)
+      return Brackets.empty();
+    return false;
+  }
+
+  bool handleCodeChar() {
+    char C = peek();
+    unsigned Offset = Pos;
+    beginStatementPart(Offset);
+
+    if (C == '"' || C == '\'') {
+      skipQuoted(C);
+      LastCodeChar = C;
+      return true;
+    }
+    if (isDigit(C) || (C == '.' && isDigit(peek(1)))) {
+      // Consume a whole pp-number, so digit separators are not mistaken for
+      // character literals.
+      ++Pos;
+      while (Pos < Code.size()) {
+        char N = peek();
+        if ((N == '+' || N == '-') &&
+            (Code[Pos - 1] == 'e' || Code[Pos - 1] == 'E' ||
+             Code[Pos - 1] == 'p' || Code[Pos - 1] == 'P')) {
+          ++Pos;
+          continue;
+        }
+        if (N == '\'' && isAlphanumeric(peek(1))) {
+          Pos += 2;
+          continue;
+        }
+        if (!isIdentifierBody(N, /*AllowDollar=*/true) && N != '.')
+          break;
+        ++Pos;
+      }
+      sawCode(Pos);
+      LastCodeChar = '0';
+      return true;
+    }
+    if (isIdentifierBody(C, /*AllowDollar=*/true)) {
+      while (isIdentifierBody(peek(), /*AllowDollar=*/true))
+        ++Pos;
+      StringRef Identifier = Code.slice(Offset, Pos);
+      sawCode(Pos);
+      LastCodeChar = 'a';
+      if (peek() == '"' && (Identifier == "R" || Identifier == "u8R" ||
+                            Identifier == "uR" || Identifier == "UR" ||
+                            Identifier == "LR"))
+        return skipRawString();
+      return true;
+    }
+
+    ++Pos;
+    sawCode(Pos);
+    switch (C) {
+    case '(':
+    case '[':
+      Brackets.push_back({C, Offset, false, false});
+      break;
+    case '{': {
+      bool TopLevel = atTopLevel();
+      bool Transparent = TopLevel && isTransparentBrace(Offset);
+      Brackets.push_back({C, Offset, Transparent,
+                          TopLevel && LastCodeChar == ')' &&
+                              !StatementHasEquals});
+      if (Transparent)
+        completeStatement();
+      break;
+    }
+    case ')':
+    case ']':
+    case '}': {
+      char Open = C == ')' ? '(' : C == ']' ? '[' : '{';
+      if (Brackets.empty() || Brackets.back().Kind != Open)
+        return false;
+      Bracket Closed = Brackets.back();
+      Brackets.pop_back();
+      if (atTopLevel() && (Closed.Transparent || Closed.AfterParen))
+        completeStatement();
+      break;
+    }
+    case ';':
+      if (atTopLevel())
+        completeStatement();
+      break;
+    case '=':
+      if (atTopLevel() && !StatementComplete && LastCodeChar != '=' &&
+          LastCodeChar != '<' && LastCodeChar != '>' && LastCodeChar != '!' &&
+          peek() != '=')
+        StatementHasEquals = true;
+      break;
+    default:
+      break;
+    }
+    LastCodeChar = C;
+    return true;
+  }
+
+  const FormatStyle &Style;
+  StringRef Code;
+  unsigned Pos = 0;
+
+  std::vector<Boundary> Boundaries;
+  SmallVector<Bracket, 8> Brackets;
+  SmallVector<PPState, 4> PPStack;
+  SmallVector<unsigned, 4> PPScopes;
+
+  unsigned PrevCodeEnd = 0;
+  bool SawEmptyLine = true;
+  bool FormattingOff = false;
+  // Whether the scanner is in a preprocessor branch that is not formatted.
+  bool Unreachable = false;
+  bool StatementComplete = true;
+  unsigned StatementBegin = 0;
+  bool StatementHasEquals = false;
+  char LastCodeChar = '\0';
+};
+
+} // end anonymous namespace
+
+llvm::Optional<FormattingRegion>
+findFormattingRegion(const FormatStyle &Style, StringRef Code,
+                     ArrayRef<tooling::Range> Ranges) {
+  // Options that derive the style from the whole file, and options that make
+  // formatting of a line depend on lines far away from it, cannot be honored
+  // for a part of the file.
+  if (Style.Language != FormatStyle::LK_Cpp || Style.DisableFormat ||
+      Style.DerivePointerAlignment || Style.Standard == FormatStyle::LS_Auto ||
+      Style.ExperimentalAutoDetectBinPacking || Style.CompactNamespaces ||
+      Style.IndentPPDirectives != FormatStyle::PPDIS_None || Ranges.empty())
+    return None;
+
+  unsigned Begin = Ranges.front().getOffset();
+  unsigned End = 0;
+  for (const tooling::Range &R : Ranges) {
+    Begin = std::min(Begin, R.getOffset());
+    End = std::max(End, R.getOffset() + R.getLength());
+  }
+  if (End > Code.size())
+    return None;
+
+  auto Boundaries = BoundaryScanner(Style, Code).scan();
+  if (!Boundaries)
+    return None;
+
+  // The region starts after the last declaration that ends before the ranges,
+  // so that none of its tokens and none of the empty lines after it are
+  // affected. Likewise, it ends before the empty lines after the last
+  // declaration that the ranges touch.
+  auto I = Boundaries->begin(), E = Boundaries->end();
+  const Boundary *Start = nullptr;
+  for (; I != E && I->PrevCodeEnd < Begin; ++I)
+    Start = &*I;
+  unsigned Offset = Start ? Start->PrevCodeEnd : 0;
+  unsigned Scope = Start ? Start->Scope : NoScope;
+  unsigned PPScope = Start ? Start->PPScope : NoScope;
+
+  unsigned RegionEnd = Code.size();
+  for (; I != E; ++I) {
+    if (I->PrevCodeEnd > End && I->Scope == Scope && I->PPScope == PPScope) {
+      RegionEnd = I->PrevCodeEnd;
+      break;
+    }
+  }
+  // Without an end boundary in the same scope the region would end inside an
+  // unterminated namespace or preprocessor conditional.
+  if (I == E && (Scope != NoScope || PPScope != NoScope))
+    return None;
+  if (Offset == 0 && RegionEnd == Code.size())
+    return None;
+
+  LLVM_DEBUG(llvm::dbgs() << "Formatting region [" << Offset << ", "
+                          << RegionEnd << ") of " << Code.size()
+                          << " bytes\n");
+  unsigned LinesBefore = Code.take_front(Offset).count('\n');
+  return FormattingRegion{Offset, RegionEnd - Offset, LinesBefore};
+}
+
+} // namespace internal
+} // namespace format
+} // namespace clang
@@ -0,0 +1,54 @@
+//===--- IncrementalFormat.h - Format Code Incrementally --------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file declares findFormattingRegion, which finds a part of a file that
+/// can be formatted on its own, without lexing and parsing the whole file.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_LIB_FORMAT_INCREMENTALFORMAT_H
+#define LLVM_CLANG_LIB_FORMAT_INCREMENTALFORMAT_H
+
+#include "clang/Format/Format.h"
+#include "llvm/ADT/Optional.h"
+
+namespace clang {
+namespace format {
+namespace internal {
+
+/// A part of a file that starts and ends between two top-level declarations.
+struct FormattingRegion {
+  /// Offset of the first character of the region in the file.
+  unsigned Offset;
+  /// Length of the region.
+  unsigned Length;
+  /// The number of lines of the file before the region.
+  unsigned LinesBefore;
+};
+
+/// Finds a region of \p Code that encloses all \p Ranges and formats exactly
+/// like it would as part of the whole file.
+///
+/// The region starts right after the end of a top-level declaration and
+/// includes the empty lines separating it from the next one, and ends at the
+/// end of a top-level declaration followed by an empty line. Code surrounding
+/// the region is scanned for comments, literals, preprocessor conditionals,
+/// brackets and namespaces, but not lexed or parsed.
+///
+/// Returns \c None if the region would be the whole file, or if no such region
+/// can be found, e.g. for languages other than C++.
+llvm::Optional<FormattingRegion>
+findFormattingRegion(const FormatStyle &Style, StringRef Code,
+                     ArrayRef<tooling::Range> Ranges);
+
+} // namespace internal
+} // namespace format
+} // namespace clang
+
+#endif
@@ -831,9 +831,9 @@ bool CompilerInstance::InitializeSourceManager(
   if (Input.isBuffer()) {
     SourceMgr.setMainFileID(SourceMgr.createFileID(SourceManager::Unowned,
                                                    Input.getBuffer(), Kind));
-    assert(SourceMgr.getMainFileID().isValid() &&
-           "Couldn't establish MainFileID!");
-    return true;
+    // The FileID is invalid if the buffer doesn't fit in the source location
+    // space, which has been diagnosed.
+    return SourceMgr.getMainFileID().isValid();
   }
 
   StringRef InputFile = Input.getFile();
@@ -889,9 +889,9 @@ bool CompilerInstance::InitializeSourceManager(
     SourceMgr.overrideFileContents(File, std::move(SB));
   }
 
-  assert(SourceMgr.getMainFileID().isValid() &&
-         "Couldn't establish MainFileID!");
-  return true;
+  // The FileID is invalid if the file doesn't fit in the source location
+  // space, which has been diagnosed.
+  return SourceMgr.getMainFileID().isValid();
 }
 
 // High-Level Operations
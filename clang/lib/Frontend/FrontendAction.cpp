@@ -783,7 +783,8 @@ bool FrontendAction::BeginSourceFile(CompilerInstance &CI,
       auto Kind = CurrentModule->IsSystem ? SrcMgr::C_System : SrcMgr::C_User;
       auto &SourceMgr = CI.getSourceManager();
       auto BufferID = SourceMgr.createFileID(std::move(Buffer), Kind);
-      assert(BufferID.isValid() && "couldn't creaate module buffer ID");
+      if (BufferID.isInvalid())
+        goto failure; // Out of source locations, which has been diagnosed.
       SourceMgr.setMainFileID(BufferID);
     }
   }
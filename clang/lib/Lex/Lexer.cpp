@@ -30,15 +30,18 @@
 #include "llvm/ADT/None.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/ConvertUTF.h"
+#include "llvm/Support/Host.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/NativeFormatting.h"
 #include "llvm/Support/UnicodeCharRanges.h"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -47,6 +50,31 @@
 #include <tuple>
 #include <utility>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#elif __ALTIVEC__
+#include <altivec.h>
+#undef bool
+#endif
+
+// The SSE4.2 identifier scan is compiled on all x86 hosts. Unless the build
+// already targets SSE4.2, it is only used after checking the CPU at runtime.
+#if defined(__SSE4_2__) ||                                                     \
+    (defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))) ||       \
+    (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+#define CLANG_LEXER_HAVE_SSE42 1
+#include <nmmintrin.h>
+#endif
+
+// GCC and clang, including clang-cl, only allow SSE4.2 intrinsics in functions
+// that target it. MSVC allows them anywhere.
+#if defined(CLANG_LEXER_HAVE_SSE42) && !defined(__SSE4_2__) &&                 \
+    (defined(__GNUC__) || defined(__clang__))
+#define CLANG_LEXER_TARGET_SSE42 __attribute__((target("sse4.2")))
+#else
+#define CLANG_LEXER_TARGET_SSE42
+#endif
+
 using namespace clang;
 
 //===----------------------------------------------------------------------===//
@@ -208,6 +236,10 @@ Lexer *Lexer::Create_PragmaLexer(SourceLocation SpellingLoc,
   L->FileLoc = SM.createExpansionLoc(SM.getLocForStartOfFile(SpellingFID),
                                      ExpansionLocStart,
                                      ExpansionLocEnd, TokLen);
+  // If the source location space is exhausted, lex from the scratch buffer
+  // without remapping.
+  if (L->FileLoc.isInvalid())
+    L->FileLoc = SM.getLocForStartOfFile(SpellingFID);
 
   // Ensure that the lexer thinks it is inside a directive, so that end \n will
   // return an EOD token.
@@ -1118,7 +1150,10 @@ static SourceLocation GetMappedTokenLoc(Preprocessor &PP,
   // original _Pragma(...) sequence.
   CharSourceRange II = SM.getImmediateExpansionRange(FileLoc);
 
-  return SM.createExpansionLoc(SpellingLoc, II.getBegin(), II.getEnd(), TokLen);
+  // If the source location space is exhausted, use the spelling location.
+  SourceLocation Loc =
+      SM.createExpansionLoc(SpellingLoc, II.getBegin(), II.getEnd(), TokLen);
+  return Loc.isValid() ? Loc : SpellingLoc;
 }
 
 /// getSourceLocation - Return a source location identifier for the specified
@@ -1636,9 +1671,90 @@ bool Lexer::tryConsumeIdentifierUTF8Char(const char *&CurPtr) {
   return true;
 }
 
+#ifdef CLANG_LEXER_HAVE_SSE42
+/// Skip over the longest run of [_A-Za-z0-9] characters starting at CurPtr,
+/// 16 bytes at a time.  Stops early (without consuming anything more) if
+/// fewer than 16 bytes remain in the buffer; the caller finishes the run
+/// with the scalar loop.
+CLANG_LEXER_TARGET_SSE42
+static const char *skipIdentifierBodySSE42(const char *CurPtr,
+                                           const char *BufferEnd) {
+  alignas(16) static const char AsciiIdentifierRanges[16] = {
+      '_', '_', 'A', 'Z', 'a', 'z', '0', '9',
+  };
+  const __m128i Ranges =
+      _mm_load_si128((const __m128i *)AsciiIdentifierRanges);
+
+  while (BufferEnd - CurPtr >= 16) {
+    __m128i Bytes = _mm_loadu_si128((const __m128i *)CurPtr);
+    // Index of the first byte outside of the ranges.  The implicit length
+    // semantics of pcmpistri also stop at a nul byte, which keeps us from
+    // running over a code-completion point.
+    int Consumed = _mm_cmpistri(Ranges, Bytes,
+                                _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES |
+                                    _SIDD_NEGATIVE_POLARITY |
+                                    _SIDD_LEAST_SIGNIFICANT);
+    CurPtr += Consumed;
+    if (Consumed != 16)
+      break;
+  }
+  return CurPtr;
+}
+#endif
+
+#if defined(__SSE4_2__)
+/// Skip over a prefix of the run of [_A-Za-z0-9] characters starting at
+/// CurPtr with vector instructions.  The caller finishes the run with the
+/// scalar loop.
+static const char *skipIdentifierBodyFast(const char *CurPtr,
+                                          const char *BufferEnd) {
+  return skipIdentifierBodySSE42(CurPtr, BufferEnd);
+}
+#elif defined(CLANG_LEXER_HAVE_SSE42)
+using SkipIdentifierBodyFn = const char *(*)(const char *, const char *);
+
+static const char *skipNoIdentifierBody(const char *CurPtr, const char *) {
+  return CurPtr;
+}
+
+static const char *resolveSkipIdentifierBody(const char *CurPtr,
+                                             const char *BufferEnd);
+
+/// The identifier scan for this CPU.  It starts out as the resolver, which
+/// queries the CPU on the first call and replaces itself, so that every later
+/// identifier only pays for an indirect call.
+static std::atomic<SkipIdentifierBodyFn> SkipIdentifierBody{
+    resolveSkipIdentifierBody};
+
+static const char *resolveSkipIdentifierBody(const char *CurPtr,
+                                             const char *BufferEnd) {
+  llvm::StringMap<bool> Features;
+  SkipIdentifierBodyFn Skip =
+      llvm::sys::getHostCPUFeatures(Features) && Features.lookup("sse4.2")
+          ? skipIdentifierBodySSE42
+          : skipNoIdentifierBody;
+  SkipIdentifierBody.store(Skip, std::memory_order_relaxed);
+  return Skip(CurPtr, BufferEnd);
+}
+
+/// Skip over a prefix of the run of [_A-Za-z0-9] characters starting at
+/// CurPtr with vector instructions, if the CPU has them.  The caller finishes
+/// the run with the scalar loop.
+static const char *skipIdentifierBodyFast(const char *CurPtr,
+                                          const char *BufferEnd) {
+  return SkipIdentifierBody.load(std::memory_order_relaxed)(CurPtr, BufferEnd);
+}
+#else
+static const char *skipIdentifierBodyFast(const char *CurPtr,
+                                          const char *BufferEnd) {
+  return CurPtr;
+}
+#endif
+
 bool Lexer::LexIdentifier(Token &Result, const char *CurPtr) {
   // Match [_A-Za-z0-9]*, we have already matched [_A-Za-z$]
   unsigned Size;
+  CurPtr = skipIdentifierBodyFast(CurPtr, BufferEnd);
   unsigned char C = *CurPtr++;
   while (isIdentifierBody(C))
     C = *CurPtr++;
@@ -1901,6 +2017,38 @@ const char *Lexer::LexUDSuffix(Token &Result, const char *CurPtr,
   return CurPtr;
 }
 
+/// Skip over characters of a string literal body that need no special
+/// handling, 16 bytes at a time.  Stops at the first '"', '\\', '?' (possible
+/// trigraph), newline or nul, or when fewer than 16 bytes remain.
+static const char *skipPlainStringCharsFast(const char *CurPtr,
+                                            const char *BufferEnd) {
+#ifdef __SSE2__
+  const __m128i Quotes = _mm_set1_epi8('"');
+  const __m128i Backslashes = _mm_set1_epi8('\\');
+  const __m128i Questions = _mm_set1_epi8('?');
+  const __m128i Newlines = _mm_set1_epi8('\n');
+  const __m128i Returns = _mm_set1_epi8('\r');
+  const __m128i Zeros = _mm_setzero_si128();
+
+  while (BufferEnd - CurPtr >= 16) {
+    __m128i Bytes = _mm_loadu_si128((const __m128i *)CurPtr);
+    __m128i Special = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(Bytes, Quotes),
+                     _mm_cmpeq_epi8(Bytes, Backslashes)),
+        _mm_or_si128(_mm_cmpeq_epi8(Bytes, Questions),
+                     _mm_cmpeq_epi8(Bytes, Newlines)));
+    Special = _mm_or_si128(Special,
+                           _mm_or_si128(_mm_cmpeq_epi8(Bytes, Returns),
+                                        _mm_cmpeq_epi8(Bytes, Zeros)));
+    unsigned Mask = _mm_movemask_epi8(Special);
+    if (Mask != 0)
+      return CurPtr + llvm::countTrailingZeros(Mask);
+    CurPtr += 16;
+  }
+#endif
+  return CurPtr;
+}
+
 /// LexStringLiteral - Lex the remainder of a string literal, after having lexed
 /// either " or L" or u8" or u" or U".
 bool Lexer::LexStringLiteral(Token &Result, const char *CurPtr,
@@ -1945,6 +2093,7 @@ bool Lexer::LexStringLiteral(Token &Result, const char *CurPtr,
 
       NulCharacter = CurPtr-1;
     }
+    CurPtr = skipPlainStringCharsFast(CurPtr, BufferEnd);
     C = getAndAdvanceChar(CurPtr, Result);
   }
 
@@ -2180,6 +2329,26 @@ bool Lexer::LexCharConstant(Token &Result, const char *CurPtr,
   return true;
 }
 
+/// Skip over a run of spaces and tabs, 16 bytes at a time.  Deeply indented
+/// code has long runs of these.  Stops at the first other character, or when
+/// fewer than 16 bytes remain in the buffer.
+static const char *skipBlanksFast(const char *CurPtr, const char *BufferEnd) {
+#ifdef __SSE2__
+  const __m128i Spaces = _mm_set1_epi8(' ');
+  const __m128i Tabs = _mm_set1_epi8('\t');
+
+  while (BufferEnd - CurPtr >= 16) {
+    __m128i Bytes = _mm_loadu_si128((const __m128i *)CurPtr);
+    unsigned Mask = _mm_movemask_epi8(_mm_or_si128(
+        _mm_cmpeq_epi8(Bytes, Spaces), _mm_cmpeq_epi8(Bytes, Tabs)));
+    if (Mask != 0xFFFF)
+      return CurPtr + llvm::countTrailingOnes(Mask);
+    CurPtr += 16;
+  }
+#endif
+  return CurPtr;
+}
+
 /// SkipWhitespace - Efficiently skip over a series of whitespace characters.
 /// Update BufferPtr to point to the next non-whitespace character and return.
 ///
@@ -2193,6 +2362,13 @@ bool Lexer::SkipWhitespace(Token &Result, const char *CurPtr,
 
   // Skip consecutive spaces efficiently.
   while (true) {
+    // Only use the wide scan when there are at least two blanks in a row so
+    // the common single space between tokens stays on the scalar path.
+    if (isHorizontalWhitespace(Char) && isHorizontalWhitespace(CurPtr[1])) {
+      CurPtr = skipBlanksFast(CurPtr, BufferEnd);
+      Char = *CurPtr;
+    }
+
     // Skip horizontal whitespace very aggressively.
     while (isHorizontalWhitespace(Char))
       Char = *++CurPtr;
@@ -2470,13 +2646,6 @@ static bool isEndOfBlockCommentWithEscapedNewLine(const char *CurPtr,
   return true;
 }
 
-#ifdef __SSE2__
-#include <emmintrin.h>
-#elif __ALTIVEC__
-#include <altivec.h>
-#undef bool
-#endif
-
 /// We have just read from input the / and * characters that started a comment.
 /// Read until we find the * and / characters that terminate the comment.
 /// Note that we don't bother decoding trigraphs or escaped newlines in block
@@ -3183,6 +3352,8 @@ LexNextToken:
   // Small amounts of horizontal whitespace is very common between tokens.
   if ((*CurPtr == ' ') || (*CurPtr == '\t')) {
     ++CurPtr;
+    if ((*CurPtr == ' ') || (*CurPtr == '\t'))
+      CurPtr = skipBlanksFast(CurPtr, BufferEnd);
     while ((*CurPtr == ' ') || (*CurPtr == '\t'))
       ++CurPtr;
 
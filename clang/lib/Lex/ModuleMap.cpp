@@ -2976,6 +2976,9 @@ bool ModuleMap::parseModuleMapFile(const FileEntry *File, bool IsSystem,
     auto FileCharacter =
         IsSystem ? SrcMgr::C_System_ModuleMap : SrcMgr::C_User_ModuleMap;
     ID = SourceMgr.createFileID(File, ExternModuleLoc, FileCharacter);
+    // Out of source locations, which has been diagnosed.
+    if (ID.isInvalid())
+      return ParsedModuleMap[File] = true;
   }
 
   assert(Target && "Missing target information");
@@ -2165,7 +2165,18 @@ Preprocessor::ImportAction Preprocessor::HandleHeaderIncludeOrImport(
   if (IncludePos.isMacroID())
     IncludePos = SourceMgr.getExpansionRange(IncludePos).getEnd();
   FileID FID = SourceMgr.createFileID(*File, IncludePos, FileCharacter);
-  assert(FID.isValid() && "Expected valid file ID");
+  if (FID.isInvalid()) {
+    // The source location address space is exhausted, which has been
+    // diagnosed as a fatal error. Abort parsing, as for a fatal failure in
+    // the module loader.
+    TheModuleLoader.HadFatalFailure = true;
+    Token &Result = IncludeTok;
+    assert(CurLexer && "#include but no current lexer set!");
+    Result.startToken();
+    CurLexer->FormTokenWithChars(Result, CurLexer->BufferEnd, tok::eof);
+    CurLexer->cutOffLexing();
+    return {ImportAction::None};
+  }
 
   // If all is good, enter the new file!
   if (EnterSourceFile(FID, CurDir, FilenameTok.getLocation()))
@@ -598,7 +598,9 @@ bool Preprocessor::HandleMacroExpandedIdentifier(Token &Identifier,
     SourceLocation Loc =
       SourceMgr.createExpansionLoc(Identifier.getLocation(), ExpandLoc,
                                    ExpansionEnd,Identifier.getLength());
-    Identifier.setLocation(Loc);
+    // If the source location space is exhausted, keep the spelling location.
+    if (Loc.isValid())
+      Identifier.setLocation(Loc);
 
     // If this is a disabled macro or #define X X, we must mark the result as
     // unexpandable.
@@ -317,6 +317,11 @@ void Preprocessor::Handle_Pragma(Token &Tok) {
   CreateString(StrVal, TmpTok);
   SourceLocation TokLoc = TmpTok.getLocation();
 
+  // The pragma text has no location if the source location space is
+  // exhausted, which has been diagnosed as a fatal error. Skip the pragma.
+  if (TokLoc.isInvalid())
+    return Lex(Tok);
+
   // Make and enter a lexer object so that we lex and expand the tokens just
   // like any others.
   Lexer *TL = Lexer::Create_PragmaLexer(TokLoc, PragmaLoc, RParenLoc,
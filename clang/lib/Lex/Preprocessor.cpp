@@ -490,6 +490,8 @@ void Preprocessor::CreateString(StringRef Str, Token &Tok,
   const char *DestPtr;
   SourceLocation Loc = ScratchBuf->getToken(Str.data(), Str.size(), DestPtr);
 
+  // Loc is invalid if the source location space is exhausted, and then so is
+  // the expansion location.
   if (ExpansionLocStart.isValid())
     Loc = SourceMgr.createExpansionLoc(Loc, ExpansionLocStart,
                                        ExpansionLocEnd, Str.size());
@@ -561,7 +563,8 @@ void Preprocessor::EnterMainSourceFile() {
     llvm::MemoryBuffer::getMemBufferCopy(Predefines, "<built-in>");
   assert(SB && "Cannot create predefined source buffer");
   FileID FID = SourceMgr.createFileID(std::move(SB));
-  assert(FID.isValid() && "Could not create FileID for predefines?");
+  if (FID.isInvalid())
+    return; // The source location space is exhausted, a fatal error.
   setPredefinesFileID(FID);
 
   // Start parsing the predefines.
@@ -582,8 +585,11 @@ void Preprocessor::EnterMainSourceFile() {
           << PPOpts->PCHThroughHeader;
       return;
     }
-    setPCHThroughHeaderFileID(
-        SourceMgr.createFileID(*File, SourceLocation(), SrcMgr::C_User));
+    FileID ThroughHeaderFID =
+        SourceMgr.createFileID(*File, SourceLocation(), SrcMgr::C_User);
+    if (ThroughHeaderFID.isInvalid())
+      return; // The source location space is exhausted, a fatal error.
+    setPCHThroughHeaderFileID(ThroughHeaderFID);
   }
 
   // Skip tokens from the Predefines and if needed the main file.
@@ -34,7 +34,7 @@ SourceLocation ScratchBuffer::getToken(const char *Buf, unsigned Len,
                                        const char *&DestPtr) {
   if (BytesUsed+Len+2 > ScratchBufSize)
     AllocScratchBuffer(Len+2);
-  else {
+  else if (BufferStartLoc.isValid()) {
     // Clear out the source line cache if it's already been computed.
     // FIXME: Allow this to be incrementally extended.
     auto *ContentCache = const_cast<SrcMgr::ContentCache *>(
@@ -61,6 +61,9 @@ SourceLocation ScratchBuffer::getToken(const char *Buf, unsigned Len,
   // diagnostic points to one.
   CurBuffer[BytesUsed-1] = '\0';
 
+  // The buffer has no location if the source location space is exhausted.
+  if (BufferStartLoc.isInvalid())
+    return SourceLocation();
   return BufferStartLoc.getLocWithOffset(BytesUsed-Len-1);
 }
 
@@ -669,8 +669,10 @@ bool TokenLexer::Lex(Token &Tok) {
   // need this information to compute the spelling of the token, but any
   // diagnostics for the expanded token should appear as if they came from
   // ExpansionLoc.  Pull this information together into a new SourceLocation
-  // that captures all of this.
+  // that captures all of this. Once the source location space is exhausted,
+  // tokens keep the locations they have.
   if (ExpandLocStart.isValid() &&   // Don't do this for token streams.
+      !SM.hasRunOutOfSLocSpace() &&
       // Check that the token's location was not already set properly.
       SM.isBeforeInSLocAddrSpace(Tok.getLocation(), MacroStartSLocOffset)) {
     SourceLocation instLoc;
@@ -683,7 +685,8 @@ bool TokenLexer::Lex(Token &Tok) {
       instLoc = getExpansionLocForMacroDefLoc(Tok.getLocation());
     }
 
-    Tok.setLocation(instLoc);
+    if (instLoc.isValid())
+      Tok.setLocation(instLoc);
   }
 
   // If this is the first token, set the lexical properties of the token to
@@ -897,19 +900,25 @@ bool TokenLexer::pasteTokens(Token &LHSTok, ArrayRef<Token> TokenStream,
   // diagnostics for the expanded token should appear as if the token was
   // expanded from the full ## expression. Pull this information together into
   // a new SourceLocation that captures all of this.
+  // Once the source location space is exhausted, the pasted token keeps its
+  // spelling location.
   SourceManager &SM = PP.getSourceManager();
-  if (StartLoc.isFileID())
-    StartLoc = getExpansionLocForMacroDefLoc(StartLoc);
-  if (EndLoc.isFileID())
-    EndLoc = getExpansionLocForMacroDefLoc(EndLoc);
-  FileID MacroFID = SM.getFileID(MacroExpansionStart);
-  while (SM.getFileID(StartLoc) != MacroFID)
-    StartLoc = SM.getImmediateExpansionRange(StartLoc).getBegin();
-  while (SM.getFileID(EndLoc) != MacroFID)
-    EndLoc = SM.getImmediateExpansionRange(EndLoc).getEnd();
-
-  LHSTok.setLocation(SM.createExpansionLoc(LHSTok.getLocation(), StartLoc, EndLoc,
-                                        LHSTok.getLength()));
+  if (!SM.hasRunOutOfSLocSpace()) {
+    if (StartLoc.isFileID())
+      StartLoc = getExpansionLocForMacroDefLoc(StartLoc);
+    if (EndLoc.isFileID())
+      EndLoc = getExpansionLocForMacroDefLoc(EndLoc);
+    FileID MacroFID = SM.getFileID(MacroExpansionStart);
+    while (SM.getFileID(StartLoc) != MacroFID)
+      StartLoc = SM.getImmediateExpansionRange(StartLoc).getBegin();
+    while (SM.getFileID(EndLoc) != MacroFID)
+      EndLoc = SM.getImmediateExpansionRange(EndLoc).getEnd();
+
+    SourceLocation Loc = SM.createExpansionLoc(LHSTok.getLocation(), StartLoc,
+                                               EndLoc, LHSTok.getLength());
+    if (Loc.isValid())
+      LHSTok.setLocation(Loc);
+  }
 
   // Now that we got the result token, it will be subject to expansion.  Since
   // token pasting re-lexes the result token in raw mode, identifier information
@@ -960,12 +969,14 @@ void TokenLexer::HandleMicrosoftCommentPaste(Token &Tok, SourceLocation OpLoc) {
 /// If \arg loc is a file ID and points inside the current macro
 /// definition, returns the appropriate source location pointing at the
 /// macro expansion source location entry, otherwise it returns an invalid
-/// SourceLocation.
+/// SourceLocation. The result is also invalid if the source location space
+/// ran out before the macro expansion source location entry was created.
 SourceLocation
 TokenLexer::getExpansionLocForMacroDefLoc(SourceLocation loc) const {
-  assert(ExpandLocStart.isValid() && MacroExpansionStart.isValid() &&
-         "Not appropriate for token streams");
+  assert(ExpandLocStart.isValid() && "Not appropriate for token streams");
   assert(loc.isValid() && loc.isFileID());
+  if (MacroExpansionStart.isInvalid())
+    return SourceLocation();
 
   SourceManager &SM = PP.getSourceManager();
   assert(SM.isInSLocAddrSpace(loc, MacroDefStart, MacroDefLength) &&
@@ -993,6 +1004,7 @@ static void updateConsecutiveMacroArgTokens(SourceManager &SM,
 
   SourceLocation FirstLoc = begin_tokens->getLocation();
   SourceLocation CurLoc = FirstLoc;
+  unsigned CurLen = begin_tokens->getLength();
 
   // Compare the source location offset of tokens and group together tokens that
   // are close, even if their locations point to different FileIDs. e.g.
@@ -1014,14 +1026,17 @@ static void updateConsecutiveMacroArgTokens(SourceManager &SM,
     if (!SM.isInSameSLocAddrSpace(CurLoc, NextLoc, &RelOffs))
       break; // Token from different local/loaded location.
     // Check that token is not before the previous token or more than 50
-    // "characters" away.
-    if (RelOffs < 0 || RelOffs > 50)
+    // "characters" past its end. Measuring the gap from the end keeps long
+    // tokens, e.g. string literals in generated code, from splitting the run
+    // into one SLocEntry per token.
+    if (RelOffs < 0 || RelOffs - int(CurLen) > 50)
       break;
 
     if (CurLoc.isMacroID() && !SM.isWrittenInSameFile(CurLoc, NextLoc))
       break; // Token from a different macro.
 
     CurLoc = NextLoc;
+    CurLen = NextTok->getLength();
   }
 
   // For the consecutive tokens, find the length of the SLocEntry to contain
@@ -1036,6 +1051,13 @@ static void updateConsecutiveMacroArgTokens(SourceManager &SM,
   SourceLocation Expansion =
       SM.createMacroArgExpansionLoc(FirstLoc, InstLoc,FullLength);
 
+  // If the source location space is exhausted, the tokens keep their
+  // locations.
+  if (Expansion.isInvalid()) {
+    begin_tokens = NextTok;
+    return;
+  }
+
   // Change the location of the tokens from the spelling location to the new
   // expanded location.
   for (; begin_tokens < NextTok; ++begin_tokens) {
@@ -1063,9 +1085,10 @@ void TokenLexer::updateLocForMacroArgTokens(SourceLocation ArgIdSpellLoc,
     // If there's only one token just create a SLocEntry for it.
     if (end_tokens - begin_tokens == 1) {
       Token &Tok = *begin_tokens;
-      Tok.setLocation(SM.createMacroArgExpansionLoc(Tok.getLocation(),
-                                                    InstLoc,
-                                                    Tok.getLength()));
+      SourceLocation Loc = SM.createMacroArgExpansionLoc(
+          Tok.getLocation(), InstLoc, Tok.getLength());
+      if (Loc.isValid())
+        Tok.setLocation(Loc);
       return;
     }
 
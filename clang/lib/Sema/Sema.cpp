@@ -41,6 +41,7 @@
 #include "clang/Sema/TypoCorrection.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallSet.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/TimeProfiler.h"
 
 using namespace clang;
@@ -479,6 +480,34 @@ void Sema::addExternalSource(ExternalSemaSource *E) {
 void Sema::PrintStats() const {
   llvm::errs() << "\n*** Semantic Analysis Stats:\n";
   llvm::errs() << NumSFINAEErrors << " SFINAE diagnostics trapped.\n";
+  llvm::errs() << NumAliasTemplateSubstitutionsReused
+               << " alias template specializations reused ("
+               << AliasTemplateSubstitutions.size() << " memoized).\n";
+
+  if (!TemplateInstantiationProfiles.empty()) {
+    // Report the most expensive patterns first.
+    SmallVector<std::pair<const Decl *, TemplateInstantiationProfile>, 32>
+        Profiles(TemplateInstantiationProfiles.begin(),
+                 TemplateInstantiationProfiles.end());
+    llvm::stable_sort(Profiles, [](const auto &LHS, const auto &RHS) {
+      return LHS.second.Seconds > RHS.second.Seconds;
+    });
+
+    llvm::errs() << "\n*** Template Instantiation Profile:\n";
+    llvm::errs() << "  Seconds  Count  Template (time includes nested "
+                    "instantiations)\n";
+    for (const auto &P : Profiles) {
+      std::string Name;
+      llvm::raw_string_ostream OS(Name);
+      if (const auto *ND = dyn_cast<NamedDecl>(P.first))
+        ND->getNameForDiagnostic(OS, getPrintingPolicy(), /*Qualified=*/true);
+      else
+        OS << "<unnamed>";
+      llvm::errs() << llvm::format("%9.4f %6u  ", P.second.Seconds,
+                                   P.second.NumInstantiations)
+                   << OS.str() << '\n';
+    }
+  }
 
   BumpAlloc.PrintStats();
   AnalysisWarnings.PrintStats();
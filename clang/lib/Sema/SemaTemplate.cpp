@@ -3455,6 +3455,60 @@ Sema::findFailedBooleanCondition(Expr *Cond) {
   return { FailedCond, Description };
 }
 
+static bool aliasTemplateDependsOnLookup(Sema &S,
+                                        TypeAliasTemplateDecl *AliasTemplate);
+
+namespace {
+/// Looks for the expressions in an alias template pattern whose meaning can
+/// change with the declarations visible where the alias is named: calls to
+/// functions found by argument-dependent lookup (including friends injected
+/// by instantiations in between), and operators on dependent operands.
+class LookupDependenceChecker
+    : public RecursiveASTVisitor<LookupDependenceChecker> {
+  Sema &S;
+
+  bool found() {
+    DependsOnLookup = true;
+    return false;
+  }
+
+public:
+  bool DependsOnLookup = false;
+
+  explicit LookupDependenceChecker(Sema &S) : S(S) {}
+
+  bool VisitUnresolvedLookupExpr(UnresolvedLookupExpr *) { return found(); }
+  bool VisitUnresolvedMemberExpr(UnresolvedMemberExpr *) { return found(); }
+  bool VisitCXXDependentScopeMemberExpr(CXXDependentScopeMemberExpr *) {
+    return found();
+  }
+  bool VisitUnaryOperator(UnaryOperator *E) {
+    return !E->isTypeDependent() || found();
+  }
+  bool VisitBinaryOperator(BinaryOperator *E) {
+    return !E->isTypeDependent() || found();
+  }
+
+  // Substituting into the pattern also substitutes into the aliases it names.
+  bool VisitTemplateSpecializationType(TemplateSpecializationType *T) {
+    auto *Alias = dyn_cast_or_null<TypeAliasTemplateDecl>(
+        T->getTemplateName().getAsTemplateDecl());
+    return !Alias || !aliasTemplateDependsOnLookup(S, Alias) || found();
+  }
+};
+} // end anonymous namespace
+
+static bool aliasTemplateDependsOnLookup(Sema &S,
+                                        TypeAliasTemplateDecl *AliasTemplate) {
+  auto Known = S.AliasTemplateDependsOnLookup.find(AliasTemplate);
+  if (Known != S.AliasTemplateDependsOnLookup.end())
+    return Known->second;
+  LookupDependenceChecker Checker(S);
+  Checker.TraverseType(AliasTemplate->getTemplatedDecl()->getUnderlyingType());
+  S.AliasTemplateDependsOnLookup[AliasTemplate] = Checker.DependsOnLookup;
+  return Checker.DependsOnLookup;
+}
+
 QualType Sema::CheckTemplateIdType(TemplateName Name,
                                    SourceLocation TemplateLoc,
                                    TemplateArgumentListInfo &TemplateArgs) {
@@ -3503,6 +3557,41 @@ QualType Sema::CheckTemplateIdType(TemplateName Name,
     if (Pattern->isInvalidDecl())
       return QualType();
 
+    // Naming a specialization we have already substituted into, in the same
+    // context, produces the same type; reuse it instead of substituting into
+    // the pattern again. Access checking and availability diagnostics during
+    // substitution depend on the context, and warnings are suppressed in a
+    // SFINAE context, so both are part of the key. Lookups in the pattern
+    // that happen at the point of use, and visibility with modules, can
+    // change between two uses, so don't memoize those.
+    llvm::FoldingSetNodeID SubstitutionID;
+    bool Memoize = !getLangOpts().Modules &&
+                   !DelayedDiagnostics.shouldDelayDiagnostics() &&
+                   !TemplateSpecializationType::anyDependentTemplateArguments(
+                       TemplateArgs, InstantiationDependent) &&
+                   !InstantiationDependent &&
+                   !aliasTemplateDependsOnLookup(*this, AliasTemplate);
+    if (Memoize) {
+      SubstitutionID.AddPointer(AliasTemplate->getCanonicalDecl());
+      SubstitutionID.AddPointer(CurContext);
+      SubstitutionID.AddBoolean(isSFINAEContext().hasValue());
+      for (const TemplateArgument &Arg : Converted)
+        Context.getCanonicalTemplateArgument(Arg).Profile(SubstitutionID,
+                                                          Context);
+      void *InsertPos;
+      if (AliasTemplateSubstitution *Known =
+              AliasTemplateSubstitutions.FindNodeOrInsertPos(SubstitutionID,
+                                                             InsertPos)) {
+        ++NumAliasTemplateSubstitutionsReused;
+        return Context.getTemplateSpecializationType(Name, TemplateArgs,
+                                                     Known->Type);
+      }
+    }
+    DiagnosticConsumer &Client = *Diags.getClient();
+    unsigned NumErrorsBefore = Client.getNumErrors();
+    unsigned NumWarningsBefore = Client.getNumWarnings();
+    unsigned NumSFINAEErrorsBefore = NumSFINAEErrors;
+
     TemplateArgumentList StackTemplateArgs(TemplateArgumentList::OnStack,
                                            Converted);
 
@@ -3556,6 +3645,23 @@ QualType Sema::CheckTemplateIdType(TemplateName Name,
 
       return QualType();
     }
+
+    // Only remember substitutions that produced no diagnostics at all, so
+    // that reusing them can't drop a diagnostic a later use would have seen.
+    if (Memoize && Client.getNumErrors() == NumErrorsBefore &&
+        Client.getNumWarnings() == NumWarningsBefore &&
+        NumSFINAEErrors == NumSFINAEErrorsBefore &&
+        !CanonType->isInstantiationDependentType()) {
+      // The substitution may have memoized others, so look up where to
+      // insert again.
+      void *InsertPos;
+      if (!AliasTemplateSubstitutions.FindNodeOrInsertPos(SubstitutionID,
+                                                          InsertPos))
+        AliasTemplateSubstitutions.InsertNode(
+            new (BumpAlloc) AliasTemplateSubstitution(
+                SubstitutionID.Intern(BumpAlloc), CanonType),
+            InsertPos);
+    }
   } else if (Name.isDependent() ||
              TemplateSpecializationType::anyDependentTemplateArguments(
                TemplateArgs, InstantiationDependent)) {
@@ -29,6 +29,7 @@
 #include "clang/Sema/TemplateInstCallback.h"
 #include "clang/Sema/SemaConcept.h"
 #include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/Timer.h"
 
 using namespace clang;
 using namespace sema;
@@ -502,6 +503,24 @@ bool Sema::InstantiatingTemplate::CheckInstantiationDepth(
   return true;
 }
 
+Sema::TemplateInstantiationProfileScope::TemplateInstantiationProfileScope(
+    Sema &S, const Decl *Pattern)
+    : S(S), Pattern(S.CollectStats ? Pattern : nullptr), StartTime(0) {
+  if (this->Pattern)
+    StartTime = llvm::TimeRecord::getCurrentTime(/*Start=*/true).getWallTime();
+}
+
+Sema::TemplateInstantiationProfileScope::~TemplateInstantiationProfileScope() {
+  if (!Pattern)
+    return;
+  double EndTime =
+      llvm::TimeRecord::getCurrentTime(/*Start=*/false).getWallTime();
+  TemplateInstantiationProfile &Profile =
+      S.TemplateInstantiationProfiles[Pattern->getCanonicalDecl()];
+  ++Profile.NumInstantiations;
+  Profile.Seconds += EndTime - StartTime;
+}
+
 /// Prints the current instantiation stack through a series of
 /// notes.
 void Sema::PrintInstantiationStack() {
@@ -2566,6 +2585,7 @@ Sema::InstantiateClass(SourceLocation PointOfInstantiation,
                                         /*Qualified=*/true);
     return Name;
   });
+  TemplateInstantiationProfileScope ProfileScope(*this, PatternDef);
 
   Pattern = PatternDef;
 
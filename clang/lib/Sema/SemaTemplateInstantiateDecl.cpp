@@ -4588,6 +4588,7 @@ void Sema::InstantiateFunctionDefinition(SourceLocation PointOfInstantiation,
                                    /*Qualified=*/true);
     return Name;
   });
+  TemplateInstantiationProfileScope ProfileScope(*this, PatternDecl);
 
   // If we're performing recursive template instantiation, create our own
   // queue of pending implicit instantiations that we will instantiate later,
@@ -46,7 +46,8 @@ class ASTDeclContextNameLookupTrait {
   ModuleFile &F;
 
 public:
-  // Maximum number of lookup tables we allow before condensing the tables.
+  // Maximum number of lookup tables we allow before considering condensing
+  // the tables.
   static const int MaxTables = 4;
 
   /// The lookup result is a list of global declaration IDs.
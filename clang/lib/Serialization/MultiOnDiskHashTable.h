@@ -89,6 +89,10 @@ private:
   /// discarded.
   llvm::TinyPtrVector<file_type> PendingOverrides;
 
+  /// The number of lookups performed since the on-disk tables were last
+  /// condensed into the merged table.
+  uint64_t NumLookupsSinceCondense = 0;
+
   struct AsOnDiskTable {
     using result_type = OnDiskTable *;
 
@@ -142,6 +146,27 @@ private:
     PendingOverrides.clear();
   }
 
+  /// Determine whether it's worth merging the on-disk tables.
+  ///
+  /// Merging reads in every entry of every on-disk table, which is wasteful
+  /// when only a few of the names are ever looked up, e.g. for the translation
+  /// unit of a large module of which only a handful of declarations are used.
+  /// Only merge once the lookups performed so far have probed about as many
+  /// on-disk tables as there are entries to merge, so the cost of the eager
+  /// read stays proportional to the lookups that actually happen.
+  bool shouldCondense() {
+    if (Tables.size() <= static_cast<unsigned>(Info::MaxTables))
+      return false;
+
+    uint64_t NumOnDiskTables = 0;
+    uint64_t NumEntries = 0;
+    for (auto *ODT : tables()) {
+      ++NumOnDiskTables;
+      NumEntries += ODT->Table.getNumEntries();
+    }
+    return NumLookupsSinceCondense * NumOnDiskTables >= NumEntries;
+  }
+
   void condense() {
     MergedTable *Merged = getMergedTable();
     if (!Merged)
@@ -170,6 +195,7 @@ private:
 
     Tables.clear();
     Tables.push_back(Table(Merged).getOpaqueValue());
+    NumLookupsSinceCondense = 0;
   }
 
 public:
@@ -177,7 +203,8 @@ public:
 
   MultiOnDiskHashTable(MultiOnDiskHashTable &&O)
       : Tables(std::move(O.Tables)),
-        PendingOverrides(std::move(O.PendingOverrides)) {
+        PendingOverrides(std::move(O.PendingOverrides)),
+        NumLookupsSinceCondense(O.NumLookupsSinceCondense) {
     O.Tables.clear();
   }
 
@@ -188,6 +215,7 @@ public:
     Tables = std::move(O.Tables);
     O.Tables.clear();
     PendingOverrides = std::move(O.PendingOverrides);
+    NumLookupsSinceCondense = O.NumLookupsSinceCondense;
     return *this;
   }
 
@@ -231,7 +259,8 @@ public:
     if (!PendingOverrides.empty())
       removeOverriddenTables();
 
-    if (Tables.size() > static_cast<unsigned>(Info::MaxTables))
+    ++NumLookupsSinceCondense;
+    if (shouldCondense())
       condense();
 
     internal_key_type Key = Info::GetInternalKey(EKey);
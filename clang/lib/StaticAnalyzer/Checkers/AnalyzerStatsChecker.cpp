@@ -109,7 +109,9 @@ void AnalyzerStatsChecker::checkEndAnalysis(ExplodedGraph &G,
       << unreachable << " | Exhausted Block: "
       << (Eng.wasBlocksExhausted() ? "yes" : "no")
       << " | Empty WorkList: "
-      << (Eng.hasEmptyWorkList() ? "yes" : "no");
+      << (Eng.hasEmptyWorkList() ? "yes" : "no")
+      << " | Peak Exploded Nodes: " << G.getPeakSize()
+      << " | Exploded Graph KB: " << G.getAllocatedBytes() / 1024;
 
   B.EmitBasicReport(D, this, "Analyzer Statistics", "Internal Statistics",
                     output.str(), PathDiagnosticLocation(D, SM));
@@ -28,13 +28,22 @@
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/PointerUnion.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/Casting.h"
+#include <algorithm>
 #include <cassert>
 #include <memory>
 
 using namespace clang;
 using namespace ento;
 
+#define DEBUG_TYPE "ExplodedGraph"
+
+STATISTIC(NumReclaimedNodes, "The # of exploded graph nodes reclaimed");
+STATISTIC(NumDeferredReclaimedNodes,
+          "The # of reclaimed nodes that were on the frontier when first "
+          "considered");
+
 //===----------------------------------------------------------------------===//
 // Cleanup.
 //===----------------------------------------------------------------------===//
@@ -165,11 +174,12 @@ void ExplodedGraph::collectNode(ExplodedNode *node) {
   FreeNodes.push_back(node);
   Nodes.RemoveNode(node);
   --NumNodes;
+  ++NumReclaimedNodes;
   node->~ExplodedNode();
 }
 
 void ExplodedGraph::reclaimRecentlyAllocatedNodes() {
-  if (ChangedNodes.empty())
+  if (ChangedNodes.empty() && DeferredNodes.empty())
     return;
 
   // Only periodically reclaim nodes so that we can build up a set of
@@ -180,9 +190,21 @@ void ExplodedGraph::reclaimRecentlyAllocatedNodes() {
     return;
   ReclaimCounter = ReclaimNodeInterval;
 
-  for (const auto node : ChangedNodes)
+  // Nodes that were on the frontier last time have most likely grown a
+  // successor by now. Give them their second and last chance.
+  for (const auto node : DeferredNodes)
+    if (shouldCollect(node)) {
+      collectNode(node);
+      ++NumDeferredReclaimedNodes;
+    }
+  DeferredNodes.clear();
+
+  for (const auto node : ChangedNodes) {
     if (shouldCollect(node))
       collectNode(node);
+    else if (node->succ_size() == 0 && !node->isSink())
+      DeferredNodes.push_back(node);
+  }
   ChangedNodes.clear();
 }
 
@@ -414,6 +436,7 @@ ExplodedNode *ExplodedGraph::getNode(const ProgramPoint &L,
     }
 
     ++NumNodes;
+    PeakNumNodes = std::max(PeakNumNodes, NumNodes);
     new (V) NodeTy(L, State, NumNodes, IsSink);
 
     if (ReclaimNodeInterval)
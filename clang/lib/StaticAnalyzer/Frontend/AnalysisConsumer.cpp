@@ -33,6 +33,8 @@
 #include "clang/StaticAnalyzer/Core/PathSensitive/AnalysisManager.h"
 #include "clang/StaticAnalyzer/Core/PathSensitive/ExprEngine.h"
 #include "clang/StaticAnalyzer/Frontend/CheckerRegistration.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/EquivalenceClasses.h"
 #include "llvm/ADT/PostOrderIterator.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Support/FileSystem.h"
@@ -40,6 +42,7 @@
 #include "llvm/Support/Program.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
 #include <memory>
 #include <queue>
 #include <utility>
@@ -59,6 +62,12 @@ STATISTIC(NumVisitedBlocksInAnalyzedFunctions,
           "The # of visited basic blocks in the analyzed functions.");
 STATISTIC(PercentReachableBlocks, "The % of reachable basic blocks.");
 STATISTIC(MaxCFGSize, "The maximum number of basic blocks in a function.");
+STATISTIC(MaxExplodedGraphNodes,
+          "The maximum # of exploded graph nodes alive at once while "
+          "analyzing a function.");
+STATISTIC(MaxExplodedGraphKB,
+          "The maximum # of kilobytes allocated for the exploded graph and "
+          "program states of a function.");
 
 //===----------------------------------------------------------------------===//
 // Special PathDiagnosticConsumers.
@@ -206,6 +215,10 @@ public:
   /// working with a PCH file.
   SetOfDecls LocalTUDecls;
 
+  /// When the analysis is split into shards, the shard that analyzes each
+  /// function of the call graph path-sensitively.
+  llvm::DenseMap<const Decl *, unsigned> ShardOfDecl;
+
   // Set of PathDiagnosticConsumers.  Owned by AnalysisManager.
   PathDiagnosticConsumers PathConsumers;
 
@@ -558,6 +571,37 @@ void AnalysisConsumer::HandleDeclsCallGraph(const unsigned LocalTUDeclsSize) {
   SetOfConstDecls Visited;
   SetOfConstDecls VisitedAsTopLevel;
   llvm::ReversePostOrderTraversal<clang::CallGraph*> RPOT(&CG);
+
+  // Functions are only inlined into their callers. When the analysis is
+  // split into shards, assign every connected part of the call graph to one
+  // shard, chosen by the name of its first function in this order, so that
+  // each shard skips the same inlined functions as an unsharded analysis.
+  if (Opts->AnalysisShardCount > 1) {
+    llvm::EquivalenceClasses<const Decl *> Components;
+    for (CallGraphNode *N : RPOT) {
+      const Decl *D = N->getDecl();
+      if (!D)
+        continue;
+      Components.insert(D);
+      for (CallGraphNode *Callee : *N)
+        if (const Decl *CD = Callee->getDecl())
+          Components.unionSets(D, CD);
+    }
+    llvm::DenseMap<const Decl *, unsigned> ShardOfComponent;
+    for (CallGraphNode *N : RPOT) {
+      const Decl *D = N->getDecl();
+      if (!D)
+        continue;
+      const Decl *Leader = Components.getLeaderValue(D);
+      auto It = ShardOfComponent.find(Leader);
+      if (It == ShardOfComponent.end())
+        It = ShardOfComponent
+                 .insert({Leader, llvm::xxHash64(getFunctionName(D)) %
+                                      Opts->AnalysisShardCount})
+                 .first;
+      ShardOfDecl[D] = It->second;
+    }
+  }
   for (llvm::ReversePostOrderTraversal<clang::CallGraph*>::rpo_iterator
          I = RPOT.begin(), E = RPOT.end(); I != E; ++I) {
     NumFunctionTopLevel++;
@@ -602,11 +646,13 @@ static bool isBisonFile(ASTContext &C) {
 void AnalysisConsumer::runAnalysisOnTranslationUnit(ASTContext &C) {
   BugReporter BR(*Mgr);
   TranslationUnitDecl *TU = C.getTranslationUnitDecl();
-  if (SyntaxCheckTimer)
-    SyntaxCheckTimer->startTimer();
-  checkerMgr->runCheckersOnASTDecl(TU, *Mgr, BR);
-  if (SyntaxCheckTimer)
-    SyntaxCheckTimer->stopTimer();
+  if (Opts->AnalysisShardCount <= 1 || Opts->AnalysisShardIndex == 0) {
+    if (SyntaxCheckTimer)
+      SyntaxCheckTimer->startTimer();
+    checkerMgr->runCheckersOnASTDecl(TU, *Mgr, BR);
+    if (SyntaxCheckTimer)
+      SyntaxCheckTimer->stopTimer();
+  }
 
   // Run the AST-only checks using the order in which functions are defined.
   // If inlining is not turned on, use the simplest function order for path
@@ -631,7 +677,8 @@ void AnalysisConsumer::runAnalysisOnTranslationUnit(ASTContext &C) {
     HandleDeclsCallGraph(LocalTUDeclsSize);
 
   // After all decls handled, run checkers on the entire TranslationUnit.
-  checkerMgr->runCheckersOnEndOfTranslationUnit(TU, *Mgr, BR);
+  if (Opts->AnalysisShardCount <= 1 || Opts->AnalysisShardIndex == 0)
+    checkerMgr->runCheckersOnEndOfTranslationUnit(TU, *Mgr, BR);
 
   BR.FlushReports();
   RecVisitorBR = nullptr;
@@ -749,7 +796,27 @@ AnalysisConsumer::getModeForDecl(Decl *D, AnalysisMode Mode) {
   if (!Opts->AnalyzeAll && !Mgr->isInCodeFile(SL)) {
     if (SL.isInvalid() || SM.isInSystemHeader(SL))
       return AM_None;
-    return Mode & ~AM_Path;
+    Mode &= ~AM_Path;
+  }
+
+  // When the analysis of the translation unit is split across several
+  // processes, each shard analyzes a disjoint set of functions
+  // path-sensitively: those of its parts of the call graph, or, without
+  // inlining, those chosen by a stable hash of their names. The AST-based
+  // checks are run by the first shard only, so that their reports are not
+  // duplicated.
+  if (Opts->AnalysisShardCount > 1) {
+    if (Opts->AnalysisShardIndex != 0)
+      Mode &= ~AM_Syntax;
+    if (Mode & AM_Path) {
+      auto It = ShardOfDecl.find(D);
+      unsigned Shard = It != ShardOfDecl.end()
+                           ? It->second
+                           : llvm::xxHash64(getFunctionName(D)) %
+                                 Opts->AnalysisShardCount;
+      if (Shard != Opts->AnalysisShardIndex)
+        Mode &= ~AM_Path;
+    }
   }
 
   return Mode;
@@ -820,6 +887,10 @@ void AnalysisConsumer::RunPathSensitiveChecks(Decl *D,
   if (ExprEngineTimer)
     ExprEngineTimer->stopTimer();
 
+  ExplodedGraph &G = Eng.getGraph();
+  MaxExplodedGraphNodes.updateMax(G.getPeakSize());
+  MaxExplodedGraphKB.updateMax(G.getAllocatedBytes() / 1024);
+
   if (!Mgr->options.DumpExplodedGraphTo.empty())
     Eng.DumpGraph(Mgr->options.TrimGraph, Mgr->options.DumpExplodedGraphTo);
 
@@ -7,16 +7,33 @@
 //===----------------------------------------------------------------------===//
 
 #include "clang/Tooling/DependencyScanning/DependencyScanningFilesystem.h"
+#include "clang/Basic/Version.h"
 #include "clang/Lex/DependencyDirectivesSourceMinimizer.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/Threading.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
 
 using namespace clang;
 using namespace tooling;
 using namespace dependencies;
 
+/// Creates the status of a minimized file from the status of the original one.
+static llvm::vfs::Status getMinimizedStatus(const llvm::vfs::Status &Stat,
+                                            size_t Size) {
+  return llvm::vfs::Status(Stat.getName(), Stat.getUniqueID(),
+                           Stat.getLastModificationTime(), Stat.getUser(),
+                           Stat.getGroup(), Size, Stat.getType(),
+                           Stat.getPermissions());
+}
+
 CachedFileSystemEntry CachedFileSystemEntry::createFileEntry(
-    StringRef Filename, llvm::vfs::FileSystem &FS, bool Minimize) {
+    StringRef Filename, llvm::vfs::FileSystem &FS, bool Minimize,
+    DependencyScanningPersistentCache *PersistentCache) {
   // Load the file and its content from the file system.
   llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>> MaybeFile =
       FS.openFileForRead(Filename);
@@ -32,9 +49,23 @@ CachedFileSystemEntry CachedFileSystemEntry::createFileEntry(
   if (!MaybeBuffer)
     return MaybeBuffer.getError();
 
+  const auto &Buffer = *MaybeBuffer;
+  // Another scanner process might have minimized this file already.
+  if (Minimize && PersistentCache) {
+    if (llvm::Optional<DependencyScanningPersistentCache::Entry> Cached =
+            PersistentCache->lookup(Buffer->getBuffer())) {
+      CachedFileSystemEntry Result;
+      Result.MaybeStat =
+          getMinimizedStatus(*Stat, Cached->MinimizedContents.size());
+      Result.PersistentCacheBuffer = std::move(Cached->Buffer);
+      Result.PersistentCacheContents = Cached->MinimizedContents;
+      Result.PPSkippedRangeMapping = std::move(Cached->PPSkippedRangeMapping);
+      return Result;
+    }
+  }
+
   llvm::SmallString<1024> MinimizedFileContents;
   // Minimize the file down to directives that might affect the dependencies.
-  const auto &Buffer = *MaybeBuffer;
   SmallVector<minimize_source_to_dependency_directives::Token, 64> Tokens;
   if (!Minimize || minimizeSourceToDependencyDirectives(
                        Buffer->getBuffer(), MinimizedFileContents, Tokens)) {
@@ -52,11 +83,7 @@ CachedFileSystemEntry CachedFileSystemEntry::createFileEntry(
   }
 
   CachedFileSystemEntry Result;
-  size_t Size = MinimizedFileContents.size();
-  Result.MaybeStat = llvm::vfs::Status(Stat->getName(), Stat->getUniqueID(),
-                                       Stat->getLastModificationTime(),
-                                       Stat->getUser(), Stat->getGroup(), Size,
-                                       Stat->getType(), Stat->getPermissions());
+  Result.MaybeStat = getMinimizedStatus(*Stat, MinimizedFileContents.size());
   // The contents produced by the minimizer must be null terminated.
   assert(MinimizedFileContents.data()[MinimizedFileContents.size()] == '\0' &&
          "not null terminated contents");
@@ -86,6 +113,8 @@ CachedFileSystemEntry CachedFileSystemEntry::createFileEntry(
     }
     Mapping[Range.Offset] = Range.Length;
   }
+  if (PersistentCache)
+    PersistentCache->store(Buffer->getBuffer(), Result.Contents, Mapping);
   Result.PPSkippedRangeMapping = std::move(Mapping);
 
   return Result;
@@ -99,6 +128,150 @@ CachedFileSystemEntry::createDirectoryEntry(llvm::vfs::Status &&Stat) {
   return Result;
 }
 
+namespace {
+
+/// The layout of an entry in the persistent cache. All the fields are stored
+/// in little endian order:
+///
+///   Magic (4 bytes) | Format (u32) | VersionSize (u32) | OriginalSize (u64)
+///   | NumRanges (u32) | scanner version | NumRanges x (Offset (u32),
+///   Length (u32)) | original contents | minimized contents until the end of
+///   the file
+///
+/// The scanner version and the original contents form the key of the entry.
+/// The minimized contents are stored last so that the null terminator that
+/// \c MemoryBuffer adds to a mapped file ends them, as the lexer requires.
+constexpr char PersistentCacheMagic[4] = {'C', 'S', 'D', 'M'};
+constexpr uint32_t PersistentCacheFormat = 2;
+constexpr size_t PersistentCacheHeaderSize =
+    sizeof(PersistentCacheMagic) + 2 * sizeof(uint32_t) + sizeof(uint64_t) +
+    sizeof(uint32_t);
+
+} // end anonymous namespace
+
+std::string DependencyScanningPersistentCache::getDefaultScannerVersion() {
+  return (getClangFullVersion() + " minimizer " +
+          Twine(minimize_source_to_dependency_directives::OutputVersion))
+      .str();
+}
+
+void DependencyScanningPersistentCache::getEntryPath(
+    StringRef OriginalContents, SmallVectorImpl<char> &Path) const {
+  Path.assign(CacheDirectory.begin(), CacheDirectory.end());
+  llvm::sys::path::append(
+      Path, llvm::Twine::utohexstr(llvm::xxHash64(ScannerVersion)) + "-" +
+                llvm::Twine::utohexstr(llvm::xxHash64(OriginalContents)) +
+                "-" + llvm::Twine::utohexstr(OriginalContents.size()) +
+                ".min");
+}
+
+llvm::Optional<DependencyScanningPersistentCache::Entry>
+DependencyScanningPersistentCache::lookup(StringRef OriginalContents) const {
+  llvm::Optional<Entry> Result = lookupImpl(OriginalContents);
+  if (Result)
+    ++NumHits;
+  else
+    ++NumMisses;
+  return Result;
+}
+
+llvm::Optional<DependencyScanningPersistentCache::Entry>
+DependencyScanningPersistentCache::lookupImpl(
+    StringRef OriginalContents) const {
+  using namespace llvm::support;
+
+  SmallString<256> Path;
+  getEntryPath(OriginalContents, Path);
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> MaybeBuffer =
+      llvm::MemoryBuffer::getFile(Path, /*FileSize=*/-1,
+                                  /*RequiresNullTerminator=*/true);
+  if (!MaybeBuffer)
+    return None;
+
+  StringRef Data = (*MaybeBuffer)->getBuffer();
+  if (Data.size() < PersistentCacheHeaderSize ||
+      !Data.startswith(StringRef(PersistentCacheMagic,
+                                 sizeof(PersistentCacheMagic))))
+    return None;
+  const char *Ptr = Data.data() + sizeof(PersistentCacheMagic);
+  if (endian::readNext<uint32_t, little, unaligned>(Ptr) !=
+      PersistentCacheFormat)
+    return None;
+  uint64_t VersionSize = endian::readNext<uint32_t, little, unaligned>(Ptr);
+  uint64_t OriginalSize = endian::readNext<uint64_t, little, unaligned>(Ptr);
+  uint64_t NumRanges = endian::readNext<uint32_t, little, unaligned>(Ptr);
+  uint64_t Remaining = Data.size() - PersistentCacheHeaderSize;
+  if (VersionSize > Remaining || NumRanges > (Remaining - VersionSize) / 8 ||
+      OriginalSize > Remaining - VersionSize - NumRanges * 8)
+    return None;
+
+  // The file name is only a hash of the key, so compare the full key to guard
+  // against collisions and stale entries.
+  if (StringRef(Ptr, VersionSize) != ScannerVersion)
+    return None;
+  Ptr += VersionSize;
+  const char *Original = Ptr + NumRanges * 8;
+  if (StringRef(Original, OriginalSize) != OriginalContents)
+    return None;
+
+  Entry Result;
+  for (uint32_t I = 0; I != NumRanges; ++I) {
+    uint32_t Offset = endian::readNext<uint32_t, little, unaligned>(Ptr);
+    uint32_t Length = endian::readNext<uint32_t, little, unaligned>(Ptr);
+    Result.PPSkippedRangeMapping[Offset] = Length;
+  }
+  Ptr = Original + OriginalSize;
+  Result.MinimizedContents = StringRef(Ptr, Data.end() - Ptr);
+  Result.Buffer = std::move(*MaybeBuffer);
+  return std::move(Result);
+}
+
+void DependencyScanningPersistentCache::store(
+    StringRef OriginalContents, StringRef MinimizedContents,
+    const PreprocessorSkippedRangeMapping &Mapping) const {
+  using namespace llvm::support;
+
+  SmallString<256> Path;
+  getEntryPath(OriginalContents, Path);
+  // Another process might have stored it in the meantime.
+  if (llvm::sys::fs::exists(Path))
+    return;
+
+  SmallString<256> TempPath;
+  int FD;
+  if (llvm::sys::fs::createUniqueFile(Twine(Path) + "-%%%%%%%%.tmp", FD,
+                                        TempPath))
+    return;
+  {
+    llvm::raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    OS.write(PersistentCacheMagic, sizeof(PersistentCacheMagic));
+    endian::Writer Writer(OS, little);
+    Writer.write<uint32_t>(PersistentCacheFormat);
+    Writer.write<uint32_t>(ScannerVersion.size());
+    Writer.write<uint64_t>(OriginalContents.size());
+    Writer.write<uint32_t>(Mapping.size());
+    OS << ScannerVersion;
+    // Sort the ranges to make the entries deterministic.
+    SmallVector<std::pair<unsigned, unsigned>, 32> Ranges(Mapping.begin(),
+                                                          Mapping.end());
+    llvm::sort(Ranges);
+    for (const auto &Range : Ranges) {
+      Writer.write<uint32_t>(Range.first);
+      Writer.write<uint32_t>(Range.second);
+    }
+    OS << OriginalContents;
+    OS << MinimizedContents;
+    OS.close();
+    if (OS.has_error()) {
+      OS.clear_error();
+      llvm::sys::fs::remove(TempPath);
+      return;
+    }
+  }
+  if (llvm::sys::fs::rename(TempPath, Path))
+    llvm::sys::fs::remove(TempPath);
+}
+
 DependencyScanningFilesystemSharedCache::
     DependencyScanningFilesystemSharedCache() {
   // This heuristic was chosen using a empirical testing on a
@@ -122,6 +295,14 @@ DependencyScanningFilesystemSharedCache::get(StringRef Key) {
   return It.first->getValue();
 }
 
+DependencyScanningFilesystemSharedCache::SharedRealPathEntry &
+DependencyScanningFilesystemSharedCache::getRealPath(StringRef Key) {
+  CacheShard &Shard = CacheShards[llvm::hash_value(Key) % NumShards];
+  std::unique_lock<std::mutex> LockGuard(Shard.CacheLock);
+  auto It = Shard.RealPaths.try_emplace(Key);
+  return It.first->getValue();
+}
+
 /// Whitelist file extensions that should be minimized, treating no extension as
 /// a source file that should be minimized.
 ///
@@ -184,7 +365,7 @@ DependencyScanningWorkerFilesystem::getOrCreateFileSystemEntry(
             std::move(*MaybeStatus));
       else
         CacheEntry = CachedFileSystemEntry::createFileEntry(
-            Filename, FS, !KeepOriginalSource);
+            Filename, FS, !KeepOriginalSource, PersistentCache);
     }
 
     Result = &CacheEntry;
@@ -266,3 +447,38 @@ DependencyScanningWorkerFilesystem::openFileForRead(const Twine &Path) {
     return Result.getError();
   return createFile(Result.get(), PPSkipMappings);
 }
+
+std::error_code DependencyScanningWorkerFilesystem::getRealPath(
+    const Twine &Path, SmallVectorImpl<char> &Output) const {
+  SmallString<256> AbsPath;
+  Path.toVector(AbsPath);
+  if (std::error_code EC = makeAbsolute(AbsPath))
+    return EC;
+
+  const llvm::ErrorOr<std::string> *Result = RealPathCache.lookup(AbsPath);
+  if (!Result) {
+    DependencyScanningFilesystemSharedCache::SharedRealPathEntry
+        &SharedCacheEntry = SharedCache.getRealPath(AbsPath);
+    std::unique_lock<std::mutex> LockGuard(SharedCacheEntry.ValueLock);
+    if (!SharedCacheEntry.Value) {
+      SmallString<256> RealPath;
+      if (std::error_code EC =
+              ProxyFileSystem::getRealPath(AbsPath, RealPath)) {
+        // Like stat failures, failures on files that might be created during
+        // the scan, such as modules, aren't cached.
+        if (!shouldCacheStatFailures(AbsPath))
+          return EC;
+        SharedCacheEntry.Value = llvm::ErrorOr<std::string>(EC);
+      } else {
+        SharedCacheEntry.Value = llvm::ErrorOr<std::string>(RealPath.str());
+      }
+    }
+    Result = SharedCacheEntry.Value.getPointer();
+    RealPathCache[AbsPath] = Result;
+  }
+
+  if (!*Result)
+    return Result->getError();
+  Output.assign((*Result)->begin(), (*Result)->end());
+  return {};
+}
@@ -14,6 +14,10 @@ using namespace dependencies;
 
 DependencyScanningService::DependencyScanningService(
     ScanningMode Mode, ScanningOutputFormat Format, bool ReuseFileManager,
-    bool SkipExcludedPPRanges)
+    bool SkipExcludedPPRanges, StringRef PersistentCacheDirectory)
     : Mode(Mode), Format(Format), ReuseFileManager(ReuseFileManager),
-      SkipExcludedPPRanges(SkipExcludedPPRanges) {}
+      SkipExcludedPPRanges(SkipExcludedPPRanges) {
+  if (!PersistentCacheDirectory.empty())
+    PersistentCache = std::make_unique<DependencyScanningPersistentCache>(
+        PersistentCacheDirectory);
+}
@@ -0,0 +1,68 @@
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,deadcode.DeadStores \
+// RUN:   -analyzer-config shard-count=2,shard-index=0 \
+// RUN:   -verify=shard0 %s
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,deadcode.DeadStores \
+// RUN:   -analyzer-config shard-count=2,shard-index=1 \
+// RUN:   -verify=shard1 %s
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,deadcode.DeadStores \
+// RUN:   -verify=shard0,shard1 %s
+
+// RUN: not %clang_analyze_cc1 -analyzer-checker=core \
+// RUN:   -analyzer-config shard-count=2,shard-index=2 %s 2>&1 \
+// RUN:   | FileCheck %s -check-prefix=CHECK-INDEX
+
+// CHECK-INDEX: (frontend): invalid input for analyzer-config option
+// CHECK-INDEX-SAME:        'shard-index', that expects a value smaller than
+// CHECK-INDEX-SAME:        'shard-count' value
+
+// Each connected part of the call graph is assigned to a shard by a hash of
+// the name of its first function; 'first' and 'fourth' land in shard 0,
+// 'second' and 'third' in shard 1.
+
+void first() {
+  int *p = 0;
+  *p = 1; // shard0-warning{{Dereference of null pointer}}
+}
+
+void second() {
+  int *p = 0;
+  *p = 2; // shard1-warning{{Dereference of null pointer}}
+}
+
+void third() {
+  int *p = 0;
+  *p = 3; // shard1-warning{{Dereference of null pointer}}
+}
+
+void fourth() {
+  int *p = 0;
+  *p = 4; // shard0-warning{{Dereference of null pointer}}
+}
+
+// AST-based checks only run in the first shard.
+void deadStore() {
+  int x;
+  x = 5; // shard0-warning{{Value stored to 'x' is never read}}
+}
+
+// A caller and its callees are analyzed by the same shard, so the shards skip
+// the inlined callees as top-level functions, like the unsharded analysis
+// does. 'caller' lands in shard 0 and 'useCheck' in shard 1, although
+// 'callee' alone would land in shard 1 and 'check' in shard 0.
+int callee(int x) {
+  if (x == 0) {}
+  return 10 / x; // no-warning
+}
+
+int caller() {
+  int *p = 0;
+  return callee(5) + *p; // shard0-warning{{Dereference of null pointer}}
+}
+
+void check(int *p) {
+  *p = 1; // shard1-warning{{Dereference of null pointer}}
+}
+
+void useCheck() {
+  check(0);
+}
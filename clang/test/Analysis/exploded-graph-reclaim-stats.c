@@ -0,0 +1,38 @@
+// REQUIRES: asserts
+// RUN: %clang_analyze_cc1 -analyzer-checker=core -analyzer-stats \
+// RUN:   -analyzer-config graph-trim-interval=1 %s 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=TRIM
+// RUN: %clang_analyze_cc1 -analyzer-checker=core -analyzer-stats \
+// RUN:   -analyzer-config graph-trim-interval=0 %s 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=NO-TRIM
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,debug.Stats \
+// RUN:   -analyzer-config graph-trim-interval=1 %s 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=PER-FUNCTION
+
+// Reclaiming after every new node leaves every fresh node on the frontier, so
+// they can only be reclaimed once they have been deferred to the next round.
+
+int sum(int n) {
+  int s = 0;
+  for (int i = 0; i < n; ++i) {
+    int x = i * 2;
+    int y = x + 1;
+    s += y;
+  }
+  return s;
+}
+
+// TRIM: ... Statistics Collected ...
+// TRIM-DAG: {{[1-9][0-9]*}} AnalysisConsumer - The maximum # of exploded graph nodes alive at once while analyzing a function.
+// TRIM-DAG: {{[1-9][0-9]*}} AnalysisConsumer - The maximum # of kilobytes allocated for the exploded graph and program states of a function.
+// TRIM-DAG: {{[1-9][0-9]*}} ExplodedGraph - The # of exploded graph nodes reclaimed
+// TRIM-DAG: {{[1-9][0-9]*}} ExplodedGraph - The # of reclaimed nodes that were on the frontier when first considered
+
+// NO-TRIM: ... Statistics Collected ...
+// NO-TRIM-DAG: {{[1-9][0-9]*}} AnalysisConsumer - The maximum # of exploded graph nodes alive at once while analyzing a function.
+// NO-TRIM-DAG: {{[1-9][0-9]*}} AnalysisConsumer - The maximum # of kilobytes allocated for the exploded graph and program states of a function.
+// NO-TRIM-NOT: ExplodedGraph - The # of
+
+// The peak number of live nodes and the graph memory are also reported for
+// every function.
+// PER-FUNCTION: warning: sum -> Total CFGBlocks: {{[0-9]+}} | Unreachable CFGBlocks: {{[0-9]+}} | Exhausted Block: {{yes|no}} | Empty WorkList: yes | Peak Exploded Nodes: {{[1-9][0-9]*}} | Exploded Graph KB: {{[0-9]+}}
@@ -0,0 +1 @@
+#define BENCHMARK_H
@@ -0,0 +1,5 @@
+#ifndef PERSISTENT_CACHE_H
+#define PERSISTENT_CACHE_H
+#include "persistent-cache-2.h"
+int f();
+#endif
@@ -0,0 +1,25 @@
+// RUN: rm -rf %t.dir
+// RUN: rm -rf %t.cdb
+// RUN: mkdir -p %t.dir/Inputs
+// RUN: cp %s %t.dir/benchmark.cpp
+// RUN: cp %s %t.dir/benchmark2.cpp
+// RUN: cp %S/Inputs/benchmark.h %t.dir/Inputs/benchmark.h
+// RUN: sed -e "s|DIR|%/t.dir|g" %S/Inputs/benchmark_cdb.json > %t.cdb
+//
+// RUN: clang-scan-deps -compilation-database %t.cdb -j 2 -benchmark \
+// RUN:   2> %t.err | FileCheck %s
+// RUN: FileCheck --check-prefix=BENCHMARK %s < %t.err
+// RUN: clang-scan-deps -compilation-database %t.cdb -j 1 2>&1 \
+// RUN:   | FileCheck --check-prefix=NO-BENCHMARK %s
+
+#include "benchmark.h"
+
+// The dependencies are still printed with -benchmark, in any order.
+// CHECK-DAG: benchmark.o:
+// CHECK-DAG: benchmark2.o:
+// CHECK-DAG: Inputs{{/|\\}}benchmark.h
+// CHECK-DAG: Inputs{{/|\\}}benchmark.h
+
+// BENCHMARK: Scanned 2 files in {{[0-9]+\.[0-9]+}} s using {{[0-9]+}} workers ({{[0-9]+\.[0-9]}} TUs/s)
+
+// NO-BENCHMARK-NOT: Scanned
@@ -0,0 +1,28 @@
+// RUN: rm -rf %t.dir %t.cache
+// RUN: rm -rf %t.cdb
+// RUN: mkdir -p %t.dir/Inputs
+// RUN: cp %s %t.dir/persistent-cache.cpp
+// RUN: cp %S/Inputs/persistent-cache.h %S/Inputs/persistent-cache-2.h \
+// RUN:   %t.dir/Inputs/
+// RUN: sed -e "s|DIR|%/t.dir|g" %S/Inputs/persistent-cache_cdb.json > %t.cdb
+//
+// The first scan fills the cache, the second one only reads from it and
+// produces the same dependencies.
+// RUN: clang-scan-deps -compilation-database %t.cdb -j 1 -benchmark \
+// RUN:   -persistent-cache-dir %t.cache > %t.first 2> %t.first.err
+// RUN: FileCheck --check-prefix=FIRST %s < %t.first.err
+// RUN: clang-scan-deps -compilation-database %t.cdb -j 1 -benchmark \
+// RUN:   -persistent-cache-dir %t.cache > %t.second 2> %t.second.err
+// RUN: FileCheck --check-prefix=SECOND %s < %t.second.err
+// RUN: diff %t.first %t.second
+// RUN: FileCheck %s < %t.second
+
+#include "persistent-cache.h"
+
+// CHECK: persistent-cache.o:
+// CHECK-NEXT: persistent-cache.cpp
+// CHECK-NEXT: Inputs{{/|\\}}persistent-cache.h
+// CHECK-NEXT: Inputs{{/|\\}}persistent-cache-2.h
+
+// FIRST: Persistent cache: 0 hits, {{[1-9][0-9]*}} misses
+// SECOND: Persistent cache: {{[1-9][0-9]*}} hits, 0 misses
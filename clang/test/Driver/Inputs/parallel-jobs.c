@@ -0,0 +1,2 @@
+#warning second input
+int second_input;
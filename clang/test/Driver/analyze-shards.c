@@ -0,0 +1,29 @@
+// With -j, the analysis of a file is split into one shard per job. Every shard
+// but the first writes its plist next to the requested one.
+
+// RUN: %clang -### --analyze -j 3 -o %t.plist %s 2>&1 \
+// RUN:   | FileCheck --check-prefix=PLIST %s
+// PLIST: "-analyze"
+// PLIST-SAME: "-analyzer-config" "shard-count=3,shard-index=0" "-o" "{{[^"]*}}.plist"
+// PLIST: "-analyze"
+// PLIST-SAME: "-analyzer-config" "shard-count=3,shard-index=1" "-o" "{{[^"]*}}.shard1.plist"
+// PLIST: "-analyze"
+// PLIST-SAME: "-analyzer-config" "shard-count=3,shard-index=2" "-o" "{{[^"]*}}.shard2.plist"
+// PLIST-NOT: "-analyze"
+
+// HTML reports have unique names, so the shards share the output directory.
+// RUN: %clang -### --analyze --analyzer-output html -j 2 -o %t.dir %s 2>&1 \
+// RUN:   | FileCheck --check-prefix=HTML %s
+// HTML: "shard-count=2,shard-index=0" "-o" "[[DIR:[^"]*]]"
+// HTML: "shard-count=2,shard-index=1" "-o" "[[DIR]]"
+
+// RUN: %clang -### --analyze -o %t.plist %s 2>&1 \
+// RUN:   | FileCheck --check-prefix=NOSHARD %s
+// RUN: %clang -### --analyze -j 2 -Xanalyzer -analyzer-config \
+// RUN:   -Xanalyzer shard-count=4,shard-index=1 -o %t.plist %s 2>&1 \
+// RUN:   | FileCheck --check-prefix=NOSHARD %s
+// NOSHARD: "-analyze"
+// NOSHARD-NOT: "shard-count=2
+// NOSHARD-NOT: "-analyze"
+
+void f() {}
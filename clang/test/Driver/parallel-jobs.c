@@ -0,0 +1,17 @@
+// Independent jobs may run concurrently, but their output is still printed in
+// the order of the inputs.
+// RUN: %clang -j 4 -E %s %S/Inputs/parallel-jobs.c 2>/dev/null \
+// RUN:   | FileCheck --check-prefix=OUTPUT %s
+// RUN: %clang -j4 -fsyntax-only %s %S/Inputs/parallel-jobs.c 2>&1 \
+// RUN:   | FileCheck --check-prefix=DIAGS %s
+// OUTPUT: first_input
+// OUTPUT: second_input
+// DIAGS: warning: first input
+// DIAGS: warning: second input
+
+// RUN: not %clang -j 0 -fsyntax-only %s 2>&1 \
+// RUN:   | FileCheck --check-prefix=INVALID %s
+// INVALID: invalid integral value '0' in '-j 0'
+
+#warning first input
+int first_input;
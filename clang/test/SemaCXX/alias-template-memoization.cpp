@@ -0,0 +1,59 @@
+// RUN: %clang_cc1 -std=c++11 -fsyntax-only -verify %s
+// RUN: %clang_cc1 -std=c++11 -fsyntax-only -DSTATS -print-stats %s 2>&1 \
+// RUN:   | FileCheck %s
+
+template <typename T> struct identity { typedef T type; };
+template <typename T> using identity_t = typename identity<T>::type;
+
+template <typename T> identity_t<T> f(identity_t<T> t) { return t; }
+
+int a = f<int>(0);
+int b = f<int>(1);
+identity_t<int> c = identity_t<int>(2);
+identity_t<long> d = c;
+
+// Reusing a substitution must not skip access checks that depend on the
+// context naming the alias.
+class Secret {
+  typedef int type;
+  friend struct Friend;
+};
+template <typename T> using secret_t = typename T::type;
+#ifndef STATS
+// expected-note@-5 {{implicitly declared private here}}
+// expected-error@-3 {{'type' is a private member of 'Secret'}}
+#endif
+
+struct Friend {
+  secret_t<Secret> x;
+};
+#ifndef STATS
+struct Stranger {
+  secret_t<Secret> y; // expected-note {{in instantiation of template type alias 'secret_t' requested here}}
+};
+#endif
+
+// Calls in the pattern are resolved where the alias is named, so an overload
+// declared after a first use must be found by the next one.
+template <typename T, typename U> struct is_same {
+  static const bool value = false;
+};
+template <typename T> struct is_same<T, T> { static const bool value = true; };
+
+namespace ns {
+struct A {};
+char f(A, long);
+} // namespace ns
+template <typename T> using f_t = decltype(f(T(), 0));
+template <typename T> using wrapped_f_t = identity_t<f_t<T>>;
+static_assert(is_same<f_t<ns::A>, char>::value, "");
+static_assert(is_same<wrapped_f_t<ns::A>, char>::value, "");
+namespace ns {
+int f(A, int);
+} // namespace ns
+static_assert(is_same<f_t<ns::A>, int>::value, "");
+static_assert(is_same<wrapped_f_t<ns::A>, int>::value, "");
+
+// CHECK: {{[1-9][0-9]*}} alias template specializations reused
+// CHECK: *** Template Instantiation Profile:
+// CHECK: identity
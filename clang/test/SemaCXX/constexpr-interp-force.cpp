@@ -0,0 +1,8 @@
+// RUN: %clang_cc1 -std=c++14 -fsyntax-only -verify=fallback %s -fexperimental-new-constant-interpreter
+// RUN: %clang_cc1 -std=c++14 -fsyntax-only -verify=force %s -fforce-experimental-new-constant-interpreter
+
+// fallback-no-diagnostics
+
+// Arrays have no bytecode lowering, so the function is left to the AST walker
+// unless the interpreter is forced.
+constexpr int first(int a, int b) { int arr[2] = {a, b}; return arr[0]; } // force-error {{constexpr function never produces a constant expression}} force-error {{the experimental clang interpreter failed to evaluate an expression}}
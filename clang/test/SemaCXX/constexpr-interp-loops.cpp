@@ -0,0 +1,75 @@
+// RUN: %clang_cc1 -std=c++14 -fsyntax-only -verify %s
+// RUN: %clang_cc1 -std=c++14 -fsyntax-only -verify %s -fexperimental-new-constant-interpreter
+// RUN: %clang_cc1 -std=c++14 -fsyntax-only -verify %s -fforce-experimental-new-constant-interpreter
+
+// expected-no-diagnostics
+
+constexpr int sum(int n) {
+  int s = 0;
+  for (int i = 1; i <= n; ++i)
+    s += i;
+  return s;
+}
+static_assert(sum(100) == 5050, "");
+
+constexpr unsigned fact(unsigned n) {
+  unsigned r = 1;
+  while (n > 1)
+    r *= n--;
+  return r;
+}
+static_assert(fact(10) == 3628800u, "");
+
+constexpr int count_down(int n) {
+  int steps = 0;
+  do {
+    n -= 1;
+    steps++;
+  } while (n > 0);
+  return steps;
+}
+static_assert(count_down(7) == 7, "");
+static_assert(count_down(-1) == 1, "");
+
+constexpr int first_multiple(int from, int k) {
+  int i = from;
+  for (;; ++i) {
+    if (i == 0)
+      continue;
+    if (i / k * k == i)
+      break;
+  }
+  return i;
+}
+static_assert(first_multiple(-2, 5) == 5, "");
+static_assert(first_multiple(11, 4) == 12, "");
+
+constexpr int nested(int n) {
+  int total = 0;
+  for (int i = 0; i < n; ++i) {
+    int j = 0;
+    while (true) {
+      if (j == i)
+        break;
+      total += j;
+      ++j;
+    }
+  }
+  return total;
+}
+static_assert(nested(5) == 10, "");
+
+constexpr int triangle(int n) {
+  if (n == 0)
+    return 0;
+  return n + triangle(n - 1);
+}
+static_assert(triangle(50) == sum(50), "");
+
+constexpr bool both(bool a, bool b) { return a && b; }
+constexpr bool either(bool a, bool b) { return a || b; }
+static_assert(both(true, true) && !both(true, false), "");
+static_assert(either(false, true) && !either(false, false), "");
+
+constexpr int global = sum(10) * 2;
+static_assert(global == 110, "");
@@ -108,6 +108,13 @@ static cl::opt<bool>
     Verbose("verbose", cl::desc("If set, shows the list of processed files"),
             cl::cat(ClangFormatCategory));
 
+static cl::opt<bool> Incremental(
+    "incremental",
+    cl::desc("If set, only parse the part of the file around the ranges to\n"
+             "format, when that gives the same result as parsing the whole\n"
+             "file. Useful with -lines or -offset on large files."),
+    cl::cat(ClangFormatCategory));
+
 // Use --dry-run to match other LLVM tools when you mean do it but don't
 // actually do it
 static cl::opt<bool>
@@ -398,7 +405,10 @@ static bool format(StringRef FileName) {
   Ranges = tooling::calculateRangesAfterReplacements(Replaces, Ranges);
   FormattingAttemptStatus Status;
   Replacements FormatChanges =
-      reformat(*FormatStyle, *ChangedCode, Ranges, AssumedFileName, &Status);
+      Incremental ? reformatIncrementally(*FormatStyle, *ChangedCode, Ranges,
+                                          AssumedFileName, &Status)
+                  : reformat(*FormatStyle, *ChangedCode, Ranges,
+                             AssumedFileName, &Status);
   Replaces = Replaces.merge(FormatChanges);
   if (OutputXML || DryRun) {
     if (DryRun) {
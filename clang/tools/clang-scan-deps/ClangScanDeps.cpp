@@ -14,10 +14,13 @@
 #include "clang/Tooling/JSONCompilationDatabase.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/Threading.h"
+#include "llvm/Support/Timer.h"
+#include <atomic>
 #include <mutex>
 #include <thread>
 
@@ -153,6 +156,21 @@ llvm::cl::opt<bool> SkipExcludedPPRanges(
         "until reaching the end directive."),
     llvm::cl::init(true), llvm::cl::cat(DependencyScannerCategory));
 
+llvm::cl::opt<std::string> PersistentCacheDir(
+    "persistent-cache-dir",
+    llvm::cl::desc(
+        "Directory of an on-disk cache of minimized source files that is "
+        "shared with other clang-scan-deps processes. The directory is "
+        "created if it does not exist."),
+    llvm::cl::init(""), llvm::cl::cat(DependencyScannerCategory));
+
+llvm::cl::opt<bool> Benchmark(
+    "benchmark",
+    llvm::cl::desc("Print the time it took to scan all the inputs, the "
+                   "resulting throughput and the persistent cache hit rate "
+                   "to stderr."),
+    llvm::cl::init(false), llvm::cl::cat(DependencyScannerCategory));
+
 llvm::cl::opt<bool> Verbose("v", llvm::cl::Optional,
                             llvm::cl::desc("Use verbose output."),
                             llvm::cl::init(false),
@@ -297,8 +315,17 @@ int main(int argc, const char **argv) {
   // Print out the dependency results to STDOUT by default.
   SharedStream DependencyOS(llvm::outs());
 
+  if (!PersistentCacheDir.empty()) {
+    if (std::error_code EC =
+            llvm::sys::fs::create_directories(PersistentCacheDir)) {
+      llvm::errs() << "error: cannot create persistent cache directory '"
+                   << PersistentCacheDir << "': " << EC.message() << "\n";
+      return 1;
+    }
+  }
+
   DependencyScanningService Service(ScanMode, Format, ReuseFileManager,
-                                    SkipExcludedPPRanges);
+                                    SkipExcludedPPRanges, PersistentCacheDir);
 #if LLVM_ENABLE_THREADS
   unsigned NumWorkers =
       NumThreads == 0 ? llvm::hardware_concurrency() : NumThreads;
@@ -316,30 +343,29 @@ int main(int argc, const char **argv) {
 
   std::vector<std::thread> WorkerThreads;
   std::atomic<bool> HadErrors(false);
-  std::mutex Lock;
-  size_t Index = 0;
+  // The inputs are handed out through an atomic counter, so picking up the next
+  // input never blocks. Otherwise, a worker only takes a lock on the first
+  // lookup of each file in the sharded shared cache; later lookups hit the
+  // local cache of its file system.
+  std::atomic<size_t> Index(0);
 
   if (Verbose) {
     llvm::outs() << "Running clang-scan-deps on " << Inputs.size()
                  << " files using " << NumWorkers << " workers\n";
   }
+  llvm::TimeRecord StartTime = llvm::TimeRecord::getCurrentTime();
   for (unsigned I = 0; I < NumWorkers; ++I) {
-    auto Worker = [I, &Lock, &Index, &Inputs, &HadErrors, &WorkerTools,
+    auto Worker = [I, &Index, &Inputs, &HadErrors, &WorkerTools,
                    &DependencyOS, &Errs]() {
       while (true) {
-        const SingleCommandCompilationDatabase *Input;
-        std::string Filename;
-        std::string CWD;
         // Take the next input.
-        {
-          std::unique_lock<std::mutex> LockGuard(Lock);
-          if (Index >= Inputs.size())
-            return;
-          Input = &Inputs[Index++];
-          tooling::CompileCommand Cmd = Input->getAllCompileCommands()[0];
-          Filename = std::move(Cmd.Filename);
-          CWD = std::move(Cmd.Directory);
-        }
+        size_t InputIndex = Index++;
+        if (InputIndex >= Inputs.size())
+          return;
+        const SingleCommandCompilationDatabase *Input = &Inputs[InputIndex];
+        tooling::CompileCommand Cmd = Input->getAllCompileCommands()[0];
+        std::string Filename = std::move(Cmd.Filename);
+        std::string CWD = std::move(Cmd.Directory);
         // Run the tool on it.
         auto MaybeFile = WorkerTools[I]->getDependencyFile(*Input, CWD);
         if (handleDependencyToolResult(Filename, MaybeFile, DependencyOS, Errs))
@@ -356,5 +382,18 @@ int main(int argc, const char **argv) {
   for (auto &W : WorkerThreads)
     W.join();
 
+  if (Benchmark) {
+    double Elapsed = llvm::TimeRecord::getCurrentTime().getWallTime() -
+                     StartTime.getWallTime();
+    llvm::errs() << llvm::format(
+        "Scanned %zu files in %.3f s using %u workers (%.1f TUs/s)\n",
+        Inputs.size(), Elapsed, NumWorkers,
+        Elapsed > 0 ? Inputs.size() / Elapsed : 0.0);
+    if (const DependencyScanningPersistentCache *Cache =
+            Service.getPersistentCache())
+      llvm::errs() << "Persistent cache: " << Cache->getNumHits() << " hits, "
+                   << Cache->getNumMisses() << " misses\n";
+  }
+
   return HadErrors;
 }
@@ -13,6 +13,7 @@
 #include "clang/Tooling/Tooling.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/Support/Host.h"
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 namespace clang {
@@ -111,6 +112,45 @@ TEST(MatchFinder, CheckProfiling) {
   EXPECT_EQ("MyID", Records.begin()->getKey());
 }
 
+TEST(MatchFinder, DispatchesByRequiredName) {
+  struct RecordingCallback : public MatchFinder::MatchCallback {
+    RecordingCallback(std::string Tag, std::vector<std::string> &Log)
+        : Tag(std::move(Tag)), Log(Log) {}
+    void run(const MatchFinder::MatchResult &Result) override {
+      const auto *ND = Result.Nodes.getNodeAs<NamedDecl>("d");
+      Log.push_back(Tag + ":" + ND->getNameAsString());
+    }
+    std::string Tag;
+    std::vector<std::string> &Log;
+  };
+
+  std::vector<std::string> Log;
+  RecordingCallback Any("any", Log), F("f", Log), GOrH("g|h", Log),
+      Qualified("ns::f", Log), AnyOf("anyOf", Log), Unconstrained("or", Log);
+  MatchFinder Finder;
+  Finder.addMatcher(functionDecl(isDefinition()).bind("d"), &Any);
+  Finder.addMatcher(functionDecl(hasName("f"), isDefinition()).bind("d"), &F);
+  Finder.addMatcher(functionDecl(hasAnyName("g", "h")).bind("d"), &GOrH);
+  Finder.addMatcher(functionDecl(hasName("::ns::f")).bind("d"), &Qualified);
+  Finder.addMatcher(
+      functionDecl(anyOf(hasName("g"), hasName("ns::f"))).bind("d"), &AnyOf);
+  Finder.addMatcher(
+      functionDecl(anyOf(hasName("g"), returns(asString("int")))).bind("d"),
+      &Unconstrained);
+
+  std::unique_ptr<FrontendActionFactory> Factory(
+      newFrontendActionFactory(&Finder));
+  ASSERT_TRUE(tooling::runToolOnCode(Factory->create(),
+                                     "void f() {} void g() {}"
+                                     "int k() { return 0; }"
+                                     "namespace ns { void f(); }"));
+
+  // Callbacks still run in the order the matchers were added.
+  EXPECT_THAT(Log, testing::ElementsAre("any:f", "f:f", "any:g", "g|h:g",
+                                        "anyOf:g", "or:g", "any:k", "or:k",
+                                        "ns::f:f", "anyOf:f"));
+}
+
 class VerifyStartOfTranslationUnit : public MatchFinder::MatchCallback {
 public:
   VerifyStartOfTranslationUnit() : Called(false) {}
@@ -104,6 +104,142 @@ TEST_F(SourceManagerTest, isBeforeInTranslationUnit) {
   EXPECT_TRUE(SourceMgr.isBeforeInTranslationUnit(idLoc, macroExpEndLoc));
 }
 
+TEST_F(SourceManagerTest, macroArgTokensAfterLongTokenShareExpansion) {
+  const char *source =
+    "#define M(x) [x]\n"
+    "M(\"a string literal which is longer than fifty characters\" foo)";
+  std::unique_ptr<llvm::MemoryBuffer> Buf =
+      llvm::MemoryBuffer::getMemBuffer(source);
+  FileID mainFileID = SourceMgr.createFileID(std::move(Buf));
+  SourceMgr.setMainFileID(mainFileID);
+
+  TrivialModuleLoader ModLoader;
+  HeaderSearch HeaderInfo(std::make_shared<HeaderSearchOptions>(), SourceMgr,
+                          Diags, LangOpts, &*Target);
+  Preprocessor PP(std::make_shared<PreprocessorOptions>(), Diags, LangOpts,
+                  SourceMgr, HeaderInfo, ModLoader,
+                  /*IILookup =*/nullptr,
+                  /*OwnsHeaderSearch =*/false);
+  PP.Initialize(*Target);
+  PP.EnterMainSourceFile();
+
+  std::vector<Token> toks;
+  while (1) {
+    Token tok;
+    PP.Lex(tok);
+    if (tok.is(tok::eof))
+      break;
+    toks.push_back(tok);
+  }
+
+  ASSERT_EQ(4U, toks.size());
+  ASSERT_EQ(tok::string_literal, toks[1].getKind());
+  ASSERT_EQ(tok::identifier, toks[2].getKind());
+
+  // Both argument tokens are covered by a single macro argument expansion.
+  SourceLocation strLoc = toks[1].getLocation();
+  SourceLocation idLoc = toks[2].getLocation();
+  ASSERT_TRUE(strLoc.isMacroID());
+  EXPECT_EQ(SourceMgr.getFileID(strLoc), SourceMgr.getFileID(idLoc));
+  EXPECT_TRUE(SourceMgr.isMacroArgExpansion(idLoc));
+  EXPECT_EQ(SourceMgr.translateLineCol(mainFileID, 2, 60),
+            SourceMgr.getSpellingLoc(idLoc));
+  EXPECT_TRUE(SourceMgr.isBeforeInTranslationUnit(strLoc, idLoc));
+}
+
+// Stands in for an AST file, so that its "loaded" address space can use up
+// all but a few bytes of the source location space.
+class SLocSpaceReservation : public ExternalSLocEntrySource {
+public:
+  SLocSpaceReservation(SourceManager &SM, unsigned LocalBudget) {
+    SM.setExternalSLocEntrySource(this);
+    SM.AllocateLoadedSLocEntries(
+        1, (1U << 31) - SM.getNextLocalOffset() - LocalBudget);
+  }
+
+  bool ReadSLocEntry(int ID) override { return true; }
+  std::pair<SourceLocation, StringRef> getModuleImportLoc(int ID) override {
+    return std::make_pair(SourceLocation(), "");
+  }
+};
+
+TEST_F(SourceManagerTest, createFileIDOutOfSourceLocations) {
+  FileID MainFileID =
+      SourceMgr.createFileID(llvm::MemoryBuffer::getMemBuffer("int x;\n"));
+  SourceMgr.setMainFileID(MainFileID);
+  SLocSpaceReservation Reservation(SourceMgr, 64);
+
+  FileID Small =
+      SourceMgr.createFileID(llvm::MemoryBuffer::getMemBuffer("int y;\n"));
+  EXPECT_TRUE(Small.isValid());
+  EXPECT_FALSE(Diags.hasErrorOccurred());
+
+  std::string Large(100, ' ');
+  FileID TooLarge =
+      SourceMgr.createFileID(llvm::MemoryBuffer::getMemBuffer(Large));
+  EXPECT_TRUE(TooLarge.isInvalid());
+  EXPECT_TRUE(Diags.hasErrorOccurred());
+
+  // Nothing was allocated for the failed file.
+  unsigned NextOffset = SourceMgr.getNextLocalOffset();
+  EXPECT_TRUE(SourceMgr
+                  .createExpansionLoc(SourceMgr.getLocForStartOfFile(Small),
+                                      SourceMgr.getLocForStartOfFile(Small),
+                                      SourceMgr.getLocForStartOfFile(Small),
+                                      100)
+                  .isInvalid());
+  EXPECT_EQ(NextOffset, SourceMgr.getNextLocalOffset());
+}
+
+TEST_F(SourceManagerTest, macroExpansionOutOfSourceLocations) {
+  std::string Source = "#define M(x) x + x\n";
+  for (unsigned I = 10; I < 100; ++I)
+    Source += "M(" + std::to_string(I) + ")\n";
+  FileID MainFileID =
+      SourceMgr.createFileID(llvm::MemoryBuffer::getMemBuffer(Source));
+  SourceMgr.setMainFileID(MainFileID);
+
+  TrivialModuleLoader ModLoader;
+  HeaderSearch HeaderInfo(std::make_shared<HeaderSearchOptions>(), SourceMgr,
+                          Diags, LangOpts, &*Target);
+  Preprocessor PP(std::make_shared<PreprocessorOptions>(), Diags, LangOpts,
+                  SourceMgr, HeaderInfo, ModLoader,
+                  /*IILookup =*/nullptr,
+                  /*OwnsHeaderSearch =*/false);
+  PP.Initialize(*Target);
+  PP.EnterMainSourceFile();
+  // Enough for a few expansions, but not for all of them.
+  SLocSpaceReservation Reservation(SourceMgr, 200);
+
+  std::vector<Token> Toks;
+  while (1) {
+    Token Tok;
+    PP.Lex(Tok);
+    if (Tok.is(tok::eof))
+      break;
+    Toks.push_back(Tok);
+  }
+  EXPECT_TRUE(Diags.hasErrorOccurred());
+
+  // Expansions that could not be allocated leave the tokens at their spelling
+  // locations, rather than at offsets from an invalid location.
+  ASSERT_EQ(3U * 90, Toks.size());
+  for (unsigned I = 0; I < 90; ++I) {
+    std::string Number = std::to_string(I + 10);
+    for (unsigned J = 0; J < 3; ++J) {
+      SourceLocation Loc = Toks[3 * I + J].getLocation();
+      ASSERT_TRUE(Loc.isValid());
+      SourceLocation SpellingLoc = SourceMgr.getSpellingLoc(Loc);
+      EXPECT_EQ(MainFileID, SourceMgr.getFileID(SpellingLoc));
+      EXPECT_EQ(J == 1 ? "+" : Number,
+                StringRef(SourceMgr.getCharacterData(SpellingLoc),
+                          Toks[3 * I + J].getLength()));
+    }
+  }
+  EXPECT_TRUE(Toks.front().getLocation().isMacroID());
+  EXPECT_TRUE(Toks.back().getLocation().isFileID());
+}
+
 TEST_F(SourceManagerTest, getColumnNumber) {
   const char *Source =
     "int x;\n"
@@ -0,0 +1,245 @@
+//===- unittest/Format/IncrementalFormatTest.cpp - Formatting unit tests --===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "../../lib/Format/IncrementalFormat.h"
+#include "clang/Format/Format.h"
+#include "gtest/gtest.h"
+
+namespace clang {
+namespace format {
+namespace {
+
+class IncrementalFormatTest : public ::testing::Test {
+protected:
+  llvm::Optional<internal::FormattingRegion>
+  findRegion(llvm::StringRef Code, unsigned Offset, unsigned Length) {
+    std::vector<tooling::Range> Ranges(1, tooling::Range(Offset, Length));
+    return internal::findFormattingRegion(Style, Code, Ranges);
+  }
+
+  std::string format(llvm::StringRef Code, unsigned Offset, unsigned Length,
+                     IncrementalFormatCache *Cache = nullptr) {
+    std::vector<tooling::Range> Ranges(1, tooling::Range(Offset, Length));
+    FormattingAttemptStatus Status;
+    tooling::Replacements Replaces = reformatIncrementally(
+        Style, Code, Ranges, "<stdin>", &Status, Cache);
+    EXPECT_TRUE(Status.FormatComplete) << Code << "\n\n";
+    auto Result = applyAllReplacements(Code, Replaces);
+    EXPECT_TRUE(static_cast<bool>(Result));
+    return *Result;
+  }
+
+  // Checks that formatting the range incrementally gives the same result as
+  // formatting it as part of the whole file.
+  void verifyIncremental(llvm::StringRef Code, unsigned Offset,
+                         unsigned Length, bool ExpectRegion = true) {
+    EXPECT_EQ(ExpectRegion, findRegion(Code, Offset, Length).hasValue())
+        << Code;
+    std::vector<tooling::Range> Ranges(1, tooling::Range(Offset, Length));
+    auto Expected = applyAllReplacements(Code, reformat(Style, Code, Ranges));
+    EXPECT_TRUE(static_cast<bool>(Expected));
+    EXPECT_EQ(*Expected, format(Code, Offset, Length)) << Code;
+  }
+
+  FormatStyle Style = getLLVMStyle();
+};
+
+TEST_F(IncrementalFormatTest, FindsRegionBetweenDeclarations) {
+  StringRef Code = "int a;\n"
+                   "\n"
+                   "void f() {\n"
+                   "  int  x;\n"
+                   "}\n"
+                   "\n"
+                   "int  b;\n";
+  auto Region = findRegion(Code, 21, 0);
+  ASSERT_TRUE(Region.hasValue());
+  EXPECT_EQ(6u, Region->Offset);
+  EXPECT_EQ(24u, Region->Length);
+  EXPECT_EQ(0u, Region->LinesBefore);
+  EXPECT_EQ("int a;\n"
+            "\n"
+            "void f() { int x; }\n"
+            "\n"
+            "int  b;\n",
+            format(Code, 21, 0));
+
+  Region = findRegion(Code, 32, 0);
+  ASSERT_TRUE(Region.hasValue());
+  EXPECT_EQ(30u, Region->Offset);
+  EXPECT_EQ(10u, Region->Length);
+  EXPECT_EQ(4u, Region->LinesBefore);
+  verifyIncremental(Code, 32, 0);
+}
+
+TEST_F(IncrementalFormatTest, FormatsWholeFileWithoutBoundaries) {
+  // The range touches the end of the first declaration.
+  verifyIncremental("int  b;\n\nint a;", 7, 0, /*ExpectRegion=*/false);
+  // There is no empty line between the declarations.
+  verifyIncremental("int  a;\nint  b;\nint  c;", 8, 0,
+                    /*ExpectRegion=*/false);
+}
+
+TEST_F(IncrementalFormatTest, ExtendsUnknownDeclarationsToNextSemicolon) {
+  // The function is not known to end at the closing brace, so the empty line
+  // after it does not start a region.
+  StringRef Code = "void f() const {\n}\n\nint  a;\n\nint  b;";
+  auto Region = findRegion(Code, 20, 0);
+  ASSERT_TRUE(Region.hasValue());
+  EXPECT_EQ(0u, Region->Offset);
+  verifyIncremental(Code, 20, 0);
+  verifyIncremental(Code, 30, 0);
+}
+
+TEST_F(IncrementalFormatTest, StaysInsideUnindentedNamespaces) {
+  StringRef Code = "namespace n {\n"
+                   "\n"
+                   "int  a;\n"
+                   "\n"
+                   "int  b;\n"
+                   "\n"
+                   "int  c;\n"
+                   "\n"
+                   "} // namespace n\n";
+  verifyIncremental(Code, 26, 0);
+
+  Style.NamespaceIndentation = FormatStyle::NI_All;
+  verifyIncremental(Code, 26, 0, /*ExpectRegion=*/false);
+}
+
+TEST_F(IncrementalFormatTest, SkipsCommentsAndLiterals) {
+  StringRef Code = "const char *s = R\"x(\n"
+                   "\n"
+                   "int  x;\n"
+                   ")x\";\n"
+                   "\n"
+                   "/* {\n"
+                   "\n"
+                   "int  y; */\n"
+                   "int  z = 1'000;\n"
+                   "\n"
+                   "int  w;\n";
+  verifyIncremental(Code, 23, 0);
+  verifyIncremental(Code, 46, 0);
+  verifyIncremental(Code, 56, 0);
+}
+
+TEST_F(IncrementalFormatTest, RespectsClangFormatOff) {
+  StringRef Code = "// clang-format off\n"
+                   "int  a;\n"
+                   "\n"
+                   "int  b;\n"
+                   "// clang-format on\n"
+                   "\n"
+                   "int  c;\n"
+                   "\n"
+                   "int  d;\n";
+  verifyIncremental(Code, 29, 0);
+  EXPECT_EQ(0u, findRegion(Code, 29, 0)->Offset);
+  verifyIncremental(Code, 58, 0);
+}
+
+TEST_F(IncrementalFormatTest, DoesNotSplitPreprocessorConditionals) {
+  StringRef Code = "#if A\n"
+                   "int  a;\n"
+                   "\n"
+                   "int  b;\n"
+                   "#else\n"
+                   "int  c;\n"
+                   "\n"
+                   "int  d;\n"
+                   "#endif\n"
+                   "\n"
+                   "int  e;\n";
+  verifyIncremental(Code, 38, 0, /*ExpectRegion=*/false);
+  verifyIncremental(Code, 55, 0);
+}
+
+TEST_F(IncrementalFormatTest, DoesNotStartInUnreachableConditionals) {
+  for (StringRef If : {"#if 0\n", "#if false\n", "#ifdef SWIG\n"}) {
+    std::string Code = (If + "int  a;\n"
+                             "\n"
+                             "int  b;\n"
+                             "\n"
+                             "int  c;\n"
+                             "#endif\n"
+                             "\n"
+                             "int  d;\n")
+                           .str();
+    unsigned B = Code.find("int  b");
+    verifyIncremental(Code, B, 0);
+    EXPECT_EQ(0u, findRegion(Code, B, 0)->Offset);
+    verifyIncremental(Code, Code.find("int  d"), 0);
+  }
+
+  // Brackets in an unreachable branch do not affect the code after it.
+  StringRef Code = "#if 0\n"
+                   "void f() {\n"
+                   "#endif\n"
+                   "\n"
+                   "int  a;\n"
+                   "\n"
+                   "int  b;\n";
+  verifyIncremental(Code, 27, 0);
+  EXPECT_EQ(23u, findRegion(Code, 27, 0)->Offset);
+
+  // The other branches are formatted.
+  Code = "#if 0\n"
+         "int  a;\n"
+         "#else\n"
+         "int  b;\n"
+         "\n"
+         "int  c;\n"
+         "#endif\n";
+  verifyIncremental(Code, 29, 0, /*ExpectRegion=*/false);
+}
+
+TEST_F(IncrementalFormatTest, DerivesLineEndingFromWholeFile) {
+  // Most of the file uses CRLF, but the region around the range uses LF.
+  StringRef Code = "int a;\r\n"
+                   "\r\n"
+                   "int b;\r\n"
+                   "\r\n"
+                   "void f() {\n"
+                   "  int x; int y;\n"
+                   "}\n"
+                   "\r\n"
+                   "int c;\r\n";
+  auto Region = findRegion(Code, 33, 0);
+  ASSERT_TRUE(Region.hasValue());
+  EXPECT_EQ(16u, Region->Offset);
+  verifyIncremental(Code, 33, 0);
+  EXPECT_NE(std::string::npos, format(Code, 33, 0).find("int x;\r\n  int y;"));
+
+  Style.DeriveLineEnding = false;
+  verifyIncremental(Code, 33, 0);
+  EXPECT_NE(std::string::npos, format(Code, 33, 0).find("int x;\n  int y;"));
+}
+
+TEST_F(IncrementalFormatTest, ReusesCachedRegions) {
+  IncrementalFormatCache Cache;
+  StringRef Code = "int a;\n"
+                   "\n"
+                   "void f() {\n"
+                   "  int  x;\n"
+                   "}\n"
+                   "\n"
+                   "int  b;\n";
+  std::string Expected = format(Code, 21, 0);
+  EXPECT_EQ(Expected, format(Code, 21, 0, &Cache));
+  EXPECT_EQ(Expected, format(Code, 21, 0, &Cache));
+
+  // The same region at a different offset.
+  std::string Prefix = "int  c;\n\n";
+  EXPECT_EQ(Prefix + Expected,
+            format(Prefix + Code.str(), Prefix.size() + 21, 0, &Cache));
+}
+
+} // end namespace
+} // end namespace format
+} // end namespace clang
@@ -556,4 +556,28 @@ TEST_F(LexerTest, FindNextToken) {
   EXPECT_THAT(GeneratedByNextToken, ElementsAre("abcd", "=", "0", ";", "int",
                                                 "xyz", "=", "abcd", ";"));
 }
+
+TEST_F(LexerTest, LongTokensAndWhitespace) {
+  // Identifiers, string literals and runs of blanks long enough to go through
+  // the wide scanning paths, with the interesting characters placed after the
+  // first 16 bytes.
+  std::string Ident =
+      "abcdefghijklmnopqrstuvwxyz_ABCDEFGHIJKLMNOPQRSTUVWXYZ_0123";
+  std::string Str = "\"0123456789abcdefghijklmnopqrstuv\\\"wxyz 0123456789\"";
+  std::string Source = "int " + Ident + ";\n" +
+                       "\t\t                                   \t" +
+                       "const char *s = " + Str + ";\n" +
+                       "int" + std::string(40, ' ') + "y;";
+  std::vector<Token> toks = CheckLex(
+      Source, {tok::kw_int, tok::identifier, tok::semi, tok::kw_const,
+               tok::kw_char, tok::star, tok::identifier, tok::equal,
+               tok::string_literal, tok::semi, tok::kw_int, tok::identifier,
+               tok::semi});
+  ASSERT_EQ(toks.size(), 13u);
+  EXPECT_EQ(getSourceText(toks[1], toks[1]), Ident);
+  EXPECT_EQ(getSourceText(toks[8], toks[8]), Str);
+  EXPECT_TRUE(toks[3].isAtStartOfLine());
+  EXPECT_TRUE(toks[3].hasLeadingSpace());
+  EXPECT_TRUE(toks[11].hasLeadingSpace());
+}
 } // anonymous namespace
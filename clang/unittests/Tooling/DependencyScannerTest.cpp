@@ -14,9 +14,12 @@
 #include "clang/Frontend/FrontendAction.h"
 #include "clang/Frontend/FrontendActions.h"
 #include "clang/Tooling/CompilationDatabase.h"
+#include "clang/Tooling/DependencyScanning/DependencyScanningFilesystem.h"
 #include "clang/Tooling/Tooling.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
@@ -73,6 +76,21 @@ private:
   std::vector<std::string> &Deps;
 };
 
+/// Counts the real path lookups that reach the underlying file system.
+class RealPathCountingFileSystem : public llvm::vfs::ProxyFileSystem {
+public:
+  RealPathCountingFileSystem(IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS)
+      : ProxyFileSystem(std::move(FS)) {}
+
+  std::error_code getRealPath(const Twine &Path,
+                              SmallVectorImpl<char> &Output) const override {
+    ++NumRealPathCalls;
+    return ProxyFileSystem::getRealPath(Path, Output);
+  }
+
+  mutable unsigned NumRealPathCalls = 0;
+};
+
 } // namespace
 
 TEST(DependencyScanner, ScanDepsReuseFilemanager) {
@@ -196,5 +214,99 @@ TEST(DependencyScanner, ScanDepsReuseFilemanagerHasInclude) {
   EXPECT_EQ(convert_to_slash(Deps[5]), "/root/symlink.h");
 }
 
+TEST(DependencyScanner, RealPathIsSharedBetweenWorkers) {
+  using llvm::sys::path::convert_to_slash;
+  llvm::IntrusiveRefCntPtr<llvm::vfs::InMemoryFileSystem> InMemoryFS =
+      new llvm::vfs::InMemoryFileSystem();
+  InMemoryFS->setCurrentWorkingDirectory("/root");
+  InMemoryFS->addFile("/root/header.h", 0,
+                      llvm::MemoryBuffer::getMemBuffer("\n"));
+  llvm::IntrusiveRefCntPtr<RealPathCountingFileSystem> CountingFS =
+      new RealPathCountingFileSystem(InMemoryFS);
+
+  dependencies::DependencyScanningFilesystemSharedCache SharedCache;
+  dependencies::DependencyScanningWorkerFilesystem FirstWorkerFS(
+      SharedCache, CountingFS, nullptr);
+  dependencies::DependencyScanningWorkerFilesystem SecondWorkerFS(
+      SharedCache, CountingFS, nullptr);
+
+  SmallString<128> RealPath;
+  ASSERT_FALSE(FirstWorkerFS.getRealPath("/root/./header.h", RealPath));
+  EXPECT_EQ(convert_to_slash(RealPath), "/root/header.h");
+  EXPECT_EQ(1u, CountingFS->NumRealPathCalls);
+
+  // A relative path is looked up by its absolute path.
+  RealPath.clear();
+  ASSERT_FALSE(FirstWorkerFS.getRealPath("./header.h", RealPath));
+  EXPECT_EQ(convert_to_slash(RealPath), "/root/header.h");
+  EXPECT_EQ(1u, CountingFS->NumRealPathCalls);
+
+  // The other worker reuses the lookup of the first one.
+  RealPath.clear();
+  ASSERT_FALSE(SecondWorkerFS.getRealPath("/root/./header.h", RealPath));
+  EXPECT_EQ(convert_to_slash(RealPath), "/root/header.h");
+  EXPECT_EQ(1u, CountingFS->NumRealPathCalls);
+
+  RealPath.clear();
+  ASSERT_FALSE(SecondWorkerFS.getRealPath("/root/header.h", RealPath));
+  EXPECT_EQ(convert_to_slash(RealPath), "/root/header.h");
+  EXPECT_EQ(2u, CountingFS->NumRealPathCalls);
+}
+
+TEST(DependencyScanner, PersistentCacheRoundTrip) {
+  SmallString<128> CacheDir;
+  ASSERT_FALSE(
+      llvm::sys::fs::createUniqueDirectory("scan-deps-cache", CacheDir));
+
+  dependencies::DependencyScanningPersistentCache Cache(CacheDir);
+  StringRef Original = "#include \"a.h\"\nint x;\n#if 0\nint y;\n#endif\n";
+  StringRef Minimized = "#include \"a.h\"\n#if 0\n#endif\n";
+  EXPECT_FALSE(Cache.lookup(Original).hasValue());
+
+  PreprocessorSkippedRangeMapping Mapping;
+  Mapping[16] = 7;
+  Mapping[2] = 40;
+  Cache.store(Original, Minimized, Mapping);
+
+  auto Entry = Cache.lookup(Original);
+  ASSERT_TRUE(Entry.hasValue());
+  EXPECT_EQ(Entry->MinimizedContents, Minimized);
+  EXPECT_EQ(*Entry->MinimizedContents.end(), '\0');
+  EXPECT_EQ(Entry->PPSkippedRangeMapping, Mapping);
+
+  // Different contents must not hit the entry.
+  EXPECT_FALSE(Cache.lookup("int x;\n").hasValue());
+
+  // Neither must a different scanner version.
+  dependencies::DependencyScanningPersistentCache OtherVersionCache(
+      CacheDir, "other version");
+  EXPECT_FALSE(OtherVersionCache.lookup(Original).hasValue());
+
+  // An entry found under the name of another key, as after a hash collision,
+  // is not used.
+  StringRef Other = "int z;\n";
+  Cache.store(Other, "", PreprocessorSkippedRangeMapping());
+  std::string OriginalEntry, OtherEntry;
+  std::error_code EC;
+  for (llvm::sys::fs::directory_iterator I(CacheDir, EC), E; I != E && !EC;
+       I.increment(EC)) {
+    auto Buffer = llvm::MemoryBuffer::getFile(I->path());
+    ASSERT_TRUE(bool(Buffer));
+    if ((*Buffer)->getBuffer().find(Original) != StringRef::npos)
+      OriginalEntry = I->path();
+    else
+      OtherEntry = I->path();
+  }
+  ASSERT_FALSE(OriginalEntry.empty() || OtherEntry.empty());
+  ASSERT_FALSE(llvm::sys::fs::copy_file(OriginalEntry, OtherEntry));
+  EXPECT_FALSE(Cache.lookup(Other).hasValue());
+  EXPECT_TRUE(Cache.lookup(Original).hasValue());
+
+  EXPECT_EQ(2u, Cache.getNumHits());
+  EXPECT_EQ(3u, Cache.getNumMisses());
+
+  llvm::sys::fs::remove_directories(CacheDir);
+}
+
 } // end namespace tooling
 } // end namespace clang
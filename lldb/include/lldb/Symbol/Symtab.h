@@ -168,18 +168,22 @@ protected:
                           FileRangeToIndexMapCompare>
       FileRangeToIndexMap;
   void InitNameIndexes();
+  void InitDemangledNameIndexes();
+  void InitNameIndexesForLookup(ConstString name);
   void InitAddressIndexes();
 
   ObjectFile *m_objfile;
   collection m_symbols;
   FileRangeToIndexMap m_file_addr_to_index;
   UniqueCStringMap<uint32_t> m_name_to_index;
+  UniqueCStringMap<uint32_t> m_demangled_name_to_index;
   UniqueCStringMap<uint32_t> m_basename_to_index;
   UniqueCStringMap<uint32_t> m_method_to_index;
   UniqueCStringMap<uint32_t> m_selector_to_index;
   mutable std::recursive_mutex
       m_mutex; // Provide thread safety for this symbol table
-  bool m_file_addr_to_index_computed : 1, m_name_indexes_computed : 1;
+  bool m_file_addr_to_index_computed : 1, m_name_indexes_computed : 1,
+      m_demangled_name_indexes_computed : 1;
 
 private:
   bool CheckSymbolAtIndex(size_t idx, Debug symbol_debug_type,
@@ -215,15 +219,6 @@ private:
   void SymbolIndicesToSymbolContextList(std::vector<uint32_t> &symbol_indexes,
                                         SymbolContextList &sc_list);
 
-  void RegisterMangledNameEntry(
-      uint32_t value, std::set<const char *> &class_contexts,
-      std::vector<std::pair<NameToIndexMap::Entry, const char *>> &backlog,
-      RichManglingContext &rmc);
-
-  void RegisterBacklogEntry(const NameToIndexMap::Entry &entry,
-                            const char *decl_context,
-                            const std::set<const char *> &class_contexts);
-
   DISALLOW_COPY_AND_ASSIGN(Symtab);
 };
 
@@ -57,8 +57,18 @@ protected:
   InvalidRanges m_invalid_ranges;
   Process &m_process;
   uint32_t m_L2_cache_line_byte_size;
+  // The address of the last L2 cache line that had to be read from the
+  // process, used to detect sequential reads.
+  lldb::addr_t m_last_missed_line_addr;
 
 private:
+  /// Read the L2 cache line at \a addr together with the next few lines that
+  /// are not cached yet, all with a single request to the process.
+  ///
+  /// \return
+  ///     True if the line at \a addr could be read.
+  bool ReadAheadCacheLines(lldb::addr_t addr);
+
   DISALLOW_COPY_AND_ASSIGN(MemoryCache);
 };
 
@@ -1414,6 +1414,26 @@ public:
   virtual size_t DoReadMemory(lldb::addr_t vm_addr, void *buf, size_t size,
                               Status &error) = 0;
 
+  /// Actually do the reading of several ranges of memory from a process.
+  ///
+  /// Subclasses that can read several ranges with fewer requests than one
+  /// per range should override this function. Like DoReadMemory, they can
+  /// return fewer bytes than requested for any range. The default
+  /// implementation calls DoReadMemory once for each range.
+  ///
+  /// \param[in] ranges
+  ///     The virtual load address ranges to read.
+  ///
+  /// \param[out] buf
+  ///     A byte buffer that is at least as large as all \a ranges together.
+  ///     The bytes of each range are stored right after the ones of the
+  ///     previous range.
+  ///
+  /// \return
+  ///     The number of bytes that were actually read for each range.
+  virtual std::vector<size_t>
+  DoReadMemoryRanges(llvm::ArrayRef<LoadRange> ranges, uint8_t *buf);
+
   /// Read of memory from a process.
   ///
   /// This function will read memory from the current process's address space
@@ -1480,6 +1500,24 @@ public:
   size_t ReadMemoryFromInferior(lldb::addr_t vm_addr, void *buf, size_t size,
                                 Status &error);
 
+  /// Read several ranges of memory from a process, bypassing caching.
+  ///
+  /// This has the same semantics as calling ReadMemoryFromInferior for each
+  /// range, but lets the process plugin read all ranges at once.
+  ///
+  /// \param[in] ranges
+  ///     The virtual load address ranges to read.
+  ///
+  /// \param[out] buf
+  ///     A byte buffer that is at least as large as all \a ranges together.
+  ///     The bytes of each range are stored right after the ones of the
+  ///     previous range.
+  ///
+  /// \return
+  ///     The number of bytes that were actually read for each range.
+  std::vector<size_t>
+  ReadMemoryRangesFromInferior(llvm::ArrayRef<LoadRange> ranges, uint8_t *buf);
+
   /// Read a NULL terminated string from memory
   ///
   /// This function will read a cache page at a time until a NULL string
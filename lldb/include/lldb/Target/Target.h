@@ -88,6 +88,10 @@ public:
 
   void SetPreloadSymbols(bool b);
 
+  uint32_t GetPreloadSymbolsThreadCount() const;
+
+  void SetPreloadSymbolsThreadCount(uint32_t count);
+
   bool GetDisableASLR() const;
 
   void SetDisableASLR(bool b);
@@ -518,6 +522,24 @@ public:
   lldb::ModuleSP GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
                                    Status *error_ptr = nullptr);
 
+  /// Find or create the Modules for a batch of binaries that are about to be
+  /// added to the Target, and preload their symbols in parallel.
+  ///
+  /// This does not add the Modules to the Target. Later calls to
+  /// GetOrCreateModule with the same specifications find them in the shared
+  /// module cache with their symbols already loaded. Nothing is done unless
+  /// the target.preload-symbols setting is enabled, and the number of threads
+  /// used is bounded by target.preload-symbols-threads.
+  ///
+  /// \param[in] module_specs
+  ///     The binaries to preload. Specifications that match a Module already
+  ///     in the Target, or for which no binary can be found, are skipped.
+  ///
+  /// \return
+  ///     The Modules that were preloaded. The caller should keep this list
+  ///     alive until the Modules have been added to the Target.
+  ModuleList PreloadModules(llvm::ArrayRef<ModuleSpec> module_specs);
+
   // Settings accessors
 
   static const lldb::TargetPropertiesSP &GetGlobalProperties();
@@ -1357,6 +1379,13 @@ private:
 
   void AddBreakpoint(lldb::BreakpointSP breakpoint_sp, bool internal);
 
+  /// Find \a module_spec in the shared module cache, using the image search
+  /// paths and the platform, creating the Module if needed. The Module is not
+  /// added to the Target.
+  Status FindSharedModule(const ModuleSpec &module_spec,
+                          lldb::ModuleSP &module_sp,
+                          lldb::ModuleSP *old_module_sp_ptr);
+
   void FinalizeFileActions(ProcessLaunchInfo &info);
 
   DISALLOW_COPY_AND_ASSIGN(Target);
@@ -437,6 +437,23 @@ public:
   ///     in memory.
   static size_t StaticMemorySize();
 
+  /// Statistics about the global string pool.
+  struct PoolStatistics {
+    /// The number of unique strings in the pool.
+    size_t num_strings = 0;
+    /// The number of bytes taken by the strings and their bookkeeping.
+    size_t bytes_used = 0;
+    /// The number of bytes the pool has allocated, including its hash tables
+    /// and unused memory.
+    size_t bytes_allocated = 0;
+    /// The number of times a thread adding a string had to wait for another
+    /// thread adding a string to the same part of the pool.
+    uint64_t num_contended_inserts = 0;
+  };
+
+  /// Get statistics about the global string pool.
+  static PoolStatistics GetPoolStatistics();
+
 protected:
   template <typename T> friend struct ::llvm::DenseMapInfo;
   /// Only used by DenseMapInfo.
@@ -0,0 +1,46 @@
+"""
+Benchmark stepping in a function that is deep down the stack.
+"""
+
+from __future__ import print_function
+
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbbench import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class TestBenchmarkDeepStack(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        self.count = 50
+
+    @benchmarks_test
+    @no_debug_info_test
+    def test_run_step_over_with_deep_stack(self):
+        """Benchmark step-over and unwinding with a deep stack."""
+        print()
+        self.build()
+        self.run_steppings(self.count)
+        print("lldb deep stack stepping benchmark:", self.stopwatch)
+
+    def run_steppings(self, count):
+        (target, process, thread, bkpt) = lldbutil.run_to_source_breakpoint(
+            self, "// Break here", lldb.SBFileSpec("main.cpp"))
+        self.assertGreater(thread.GetNumFrames(), 500)
+
+        # Reset the stopwatch now.
+        self.stopwatch.reset()
+        for i in range(count):
+            with self.stopwatch:
+                thread.StepOver()
+                # Unwind the whole stack again, like a frontend showing the
+                # backtrace after each step does. Each frame needs a few memory
+                # reads from the stack.
+                thread.GetNumFrames()
+        self.assertEqual(process.GetState(), lldb.eStateStopped)
@@ -0,0 +1,14 @@
+static volatile int g_sink;
+
+static int recurse(int depth) {
+  if (depth == 0) {
+    for (int i = 0; i < 1000; ++i) {
+      g_sink += i; // Break here
+      g_sink -= i / 2;
+    }
+    return g_sink;
+  }
+  return recurse(depth - 1) + 1;
+}
+
+int main(int argc, char const *argv[]) { return recurse(500) != 0; }
@@ -9,6 +9,7 @@
 #include "CommandObjectStats.h"
 #include "lldb/Interpreter/CommandReturnObject.h"
 #include "lldb/Target/Target.h"
+#include "lldb/Utility/ConstString.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -85,6 +86,18 @@ protected:
           stat);
       i += 1;
     }
+
+    ConstString::PoolStatistics pool_stats = ConstString::GetPoolStatistics();
+    result.AppendMessageWithFormat("String pool strings : %" PRIu64 "\n",
+                                   uint64_t(pool_stats.num_strings));
+    result.AppendMessageWithFormat("String pool bytes used : %" PRIu64 "\n",
+                                   uint64_t(pool_stats.bytes_used));
+    result.AppendMessageWithFormat(
+        "String pool bytes allocated : %" PRIu64 "\n",
+        uint64_t(pool_stats.bytes_allocated));
+    result.AppendMessageWithFormat(
+        "String pool contended inserts : %" PRIu64 "\n",
+        pool_stats.num_contended_inserts);
     result.SetStatus(eReturnStatusSuccessFinishResult);
     return true;
   }
@@ -407,6 +407,16 @@ bool DynamicLoaderPOSIXDYLD::RendezvousBreakpointHit(
   return stop_when_images_change;
 }
 
+/// Preload the symbols of the shared libraries in [\a I, \a E) in parallel
+/// before they are added to \a target one at a time.
+static ModuleList PreloadModules(Target &target, DYLDRendezvous::iterator I,
+                                 DYLDRendezvous::iterator E) {
+  std::vector<ModuleSpec> module_specs;
+  for (; I != E; ++I)
+    module_specs.emplace_back(I->file_spec, target.GetArchitecture());
+  return target.PreloadModules(module_specs);
+}
+
 void DynamicLoaderPOSIXDYLD::RefreshModules() {
   if (!m_rendezvous.Resolve())
     return;
@@ -420,6 +430,8 @@ void DynamicLoaderPOSIXDYLD::RefreshModules() {
     ModuleList new_modules;
 
     E = m_rendezvous.loaded_end();
+    ModuleList preloaded_modules = PreloadModules(
+        m_process->GetTarget(), m_rendezvous.loaded_begin(), E);
     for (I = m_rendezvous.loaded_begin(); I != E; ++I) {
       ModuleSP module_sp =
           LoadModuleAtAddress(I->file_spec, I->link_addr, I->base_addr, true);
@@ -573,6 +585,8 @@ void DynamicLoaderPOSIXDYLD::LoadAllCurrentModules() {
     module_names.push_back(I->file_spec);
   m_process->PrefetchModuleSpecs(
       module_names, m_process->GetTarget().GetArchitecture().GetTriple());
+  ModuleList preloaded_modules = PreloadModules(
+      m_process->GetTarget(), m_rendezvous.begin(), m_rendezvous.end());
 
   for (I = m_rendezvous.begin(), E = m_rendezvous.end(); I != E; ++I) {
     ModuleSP module_sp =
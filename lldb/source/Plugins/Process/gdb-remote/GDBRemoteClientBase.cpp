@@ -9,9 +9,11 @@
 #include "GDBRemoteClientBase.h"
 
 #include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FormatVariadic.h"
 
 #include "lldb/Target/UnixSignals.h"
 #include "lldb/Utility/LLDBAssert.h"
+#include "lldb/Utility/RegularExpression.h"
 
 #include "ProcessGDBRemoteLog.h"
 
@@ -169,6 +171,106 @@ GDBRemoteClientBase::SendPacketAndWaitForResponse(
   return SendPacketAndWaitForResponseNoLock(payload, response);
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteClientBase::SendPacketsAndWaitForResponses(
+    llvm::ArrayRef<std::string> payloads,
+    std::vector<StringExtractorGDBRemote> &responses, bool send_async) {
+  Lock lock(*this, send_async);
+  if (!lock) {
+    if (Log *log =
+            ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_PROCESS))
+      LLDB_LOGF(log,
+                "GDBRemoteClientBase::%s failed to get mutex, not sending "
+                "%zu packets (send_async=%d)",
+                __FUNCTION__, payloads.size(), send_async);
+    return PacketResult::ErrorSendFailed;
+  }
+
+  responses.resize(payloads.size());
+
+  // With acks, the ack of a packet could arrive after the response of the
+  // previous one, so send the packets one at a time.
+  if (GetSendAcks()) {
+    for (size_t i = 0; i < payloads.size(); ++i) {
+      PacketResult packet_result =
+          SendPacketAndWaitForResponseNoLock(payloads[i], responses[i]);
+      if (packet_result != PacketResult::Success)
+        return packet_result;
+    }
+    return PacketResult::Success;
+  }
+
+  size_t num_sent = 0;
+  PacketResult packet_result = PacketResult::Success;
+  for (; num_sent < payloads.size(); ++num_sent) {
+    packet_result = SendPacketNoLock(payloads[num_sent]);
+    if (packet_result != PacketResult::Success)
+      break;
+  }
+
+  // The server answers the packets in the order it received them. Don't let
+  // ReadPacket sync on a timeout: it would take the response of the next
+  // packet in the batch as the response of the one that timed out.
+  size_t num_read = 0;
+  if (packet_result == PacketResult::Success) {
+    for (; num_read < payloads.size(); ++num_read) {
+      packet_result =
+          ReadResponseNoLock(payloads[num_read], responses[num_read], false);
+      if (packet_result != PacketResult::Success)
+        break;
+    }
+  }
+
+  // The responses to the packets we didn't read are still on their way and
+  // would be taken as the responses to later packets.
+  if (packet_result != PacketResult::Success && num_read < num_sent &&
+      IsConnected())
+    SyncAfterPipelinedPacketsNoLock(num_sent - num_read);
+  return packet_result;
+}
+
+bool GDBRemoteClientBase::SyncAfterPipelinedPacketsNoLock(
+    size_t num_outstanding) {
+  Log *log = ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_PACKETS);
+
+  // Like WaitForPacketNoLock does after a timeout, send a packet with a
+  // response we can recognize and drop everything that comes before it.
+  std::string echo_packet;
+  RegularExpression response_regex;
+  if (m_supports_qEcho == eLazyBoolYes) {
+    echo_packet = llvm::formatv("qEcho:{0}", ++m_echo_number).str();
+    response_regex = RegularExpression("^" + echo_packet + "$");
+  } else {
+    echo_packet = "qC";
+    response_regex = RegularExpression(llvm::StringRef("^QC[0-9A-Fa-f]+$"));
+  }
+
+  if (SendPacketNoLock(echo_packet) == PacketResult::Success) {
+    const size_t max_retries = num_outstanding + 3;
+    for (size_t i = 0; i < max_retries; ++i) {
+      StringExtractorGDBRemote response;
+      PacketResult packet_result =
+          ReadPacket(response, GetPacketTimeout(), false);
+      if (packet_result == PacketResult::Success) {
+        if (response_regex.Execute(response.GetStringRef()))
+          return true;
+        LLDB_LOGF(log,
+                  "GDBRemoteClientBase::%s discarding stale response \"%s\"",
+                  __FUNCTION__, response.GetStringRef().data());
+      } else if (packet_result != PacketResult::ErrorReplyTimeout) {
+        break;
+      }
+    }
+  }
+
+  // We weren't able to sync back up with the server. All following responses
+  // could be from the wrong packets, so give up on the connection.
+  LLDB_LOGF(log, "GDBRemoteClientBase::%s failed to sync, disconnecting",
+            __FUNCTION__);
+  Disconnect();
+  return false;
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteClientBase::SendPacketAndReceiveResponseWithOutputSupport(
     llvm::StringRef payload, StringExtractorGDBRemote &response,
@@ -200,9 +302,17 @@ GDBRemoteClientBase::SendPacketAndWaitForResponseNoLock(
   if (packet_result != PacketResult::Success)
     return packet_result;
 
+  return ReadResponseNoLock(payload, response, true);
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteClientBase::ReadResponseNoLock(llvm::StringRef payload,
+                                        StringExtractorGDBRemote &response,
+                                        bool sync_on_timeout) {
+  PacketResult packet_result = PacketResult::Success;
   const size_t max_response_retries = 3;
   for (size_t i = 0; i < max_response_retries; ++i) {
-    packet_result = ReadPacket(response, GetPacketTimeout(), true);
+    packet_result = ReadPacket(response, GetPacketTimeout(), sync_on_timeout);
     // Make sure we received a response
     if (packet_result != PacketResult::Success)
       return packet_result;
@@ -45,6 +45,16 @@ public:
                                             StringExtractorGDBRemote &response,
                                             bool send_async);
 
+  /// Send all \a payloads and then read one response for each of them. If
+  /// the packets don't need to be acknowledged, they are sent without waiting
+  /// for the responses of the previous ones, so that several requests only
+  /// cost a single round trip. Response validators set on the elements of
+  /// \a responses are honored. If a response can't be read, the ones still
+  /// outstanding are discarded so that later packets get their own responses.
+  PacketResult SendPacketsAndWaitForResponses(
+      llvm::ArrayRef<std::string> payloads,
+      std::vector<StringExtractorGDBRemote> &responses, bool send_async);
+
   PacketResult SendPacketAndReceiveResponseWithOutputSupport(
       llvm::StringRef payload, StringExtractorGDBRemote &response,
       bool send_async,
@@ -78,6 +88,17 @@ protected:
   SendPacketAndWaitForResponseNoLock(llvm::StringRef payload,
                                      StringExtractorGDBRemote &response);
 
+  /// Read the response to \a payload, skipping responses that \a response's
+  /// validator rejects.
+  PacketResult ReadResponseNoLock(llvm::StringRef payload,
+                                  StringExtractorGDBRemote &response,
+                                  bool sync_on_timeout);
+
+  /// Discard the responses to the \a num_outstanding pipelined packets that
+  /// are still in flight. Disconnects and returns false if the server didn't
+  /// answer a sync packet.
+  bool SyncAfterPipelinedPacketsNoLock(size_t num_outstanding);
+
   virtual void OnRunPacketSent(bool first);
 
 private:
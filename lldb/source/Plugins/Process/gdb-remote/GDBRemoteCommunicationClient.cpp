@@ -81,6 +81,7 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient()
       m_supports_jLoadedDynamicLibrariesInfos(eLazyBoolCalculate),
       m_supports_jGetSharedCacheInfo(eLazyBoolCalculate),
       m_supports_QPassSignals(eLazyBoolCalculate),
+      m_supports_MultiMemRead(eLazyBoolCalculate),
       m_supports_error_string_reply(eLazyBoolCalculate),
       m_supports_qProcessInfoPID(true), m_supports_qfProcessInfo(true),
       m_supports_qUserName(true), m_supports_qGroupName(true),
@@ -143,6 +144,13 @@ bool GDBRemoteCommunicationClient::GetEchoSupported() {
   return m_supports_qEcho == eLazyBoolYes;
 }
 
+bool GDBRemoteCommunicationClient::GetMultiMemReadSupported() {
+  if (m_supports_MultiMemRead == eLazyBoolCalculate) {
+    GetRemoteQSupported();
+  }
+  return m_supports_MultiMemRead == eLazyBoolYes;
+}
+
 bool GDBRemoteCommunicationClient::GetQPassSignalsSupported() {
   if (m_supports_QPassSignals == eLazyBoolCalculate) {
     GetRemoteQSupported();
@@ -291,6 +299,7 @@ void GDBRemoteCommunicationClient::ResetDiscoverableSettings(bool did_exec) {
     m_supports_qXfer_features_read = eLazyBoolCalculate;
     m_supports_qXfer_memory_map_read = eLazyBoolCalculate;
     m_supports_augmented_libraries_svr4_read = eLazyBoolCalculate;
+    m_supports_MultiMemRead = eLazyBoolCalculate;
     m_supports_qProcessInfoPID = true;
     m_supports_qfProcessInfo = true;
     m_supports_qUserName = true;
@@ -335,6 +344,7 @@ void GDBRemoteCommunicationClient::GetRemoteQSupported() {
   m_supports_augmented_libraries_svr4_read = eLazyBoolNo;
   m_supports_qXfer_features_read = eLazyBoolNo;
   m_supports_qXfer_memory_map_read = eLazyBoolNo;
+  m_supports_MultiMemRead = eLazyBoolNo;
   m_max_packet_size = UINT64_MAX; // It's supposed to always be there, but if
                                   // not, we assume no limit
 
@@ -371,6 +381,8 @@ void GDBRemoteCommunicationClient::GetRemoteQSupported() {
       m_supports_qXfer_features_read = eLazyBoolYes;
     if (::strstr(response_cstr, "qXfer:memory-map:read+"))
       m_supports_qXfer_memory_map_read = eLazyBoolYes;
+    if (::strstr(response_cstr, "MultiMemRead+"))
+      m_supports_MultiMemRead = eLazyBoolYes;
 
     // Look for a list of compressions in the features list e.g.
     // qXfer:features:read+;PacketSize=20000;qEcho+;SupportedCompressions=zlib-
@@ -653,6 +665,79 @@ bool GDBRemoteCommunicationClient::GetxPacketSupported() {
   return m_supports_x;
 }
 
+std::vector<size_t> GDBRemoteCommunicationClient::ReadMemoryRanges(
+    llvm::ArrayRef<std::pair<lldb::addr_t, size_t>> ranges, uint8_t *buf) {
+  std::vector<size_t> bytes_read(ranges.size(), 0);
+  if (ranges.empty())
+    return bytes_read;
+
+  if (GetMultiMemReadSupported()) {
+    StreamString packet;
+    packet.PutCString("MultiMemRead:ranges:");
+    for (size_t i = 0; i < ranges.size(); ++i)
+      packet.Printf("%s%" PRIx64 ",%" PRIx64, i == 0 ? "" : ",",
+                    uint64_t(ranges[i].first), uint64_t(ranges[i].second));
+    packet.PutChar(';');
+
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse(packet.GetString(), response, true) !=
+            PacketResult::Success ||
+        !response.IsNormalResponse())
+      return bytes_read;
+
+    // The response is <len>[,<len>]*;<bytes>. The lower level packet receive
+    // layer has already de-quoted any 0x7d character escaping in the bytes.
+    llvm::StringRef lengths, data;
+    std::tie(lengths, data) = response.GetStringRef().split(';');
+    for (size_t i = 0; i < ranges.size() && !lengths.empty(); ++i) {
+      llvm::StringRef length_str;
+      std::tie(length_str, lengths) = lengths.split(',');
+      uint64_t length;
+      if (length_str.getAsInteger(16, length) || length > ranges[i].second ||
+          length > data.size())
+        break;
+      memcpy(buf, data.data(), length);
+      data = data.drop_front(length);
+      bytes_read[i] = length;
+      buf += ranges[i].second;
+    }
+    return bytes_read;
+  }
+
+  const bool binary_memory_read = GetxPacketSupported();
+  std::vector<std::string> packets;
+  packets.reserve(ranges.size());
+  for (const auto &range : ranges)
+    packets.push_back(llvm::formatv("{0}{1:x-},{2:x-}",
+                                    binary_memory_read ? 'x' : 'm',
+                                    range.first, range.second)
+                          .str());
+
+  std::vector<StringExtractorGDBRemote> responses(ranges.size());
+  if (!binary_memory_read)
+    for (StringExtractorGDBRemote &response : responses)
+      response.SetResponseValidatorToASCIIHexBytes();
+  if (SendPacketsAndWaitForResponses(packets, responses, true) !=
+      PacketResult::Success)
+    return bytes_read;
+
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    StringExtractorGDBRemote &response = responses[i];
+    if (response.IsNormalResponse()) {
+      if (binary_memory_read) {
+        bytes_read[i] =
+            std::min(ranges[i].second, response.GetStringRef().size());
+        memcpy(buf, response.GetStringRef().data(), bytes_read[i]);
+      } else {
+        bytes_read[i] = response.GetHexBytes(
+            llvm::MutableArrayRef<uint8_t>(buf, ranges[i].second), '\xdd');
+      }
+    }
+    buf += ranges[i].second;
+  }
+  return bytes_read;
+}
+
 GDBRemoteCommunicationClient::PacketResult
 GDBRemoteCommunicationClient::SendPacketsAndConcatenateResponses(
     const char *payload_prefix, std::string &response_string) {
@@ -237,6 +237,25 @@ public:
 
   bool GetxPacketSupported();
 
+  bool GetMultiMemReadSupported();
+
+  /// Read the memory of several ranges with a single MultiMemRead packet if
+  /// the server supports it, or with one x or m packet per range otherwise.
+  ///
+  /// \param[in] ranges
+  ///     The address and size of each range to read.
+  ///
+  /// \param[out] buf
+  ///     A byte buffer that is at least as large as all \a ranges together.
+  ///     The bytes of each range are stored right after the ones of the
+  ///     previous range.
+  ///
+  /// \return
+  ///     The number of bytes that were read for each range.
+  std::vector<size_t>
+  ReadMemoryRanges(llvm::ArrayRef<std::pair<lldb::addr_t, size_t>> ranges,
+                   uint8_t *buf);
+
   bool GetVAttachOrWaitSupported();
 
   bool GetSyncThreadStateSupported();
@@ -529,6 +548,7 @@ protected:
   LazyBool m_supports_jLoadedDynamicLibrariesInfos;
   LazyBool m_supports_jGetSharedCacheInfo;
   LazyBool m_supports_QPassSignals;
+  LazyBool m_supports_MultiMemRead;
   LazyBool m_supports_error_string_reply;
 
   bool m_supports_qProcessInfoPID : 1, m_supports_qfProcessInfo : 1,
@@ -92,6 +92,9 @@ void GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers() {
       &GDBRemoteCommunicationServerLLGS::Handle_memory_read);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_M,
                                 &GDBRemoteCommunicationServerLLGS::Handle_M);
+  RegisterMemberFunctionHandler(
+      StringExtractorGDBRemote::eServerPacketType_MultiMemRead,
+      &GDBRemoteCommunicationServerLLGS::Handle_MultiMemRead);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_p,
                                 &GDBRemoteCommunicationServerLLGS::Handle_p);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_P,
@@ -2335,6 +2338,81 @@ GDBRemoteCommunicationServerLLGS::Handle_memory_read(
   return SendPacketNoLock(response.GetString());
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_MultiMemRead(
+    StringExtractorGDBRemote &packet) {
+  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+  if (!m_debugged_process_up ||
+      (m_debugged_process_up->GetID() == LLDB_INVALID_PROCESS_ID)) {
+    LLDB_LOGF(
+        log,
+        "GDBRemoteCommunicationServerLLGS::%s failed, no process available",
+        __FUNCTION__);
+    return SendErrorResponse(0x15);
+  }
+
+  // Parse out the ranges: MultiMemRead:ranges:<addr>,<len>[,<addr>,<len>]*;
+  packet.SetFilePos(strlen("MultiMemRead:"));
+  llvm::StringRef ranges_str;
+  while (packet.GetBytesLeft() > 0) {
+    llvm::StringRef key, value;
+    if (!packet.GetNameColonValue(key, value))
+      return SendIllFormedResponse(packet, "Invalid MultiMemRead packet");
+    if (key == "ranges")
+      ranges_str = value;
+  }
+  if (ranges_str.empty())
+    return SendIllFormedResponse(packet,
+                                 "Ranges missing in MultiMemRead packet");
+
+  // The response lists the number of bytes read for each range, followed by
+  // the bytes of all ranges: <len>[,<len>]*;<bytes>
+  StreamGDBRemote response;
+  std::string bytes;
+  uint64_t total_byte_count = 0;
+  while (!ranges_str.empty()) {
+    llvm::StringRef addr_str, len_str;
+    std::tie(addr_str, ranges_str) = ranges_str.split(',');
+    std::tie(len_str, ranges_str) = ranges_str.split(',');
+    lldb::addr_t read_addr;
+    uint64_t byte_count;
+    if (addr_str.getAsInteger(16, read_addr) ||
+        len_str.getAsInteger(16, byte_count))
+      return SendIllFormedResponse(packet,
+                                   "Invalid range in MultiMemRead packet");
+    // Don't read more than we said we can send back in qSupported.
+    total_byte_count += byte_count;
+    if (total_byte_count > 128 * 1024)
+      return SendErrorResponse(0x78);
+
+    size_t bytes_read = 0;
+    if (byte_count > 0) {
+      const size_t offset = bytes.size();
+      bytes.resize(offset + byte_count);
+      Status error = m_debugged_process_up->ReadMemoryWithoutTrap(
+          read_addr, &bytes[offset], byte_count, bytes_read);
+      if (error.Fail()) {
+        LLDB_LOGF(log,
+                  "GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64
+                  " mem 0x%" PRIx64 ": failed to read. Error: %s",
+                  __FUNCTION__, m_debugged_process_up->GetID(), read_addr,
+                  error.AsCString());
+      }
+      // Only the bytes before the first unreadable one are reported.
+      bytes.resize(offset + bytes_read);
+    }
+
+    if (response.GetSize() > 0)
+      response.PutChar(',');
+    response.Printf("%" PRIx64, uint64_t(bytes_read));
+  }
+  response.PutChar(';');
+  response.PutEscapedBytes(bytes.data(), bytes.size());
+
+  return SendPacketNoLock(response.GetString());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_M(StringExtractorGDBRemote &packet) {
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
@@ -139,6 +139,8 @@ protected:
 
   PacketResult Handle_M(StringExtractorGDBRemote &packet);
 
+  PacketResult Handle_MultiMemRead(StringExtractorGDBRemote &packet);
+
   PacketResult
   Handle_qMemoryRegionInfoSupported(StringExtractorGDBRemote &packet);
 
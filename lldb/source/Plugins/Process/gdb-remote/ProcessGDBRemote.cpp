@@ -2752,6 +2752,56 @@ size_t ProcessGDBRemote::DoReadMemory(addr_t addr, void *buf, size_t size,
   return 0;
 }
 
+std::vector<size_t>
+ProcessGDBRemote::DoReadMemoryRanges(llvm::ArrayRef<LoadRange> ranges,
+                                     uint8_t *buf) {
+  GetMaxMemorySize();
+  // M and m packets take 2 bytes for 1 byte of memory
+  const size_t max_memory_size = m_gdb_comm.GetMultiMemReadSupported() ||
+                                         m_gdb_comm.GetxPacketSupported()
+                                     ? m_max_memory_size
+                                     : m_max_memory_size / 2;
+
+  // Read the ranges in batches that fit into a single response packet, or
+  // into the packets of a single round trip.
+  std::vector<size_t> bytes_read;
+  bytes_read.reserve(ranges.size());
+  std::vector<std::pair<lldb::addr_t, size_t>> batch;
+  uint8_t *batch_buf = buf;
+  size_t batch_size = 0;
+  auto read_batch = [&]() {
+    if (batch.empty())
+      return;
+    std::vector<size_t> batch_bytes_read =
+        m_gdb_comm.ReadMemoryRanges(batch, batch_buf);
+    bytes_read.insert(bytes_read.end(), batch_bytes_read.begin(),
+                      batch_bytes_read.end());
+    batch.clear();
+    batch_buf += batch_size;
+    batch_size = 0;
+  };
+
+  for (const LoadRange &range : ranges) {
+    const size_t size = range.GetByteSize();
+    if (batch_size + size > max_memory_size)
+      read_batch();
+
+    if (size > max_memory_size) {
+      // This range needs several packets on its own.
+      Status error;
+      bytes_read.push_back(
+          DoReadMemory(range.GetRangeBase(), batch_buf, size, error));
+      batch_buf += size;
+      continue;
+    }
+
+    batch.emplace_back(range.GetRangeBase(), size);
+    batch_size += size;
+  }
+  read_batch();
+  return bytes_read;
+}
+
 Status ProcessGDBRemote::WriteObjectFile(
     std::vector<ObjectFile::LoadableData> entries) {
   Status error;
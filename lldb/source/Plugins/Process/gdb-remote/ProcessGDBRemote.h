@@ -133,6 +133,9 @@ public:
   size_t DoReadMemory(lldb::addr_t addr, void *buf, size_t size,
                       Status &error) override;
 
+  std::vector<size_t> DoReadMemoryRanges(llvm::ArrayRef<LoadRange> ranges,
+                                         uint8_t *buf) override;
+
   Status
   WriteObjectFile(std::vector<ObjectFile::LoadableData> entries) override;
 
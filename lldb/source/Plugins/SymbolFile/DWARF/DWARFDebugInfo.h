@@ -34,6 +34,8 @@ public:
   explicit DWARFDebugInfo(SymbolFileDWARF &dwarf,
                           lldb_private::DWARFContext &context);
 
+  SymbolFileDWARF &GetSymbolFileDWARF() const { return m_dwarf; }
+
   size_t GetNumUnits();
   DWARFUnit *GetUnitAtIndex(lldb::user_id_t idx);
   DWARFUnit *GetUnitAtOffset(DIERef::Section section, dw_offset_t cu_offset,
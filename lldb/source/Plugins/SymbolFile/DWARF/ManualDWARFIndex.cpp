@@ -13,10 +13,22 @@
 #include "Plugins/SymbolFile/DWARF/LogChannelDWARF.h"
 #include "Plugins/SymbolFile/DWARF/SymbolFileDWARFDwo.h"
 #include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleList.h"
+#include "lldb/Host/FileSystem.h"
 #include "lldb/Host/TaskPool.h"
 #include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Utility/DataExtractor.h"
+#include "lldb/Utility/Log.h"
 #include "lldb/Utility/Stream.h"
 #include "lldb/Utility/Timer.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
 
 using namespace lldb_private;
 using namespace lldb;
@@ -31,6 +43,11 @@ void ManualDWARFIndex::Index() {
   static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
   Timer scoped_timer(func_cat, "%p", static_cast<void *>(&debug_info));
 
+  ObjectFile &objfile = *debug_info.GetSymbolFileDWARF().GetObjectFile();
+  std::string cache_path = GetCacheFilePath(objfile);
+  if (!cache_path.empty() && LoadFromCache(cache_path, objfile))
+    return;
+
   std::vector<DWARFUnit *> units_to_index;
   units_to_index.reserve(debug_info.GetNumUnits());
   for (size_t U = 0; U < debug_info.GetNumUnits(); ++U) {
@@ -85,6 +102,224 @@ void ManualDWARFIndex::Index() {
                      [&]() { finalize_fn(&IndexSet::globals); },
                      [&]() { finalize_fn(&IndexSet::types); },
                      [&]() { finalize_fn(&IndexSet::namespaces); });
+
+  // Split DWARF units refer to .dwo files that can change independently of
+  // this module, so only cache indexes that do not depend on them.
+  if (!cache_path.empty() &&
+      llvm::none_of(units_to_index, [](DWARFUnit *unit) {
+        return unit->GetDwoSymbolFile() != nullptr;
+      }))
+    SaveToCache(cache_path, objfile);
+}
+
+// The index cache file starts with a header identifying the module and the
+// object file holding its DWARF, followed by a table of all names and then the
+// entries of each NameToDIE map, which refer to names by their index in the
+// table. All integers are little endian.
+static const char g_cache_magic[] = "lldb-dwarf-index";
+static const uint32_t g_cache_version = 2;
+
+static uint64_t GetModificationTimeKey(llvm::sys::TimePoint<> time) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             time.time_since_epoch())
+      .count();
+}
+
+static uint64_t GetModificationTimeKey(ObjectFile &objfile) {
+  return GetModificationTimeKey(
+      FileSystem::Instance().GetModificationTime(objfile.GetFileSpec()));
+}
+
+// Packs everything in a DIERef except the DIE offset into 32 bits.
+static uint32_t EncodeDIERefLocation(const DIERef &ref) {
+  uint32_t bits = ref.section() == DIERef::DebugTypes ? 1 : 0;
+  if (llvm::Optional<uint32_t> dwo_num = ref.dwo_num())
+    bits |= 2 | (*dwo_num << 2);
+  return bits;
+}
+
+static DIERef DecodeDIERef(uint32_t bits, dw_offset_t die_offset) {
+  llvm::Optional<uint32_t> dwo_num;
+  if (bits & 2)
+    dwo_num = bits >> 2;
+  return DIERef(dwo_num, bits & 1 ? DIERef::DebugTypes : DIERef::DebugInfo,
+                die_offset);
+}
+
+std::string ManualDWARFIndex::GetCacheFilePath(ObjectFile &objfile) {
+  FileSpec cache_dir =
+      ModuleList::GetGlobalModuleListProperties().GetDWARFIndexCachePath();
+  // An index that skips some units is specific to the accelerator tables
+  // that cover them, so it is not worth caching.
+  if (!cache_dir || !m_units_to_avoid.empty())
+    return std::string();
+  const UUID &uuid = m_module.GetUUID();
+  if (!uuid.IsValid())
+    return std::string();
+
+  // The DWARF may come from a separate debug file, which can be replaced
+  // without changing the module, so it is part of the key.
+  std::string key = llvm::formatv(
+      "{0}:{1}:{2}", GetModificationTimeKey(m_module.GetModificationTime()),
+      GetModificationTimeKey(objfile), objfile.GetFileSpec().GetPath());
+
+  llvm::SmallString<128> path(cache_dir.GetPath());
+  llvm::sys::path::append(path, llvm::formatv("{0}-{1:x-}.dwarf-index",
+                                              uuid.GetAsString(""),
+                                              llvm::xxHash64(key))
+                                    .str());
+  return path.str();
+}
+
+bool ManualDWARFIndex::LoadFromCache(llvm::StringRef path,
+                                     ObjectFile &objfile) {
+  auto buffer_or_error =
+      llvm::MemoryBuffer::getFile(path, /*FileSize=*/-1,
+                                  /*RequiresNullTerminator=*/false);
+  if (!buffer_or_error)
+    return false;
+  const llvm::MemoryBuffer &buffer = **buffer_or_error;
+  DataExtractor data(buffer.getBufferStart(), buffer.getBufferSize(),
+                     eByteOrderLittle, /*addr_size=*/8);
+
+  lldb::offset_t offset = 0;
+  const char *magic = data.GetCStr(&offset);
+  if (!magic || llvm::StringRef(magic) != g_cache_magic ||
+      data.GetU32(&offset) != g_cache_version)
+    return false;
+  const uint32_t uuid_size = data.GetU32(&offset);
+  const void *uuid_bytes = data.GetData(&offset, uuid_size);
+  if (!uuid_bytes ||
+      UUID::fromData(uuid_bytes, uuid_size) != m_module.GetUUID() ||
+      data.GetU64(&offset) !=
+          GetModificationTimeKey(m_module.GetModificationTime()))
+    return false;
+  const char *objfile_path = data.GetCStr(&offset);
+  if (!objfile_path || objfile_path != objfile.GetFileSpec().GetPath() ||
+      data.GetU64(&offset) != GetModificationTimeKey(objfile))
+    return false;
+
+  auto fail = [this]() {
+    m_set = IndexSet();
+    return false;
+  };
+
+  const uint32_t num_strings = data.GetU32(&offset);
+  if (!data.ValidOffsetForDataOfSize(offset, num_strings))
+    return false;
+  std::vector<ConstString> strings;
+  strings.reserve(num_strings);
+  for (uint32_t i = 0; i < num_strings; ++i) {
+    const char *str = data.GetCStr(&offset);
+    if (!str)
+      return false;
+    strings.emplace_back(str);
+  }
+
+  for (NameToDIE *index : m_set.GetAll()) {
+    const uint32_t num_entries = data.GetU32(&offset);
+    if (!data.ValidOffsetForDataOfSize(offset, uint64_t(num_entries) * 12))
+      return fail();
+    for (uint32_t i = 0; i < num_entries; ++i) {
+      const uint32_t name_idx = data.GetU32(&offset);
+      const uint32_t location = data.GetU32(&offset);
+      const dw_offset_t die_offset = data.GetU32(&offset);
+      if (name_idx >= strings.size())
+        return fail();
+      index->Insert(strings[name_idx], DecodeDIERef(location, die_offset));
+    }
+    index->Finalize();
+  }
+  // DataExtractor reads past the end as zeros, so a truncated file is only
+  // noticed here.
+  if (offset != data.GetByteSize())
+    return fail();
+
+  Log *log = LogChannelDWARF::GetLogIfAll(DWARF_LOG_LOOKUPS);
+  LLDB_LOG(log, "loaded DWARF index of {0} from {1}",
+           m_module.GetFileSpec(), path);
+  return true;
+}
+
+void ManualDWARFIndex::SaveToCache(llvm::StringRef path,
+                                   ObjectFile &objfile) {
+  Log *log = LogChannelDWARF::GetLogIfAll(DWARF_LOG_LOOKUPS);
+  if (std::error_code ec = llvm::sys::fs::create_directories(
+          llvm::sys::path::parent_path(path))) {
+    LLDB_LOG(log, "failed to create DWARF index cache directory: {0}",
+             ec.message());
+    return;
+  }
+
+  // Names are unique ConstStrings, so their pointers identify them.
+  llvm::DenseMap<const char *, uint32_t> string_ids;
+  std::vector<ConstString> strings;
+  for (NameToDIE *index : m_set.GetAll()) {
+    index->ForEach([&](ConstString name, const DIERef &) {
+      if (string_ids.try_emplace(name.GetCString(), strings.size()).second)
+        strings.push_back(name);
+      return true;
+    });
+  }
+
+  // Write to a temporary file first so that concurrent debug sessions never
+  // see a partial index.
+  llvm::Expected<llvm::sys::fs::TempFile> temp =
+      llvm::sys::fs::TempFile::create(path + "-%%%%%%%%");
+  if (!temp) {
+    LLDB_LOG_ERROR(log, temp.takeError(),
+                   "failed to create DWARF index cache file: {0}");
+    return;
+  }
+
+  {
+    llvm::raw_fd_ostream os(temp->FD, /*shouldClose=*/false);
+    llvm::support::endian::Writer writer(os, llvm::support::little);
+    os.write(g_cache_magic, sizeof(g_cache_magic));
+    writer.write<uint32_t>(g_cache_version);
+    llvm::ArrayRef<uint8_t> uuid = m_module.GetUUID().GetBytes();
+    writer.write<uint32_t>(uuid.size());
+    os.write(reinterpret_cast<const char *>(uuid.data()), uuid.size());
+    writer.write<uint64_t>(
+        GetModificationTimeKey(m_module.GetModificationTime()));
+    std::string objfile_path = objfile.GetFileSpec().GetPath();
+    os.write(objfile_path.c_str(), objfile_path.size() + 1);
+    writer.write<uint64_t>(GetModificationTimeKey(objfile));
+
+    writer.write<uint32_t>(strings.size());
+    for (ConstString str : strings)
+      os.write(str.GetCString(), str.GetLength() + 1);
+
+    for (NameToDIE *index : m_set.GetAll()) {
+      uint32_t num_entries = 0;
+      index->ForEach([&](ConstString, const DIERef &) {
+        ++num_entries;
+        return true;
+      });
+      writer.write<uint32_t>(num_entries);
+      index->ForEach([&](ConstString name, const DIERef &ref) {
+        writer.write<uint32_t>(string_ids[name.GetCString()]);
+        writer.write<uint32_t>(EncodeDIERefLocation(ref));
+        writer.write<uint32_t>(ref.die_offset());
+        return true;
+      });
+    }
+    os.flush();
+    if (os.has_error()) {
+      os.clear_error();
+      llvm::consumeError(temp->discard());
+      LLDB_LOG(log, "failed to write DWARF index cache file {0}", path);
+      return;
+    }
+  }
+
+  if (llvm::Error error = temp->keep(path)) {
+    LLDB_LOG_ERROR(log, std::move(error),
+                   "failed to write DWARF index cache file: {0}");
+    return;
+  }
+  LLDB_LOG(log, "saved DWARF index of {0} to {1}", m_module.GetFileSpec(),
+           path);
 }
 
 void ManualDWARFIndex::IndexUnit(DWARFUnit &unit, IndexSet &set) {
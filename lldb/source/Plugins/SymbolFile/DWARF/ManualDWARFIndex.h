@@ -12,6 +12,7 @@
 #include "Plugins/SymbolFile/DWARF/DWARFIndex.h"
 #include "Plugins/SymbolFile/DWARF/NameToDIE.h"
 #include "llvm/ADT/DenseSet.h"
+#include <array>
 
 class DWARFDebugInfo;
 
@@ -54,8 +55,29 @@ private:
     NameToDIE globals;
     NameToDIE types;
     NameToDIE namespaces;
+
+    /// All of the above, in the order they are stored in the index cache.
+    std::array<NameToDIE *, 8> GetAll() {
+      return {{&function_basenames, &function_fullnames, &function_methods,
+               &function_selectors, &objc_class_selectors, &globals, &types,
+               &namespaces}};
+    }
   };
   void Index();
+
+  /// Returns the path of the file that holds the index of the DWARF in
+  /// \a objfile in the directory set by "symbols.dwarf-index-cache-path", or
+  /// an empty string if the index should not be cached. \a objfile is the
+  /// module's object file, or its separate debug file.
+  std::string GetCacheFilePath(ObjectFile &objfile);
+
+  /// Reads the index from the given cache file. Returns false and leaves the
+  /// index empty if the file is missing, damaged or was not built from this
+  /// module and \a objfile.
+  bool LoadFromCache(llvm::StringRef path, ObjectFile &objfile);
+
+  /// Writes the index to the given cache file.
+  void SaveToCache(llvm::StringRef path, ObjectFile &objfile);
   void IndexUnit(DWARFUnit &unit, IndexSet &set);
 
   static void IndexUnitImpl(DWARFUnit &unit,
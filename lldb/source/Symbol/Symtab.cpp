@@ -14,6 +14,7 @@
 #include "lldb/Core/Module.h"
 #include "lldb/Core/RichManglingContext.h"
 #include "lldb/Core/Section.h"
+#include "lldb/Host/TaskPool.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/Symbol.h"
 #include "lldb/Symbol/SymbolContext.h"
@@ -30,7 +31,8 @@ using namespace lldb_private;
 Symtab::Symtab(ObjectFile *objfile)
     : m_objfile(objfile), m_symbols(), m_file_addr_to_index(*this),
       m_name_to_index(), m_mutex(), m_file_addr_to_index_computed(false),
-      m_name_indexes_computed(false) {}
+      m_name_indexes_computed(false),
+      m_demangled_name_indexes_computed(false) {}
 
 Symtab::~Symtab() {}
 
@@ -52,10 +54,12 @@ uint32_t Symtab::AddSymbol(const Symbol &symbol) {
   // when calling this function to avoid performance issues.
   uint32_t symbol_idx = m_symbols.size();
   m_name_to_index.Clear();
+  m_demangled_name_to_index.Clear();
   m_file_addr_to_index.Clear();
   m_symbols.push_back(symbol);
   m_file_addr_to_index_computed = false;
   m_name_indexes_computed = false;
+  m_demangled_name_indexes_computed = false;
   return symbol_idx;
 }
 
@@ -66,6 +70,7 @@ size_t Symtab::GetNumSymbols() const {
 
 void Symtab::SectionFileAddressesChanged() {
   m_name_to_index.Clear();
+  m_demangled_name_to_index.Clear();
   m_file_addr_to_index_computed = false;
 }
 
@@ -257,15 +262,9 @@ void Symtab::InitNameIndexes() {
     const size_t num_symbols = m_symbols.size();
     m_name_to_index.Reserve(num_symbols);
 
-    // The "const char *" in "class_contexts" and backlog::value_type::second
-    // must come from a ConstString::GetCString()
-    std::set<const char *> class_contexts;
-    std::vector<std::pair<NameToIndexMap::Entry, const char *>> backlog;
-    backlog.reserve(num_symbols / 2);
-
-    // Instantiation of the demangler is expensive, so better use a single one
-    // for all entries during batch processing.
-    RichManglingContext rmc;
+    // Demangling is expensive, so this only indexes the names as they appear
+    // in the symbol table. Demangled names, base names and method names are
+    // indexed by InitDemangledNameIndexes() once a lookup needs them.
     for (uint32_t value = 0; value < num_symbols; ++value) {
       Symbol *symbol = &m_symbols[value];
 
@@ -279,69 +278,67 @@ void Symtab::InitNameIndexes() {
       // If the symbol's name string matched a Mangled::ManglingScheme, it is
       // stored in the mangled field.
       Mangled &mangled = symbol->GetMangled();
-      if (ConstString name = mangled.GetMangledName()) {
-        m_name_to_index.Append(name, value);
-
-        if (symbol->ContainsLinkerAnnotations()) {
-          // If the symbol has linker annotations, also add the version without
-          // the annotations.
-          ConstString stripped = ConstString(
-              m_objfile->StripLinkerSymbolAnnotations(name.GetStringRef()));
-          m_name_to_index.Append(stripped, value);
-        }
-
-        const SymbolType type = symbol->GetType();
-        if (type == eSymbolTypeCode || type == eSymbolTypeResolver) {
-          if (mangled.DemangleWithRichManglingInfo(rmc, lldb_skip_name))
-            RegisterMangledNameEntry(value, class_contexts, backlog, rmc);
-        }
-      }
+      ConstString name = mangled.GetMangledName();
 
       // Symbol name strings that didn't match a Mangled::ManglingScheme, are
       // stored in the demangled field.
-      if (ConstString name = mangled.GetDemangledName(symbol->GetLanguage())) {
+      if (!name)
+        name = mangled.GetDemangledName(symbol->GetLanguage());
+      if (!name)
+        continue;
+
+      m_name_to_index.Append(name, value);
+
+      if (symbol->ContainsLinkerAnnotations()) {
+        // If the symbol has linker annotations, also add the version without
+        // the annotations.
+        name = ConstString(
+            m_objfile->StripLinkerSymbolAnnotations(name.GetStringRef()));
         m_name_to_index.Append(name, value);
+      }
 
-        if (symbol->ContainsLinkerAnnotations()) {
-          // If the symbol has linker annotations, also add the version without
-          // the annotations.
-          name = ConstString(
-              m_objfile->StripLinkerSymbolAnnotations(name.GetStringRef()));
-          m_name_to_index.Append(name, value);
-        }
+      if (mangled.GetMangledName())
+        continue;
 
-        // If the demangled name turns out to be an ObjC name, and is a category
-        // name, add the version without categories to the index too.
-        ObjCLanguage::MethodName objc_method(name.GetStringRef(), true);
-        if (objc_method.IsValid(true)) {
-          m_selector_to_index.Append(objc_method.GetSelector(), value);
+      // If the name turns out to be an ObjC name, and is a category name, add
+      // the version without categories to the index too.
+      ObjCLanguage::MethodName objc_method(name.GetStringRef(), true);
+      if (objc_method.IsValid(true)) {
+        m_selector_to_index.Append(objc_method.GetSelector(), value);
 
-          if (ConstString objc_method_no_category =
-                  objc_method.GetFullNameWithoutCategory(true))
-            m_name_to_index.Append(objc_method_no_category, value);
-        }
+        if (ConstString objc_method_no_category =
+                objc_method.GetFullNameWithoutCategory(true))
+          m_name_to_index.Append(objc_method_no_category, value);
       }
     }
 
-    for (const auto &record : backlog) {
-      RegisterBacklogEntry(record.first, record.second, class_contexts);
-    }
-
     m_name_to_index.Sort();
     m_name_to_index.SizeToFit();
     m_selector_to_index.Sort();
     m_selector_to_index.SizeToFit();
-    m_basename_to_index.Sort();
-    m_basename_to_index.SizeToFit();
-    m_method_to_index.Sort();
-    m_method_to_index.SizeToFit();
   }
 }
 
-void Symtab::RegisterMangledNameEntry(
-    uint32_t value, std::set<const char *> &class_contexts,
-    std::vector<std::pair<NameToIndexMap::Entry, const char *>> &backlog,
-    RichManglingContext &rmc) {
+namespace {
+// A function name found while demangling the symbols of a batch. Whether it
+// goes into the base name index depends on the declaration contexts found in
+// all batches.
+struct FunctionNameEntry {
+  Symtab::NameToIndexMap::Entry entry;
+  // The "const char *" must come from a ConstString::GetCString(), or be null
+  // if the function has no declaration context.
+  const char *decl_context;
+  bool is_ctor_or_dtor;
+};
+
+struct DemangledNameBatch {
+  std::vector<Symtab::NameToIndexMap::Entry> names;
+  std::vector<FunctionNameEntry> functions;
+};
+} // namespace
+
+static void AppendFunctionNameEntry(uint32_t value, RichManglingContext &rmc,
+                                    std::vector<FunctionNameEntry> &functions) {
   // Only register functions that have a base name.
   rmc.ParseFunctionBaseName();
   llvm::StringRef base_name = rmc.GetBufferRef();
@@ -349,63 +346,122 @@ void Symtab::RegisterMangledNameEntry(
     return;
 
   // The base name will be our entry's name.
-  NameToIndexMap::Entry entry(ConstString(base_name), value);
+  Symtab::NameToIndexMap::Entry entry(ConstString(base_name), value);
 
   rmc.ParseFunctionDeclContextName();
   llvm::StringRef decl_context = rmc.GetBufferRef();
+  const char *decl_context_ccstr =
+      decl_context.empty() ? nullptr : ConstString(decl_context).GetCString();
+  functions.push_back({entry, decl_context_ccstr, rmc.IsCtorOrDtor()});
+}
 
-  // Register functions with no context.
-  if (decl_context.empty()) {
-    // This has to be a basename
-    m_basename_to_index.Append(entry);
-    // If there is no context (no namespaces or class scopes that come before
-    // the function name) then this also could be a fullname.
-    m_name_to_index.Append(entry);
+void Symtab::InitDemangledNameIndexes() {
+  // Protected function, no need to lock mutex...
+  if (m_demangled_name_indexes_computed)
     return;
-  }
+  m_demangled_name_indexes_computed = true;
+  static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
+  Timer scoped_timer(func_cat, "%s", LLVM_PRETTY_FUNCTION);
 
-  // Make sure we have a pool-string pointer and see if we already know the
-  // context name.
-  const char *decl_context_ccstr = ConstString(decl_context).GetCString();
-  auto it = class_contexts.find(decl_context_ccstr);
-
-  // Register constructors and destructors. They are methods and create
-  // declaration contexts.
-  if (rmc.IsCtorOrDtor()) {
-    m_method_to_index.Append(entry);
-    if (it == class_contexts.end())
-      class_contexts.insert(it, decl_context_ccstr);
-    return;
-  }
+  // Demangle the symbols in batches on all cores. Each batch only touches its
+  // own symbols and results, and the results are merged in symbol order below
+  // so that the indexes don't depend on the scheduling.
+  const size_t num_symbols = m_symbols.size();
+  const size_t batch_size = 4096;
+  std::vector<DemangledNameBatch> batches((num_symbols + batch_size - 1) /
+                                          batch_size);
+  auto demangle_fn = [&](size_t batch_idx) {
+    DemangledNameBatch &batch = batches[batch_idx];
+    // Instantiation of the demangler is expensive, so better use a single one
+    // for all entries of the batch.
+    RichManglingContext rmc;
+    const uint32_t begin = batch_idx * batch_size;
+    const uint32_t end = std::min(num_symbols, (batch_idx + 1) * batch_size);
+    for (uint32_t value = begin; value < end; ++value) {
+      Symbol *symbol = &m_symbols[value];
+      if (symbol->IsTrampoline())
+        continue;
 
-  // Register regular methods with a known declaration context.
-  if (it != class_contexts.end()) {
-    m_method_to_index.Append(entry);
-    return;
-  }
+      Mangled &mangled = symbol->GetMangled();
+      if (!mangled.GetMangledName())
+        continue;
 
-  // Regular methods in unknown declaration contexts are put to the backlog. We
-  // will revisit them once we processed all remaining symbols.
-  backlog.push_back(std::make_pair(entry, decl_context_ccstr));
-}
+      const SymbolType type = symbol->GetType();
+      if (type == eSymbolTypeCode || type == eSymbolTypeResolver) {
+        if (mangled.DemangleWithRichManglingInfo(rmc, lldb_skip_name))
+          AppendFunctionNameEntry(value, rmc, batch.functions);
+      }
 
-void Symtab::RegisterBacklogEntry(
-    const NameToIndexMap::Entry &entry, const char *decl_context,
-    const std::set<const char *> &class_contexts) {
-  auto it = class_contexts.find(decl_context);
-  if (it != class_contexts.end()) {
-    m_method_to_index.Append(entry);
-  } else {
-    // If we got here, we have something that had a context (was inside
-    // a namespace or class) yet we don't know the entry
-    m_method_to_index.Append(entry);
-    m_basename_to_index.Append(entry);
+      if (ConstString name = mangled.GetDemangledName(symbol->GetLanguage())) {
+        batch.names.emplace_back(name, value);
+
+        if (symbol->ContainsLinkerAnnotations()) {
+          // If the symbol has linker annotations, also add the version without
+          // the annotations.
+          name = ConstString(
+              m_objfile->StripLinkerSymbolAnnotations(name.GetStringRef()));
+          batch.names.emplace_back(name, value);
+        }
+      }
+    }
+  };
+  TaskMapOverInt(0, batches.size(), demangle_fn);
+
+  // Constructors and destructors create declaration contexts. Functions in
+  // those contexts are methods.
+  std::set<const char *> class_contexts;
+  for (const DemangledNameBatch &batch : batches)
+    for (const FunctionNameEntry &function : batch.functions)
+      if (function.is_ctor_or_dtor)
+        class_contexts.insert(function.decl_context);
+
+  for (const DemangledNameBatch &batch : batches) {
+    for (const NameToIndexMap::Entry &entry : batch.names)
+      m_demangled_name_to_index.Append(entry);
+
+    for (const FunctionNameEntry &function : batch.functions) {
+      if (!function.decl_context) {
+        // This has to be a basename
+        m_basename_to_index.Append(function.entry);
+        // If there is no context (no namespaces or class scopes that come
+        // before the function name) then this also could be a fullname.
+        m_demangled_name_to_index.Append(function.entry);
+        continue;
+      }
+
+      m_method_to_index.Append(function.entry);
+      // If we got here, we have something that had a context (was inside a
+      // namespace or class) yet we don't know the entry
+      if (!function.is_ctor_or_dtor &&
+          !class_contexts.count(function.decl_context))
+        m_basename_to_index.Append(function.entry);
+    }
   }
+  batches.clear();
+
+  auto finalize_fn = [](NameToIndexMap &map) {
+    map.Sort();
+    map.SizeToFit();
+  };
+  TaskPool::RunTasks([&]() { finalize_fn(m_demangled_name_to_index); },
+                     [&]() { finalize_fn(m_basename_to_index); },
+                     [&]() { finalize_fn(m_method_to_index); });
+}
+
+void Symtab::InitNameIndexesForLookup(ConstString name) {
+  // Protected function, no need to lock mutex...
+  InitNameIndexes();
+  // A mangled name can only match the name of a symbol as it appears in the
+  // symbol table, so the symbols only need to be demangled for other names.
+  if (Mangled::GetManglingScheme(name.GetStringRef()) ==
+      Mangled::eManglingSchemeNone)
+    InitDemangledNameIndexes();
 }
 
 void Symtab::PreloadSymbols() {
   std::lock_guard<std::recursive_mutex> guard(m_mutex);
   InitNameIndexes();
+  InitDemangledNameIndexes();
 }
 
 void Symtab::AppendSymbolNamesToMap(const IndexCollection &indexes,
@@ -597,10 +653,10 @@ uint32_t Symtab::AppendSymbolIndexesWithName(ConstString symbol_name,
   static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
   Timer scoped_timer(func_cat, "%s", LLVM_PRETTY_FUNCTION);
   if (symbol_name) {
-    if (!m_name_indexes_computed)
-      InitNameIndexes();
+    InitNameIndexesForLookup(symbol_name);
 
-    return m_name_to_index.GetValues(symbol_name, indexes);
+    return m_name_to_index.GetValues(symbol_name, indexes) +
+           m_demangled_name_to_index.GetValues(symbol_name, indexes);
   }
   return 0;
 }
@@ -615,12 +671,12 @@ uint32_t Symtab::AppendSymbolIndexesWithName(ConstString symbol_name,
   Timer scoped_timer(func_cat, "%s", LLVM_PRETTY_FUNCTION);
   if (symbol_name) {
     const size_t old_size = indexes.size();
-    if (!m_name_indexes_computed)
-      InitNameIndexes();
+    InitNameIndexesForLookup(symbol_name);
 
     std::vector<uint32_t> all_name_indexes;
     const size_t name_match_count =
-        m_name_to_index.GetValues(symbol_name, all_name_indexes);
+        m_name_to_index.GetValues(symbol_name, all_name_indexes) +
+        m_demangled_name_to_index.GetValues(symbol_name, all_name_indexes);
     for (size_t i = 0; i < name_match_count; ++i) {
       if (CheckSymbolAtIndex(all_name_indexes[i], symbol_debug_type,
                              symbol_visibility))
@@ -1048,8 +1104,7 @@ void Symtab::FindFunctionSymbols(ConstString name, uint32_t name_type_mask,
   if (name_type_mask & eFunctionNameTypeBase) {
     // From mangled names we can't tell what is a basename and what is a method
     // name, so we just treat them the same
-    if (!m_name_indexes_computed)
-      InitNameIndexes();
+    InitDemangledNameIndexes();
 
     if (!m_basename_to_index.IsEmpty()) {
       const UniqueCStringMap<uint32_t>::Entry *match;
@@ -1062,8 +1117,7 @@ void Symtab::FindFunctionSymbols(ConstString name, uint32_t name_type_mask,
   }
 
   if (name_type_mask & eFunctionNameTypeMethod) {
-    if (!m_name_indexes_computed)
-      InitNameIndexes();
+    InitDemangledNameIndexes();
 
     if (!m_method_to_index.IsEmpty()) {
       const UniqueCStringMap<uint32_t>::Entry *match;
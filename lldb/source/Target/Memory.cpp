@@ -23,7 +23,8 @@ using namespace lldb_private;
 MemoryCache::MemoryCache(Process &process)
     : m_mutex(), m_L1_cache(), m_L2_cache(), m_invalid_ranges(),
       m_process(process),
-      m_L2_cache_line_byte_size(process.GetMemoryCacheLineSize()) {}
+      m_L2_cache_line_byte_size(process.GetMemoryCacheLineSize()),
+      m_last_missed_line_addr(LLDB_INVALID_ADDRESS) {}
 
 // Destructor
 MemoryCache::~MemoryCache() {}
@@ -35,6 +36,7 @@ void MemoryCache::Clear(bool clear_invalid_ranges) {
   if (clear_invalid_ranges)
     m_invalid_ranges.Clear();
   m_L2_cache_line_byte_size = m_process.GetMemoryCacheLineSize();
+  m_last_missed_line_addr = LLDB_INVALID_ADDRESS;
 }
 
 void MemoryCache::AddL1CacheData(lldb::addr_t addr, const void *src,
@@ -224,6 +226,15 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
 
       if (bytes_left > 0) {
         assert((curr_addr % cache_line_byte_size) == 0);
+        // Misses on two consecutive lines suggest that memory is being read
+        // sequentially, e.g. while walking up the stack, so read ahead.
+        const bool sequential =
+            m_last_missed_line_addr != LLDB_INVALID_ADDRESS &&
+            curr_addr == m_last_missed_line_addr + cache_line_byte_size;
+        m_last_missed_line_addr = curr_addr;
+        if (sequential && ReadAheadCacheLines(curr_addr))
+          continue;
+
         std::unique_ptr<DataBufferHeap> data_buffer_heap_up(
             new DataBufferHeap(cache_line_byte_size, 0));
         size_t process_bytes_read = m_process.ReadMemoryFromInferior(
@@ -244,6 +255,37 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
   return dst_len - bytes_left;
 }
 
+bool MemoryCache::ReadAheadCacheLines(addr_t addr) {
+  // The number of lines after the missed one to read at the same time.
+  const uint32_t read_ahead_line_count = 4;
+
+  const uint32_t cache_line_byte_size = m_L2_cache_line_byte_size;
+  std::vector<AddrRange> lines;
+  lines.emplace_back(addr, cache_line_byte_size);
+  for (uint32_t i = 1; i <= read_ahead_line_count; ++i) {
+    const addr_t line_addr = addr + i * cache_line_byte_size;
+    if (line_addr < addr)
+      break;
+    if (m_L2_cache.count(line_addr) ||
+        m_invalid_ranges.FindEntryThatContains(line_addr))
+      continue;
+    lines.emplace_back(line_addr, cache_line_byte_size);
+  }
+
+  std::vector<uint8_t> buf(lines.size() * cache_line_byte_size);
+  std::vector<size_t> bytes_read =
+      m_process.ReadMemoryRangesFromInferior(lines, buf.data());
+  for (size_t i = 0; i < lines.size(); ++i) {
+    if (bytes_read[i] == 0)
+      continue;
+    m_L2_cache[lines[i].GetRangeBase()] = std::make_shared<DataBufferHeap>(
+        buf.data() + i * cache_line_byte_size, bytes_read[i]);
+    // Keep reading ahead if the next miss is right after these lines.
+    m_last_missed_line_addr = lines[i].GetRangeBase();
+  }
+  return bytes_read[0] > 0;
+}
+
 AllocatedBlock::AllocatedBlock(lldb::addr_t addr, uint32_t byte_size,
                                uint32_t permissions, uint32_t chunk_size)
     : m_range(addr, byte_size), m_permissions(permissions),
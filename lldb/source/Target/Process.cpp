@@ -2096,6 +2096,44 @@ size_t Process::ReadMemoryFromInferior(addr_t addr, void *buf, size_t size,
   return bytes_read;
 }
 
+std::vector<size_t>
+Process::ReadMemoryRangesFromInferior(llvm::ArrayRef<LoadRange> ranges,
+                                      uint8_t *buf) {
+  std::vector<size_t> bytes_read = DoReadMemoryRanges(ranges, buf);
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    const LoadRange &range = ranges[i];
+    // Finish the ranges the plugin only partially read, just like
+    // ReadMemoryFromInferior would.
+    if (bytes_read[i] > 0 && bytes_read[i] < range.GetByteSize()) {
+      Status error;
+      bytes_read[i] += ReadMemoryFromInferior(
+          range.GetRangeBase() + bytes_read[i], buf + bytes_read[i],
+          range.GetByteSize() - bytes_read[i], error);
+    }
+
+    // Replace any software breakpoint opcodes that fall into this range back
+    // into "buf"
+    if (bytes_read[i] > 0)
+      RemoveBreakpointOpcodesFromBuffer(range.GetRangeBase(), bytes_read[i],
+                                        buf);
+    buf += range.GetByteSize();
+  }
+  return bytes_read;
+}
+
+std::vector<size_t>
+Process::DoReadMemoryRanges(llvm::ArrayRef<LoadRange> ranges, uint8_t *buf) {
+  std::vector<size_t> bytes_read;
+  bytes_read.reserve(ranges.size());
+  for (const LoadRange &range : ranges) {
+    Status error;
+    bytes_read.push_back(
+        DoReadMemory(range.GetRangeBase(), buf, range.GetByteSize(), error));
+    buf += range.GetByteSize();
+  }
+  return bytes_read;
+}
+
 uint64_t Process::ReadUnsignedIntegerFromMemory(lldb::addr_t vm_addr,
                                                 size_t integer_byte_size,
                                                 uint64_t fail_value,
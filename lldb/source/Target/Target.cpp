@@ -58,6 +58,8 @@
 #include "lldb/Utility/Timer.h"
 
 #include "llvm/ADT/ScopeExit.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 
 #include <memory>
 #include <mutex>
@@ -1950,6 +1952,101 @@ bool Target::ReadPointerFromMemory(const Address &addr, bool prefer_file_cache,
   return false;
 }
 
+Status Target::FindSharedModule(const ModuleSpec &module_spec,
+                                ModuleSP &module_sp,
+                                ModuleSP *old_module_sp_ptr) {
+  Status error;
+  bool did_create_module = false;
+  FileSpecList search_paths = GetExecutableSearchPaths();
+  // If there are image search path entries, try to use them first to acquire
+  // a suitable image.
+  if (m_image_search_paths.GetSize()) {
+    ModuleSpec transformed_spec(module_spec);
+    if (m_image_search_paths.RemapPath(
+            module_spec.GetFileSpec().GetDirectory(),
+            transformed_spec.GetFileSpec().GetDirectory())) {
+      transformed_spec.GetFileSpec().GetFilename() =
+          module_spec.GetFileSpec().GetFilename();
+      error = ModuleList::GetSharedModule(transformed_spec, module_sp,
+                                          &search_paths, old_module_sp_ptr,
+                                          &did_create_module);
+    }
+  }
+
+  if (!module_sp) {
+    // If we have a UUID, we can check our global shared module list in case
+    // we already have it. If we don't have a valid UUID, then we can't since
+    // the path in "module_spec" will be a platform path, and we will need to
+    // let the platform find that file. For example, we could be asking for
+    // "/usr/lib/dyld" and if we do not have a UUID, we don't want to pick the
+    // local copy of "/usr/lib/dyld" since our platform could be a remote
+    // platform that has its own "/usr/lib/dyld" in an SDK or in a local file
+    // cache.
+    if (module_spec.GetUUID().IsValid()) {
+      // We have a UUID, it is OK to check the global module list...
+      error = ModuleList::GetSharedModule(module_spec, module_sp, &search_paths,
+                                          old_module_sp_ptr,
+                                          &did_create_module);
+    }
+
+    if (!module_sp) {
+      // The platform is responsible for finding and caching an appropriate
+      // module in the shared module cache.
+      if (m_platform_sp) {
+        error = m_platform_sp->GetSharedModule(
+            module_spec, m_process_sp.get(), module_sp, &search_paths,
+            old_module_sp_ptr, &did_create_module);
+      } else {
+        error.SetErrorString("no platform is currently set");
+      }
+    }
+  }
+  return error;
+}
+
+ModuleList Target::PreloadModules(llvm::ArrayRef<ModuleSpec> module_specs) {
+  ModuleList preloaded_modules;
+  if (!GetPreloadSymbols())
+    return preloaded_modules;
+
+  // Finding or creating a module goes through the global shared module list,
+  // which is guarded by a single lock, so do that serially. Creating a module
+  // only reads the object file header; parsing the symbol table and indexing
+  // the debug info is what takes the time.
+  for (const ModuleSpec &module_spec : module_specs) {
+    if (m_images.FindFirstModule(module_spec))
+      continue;
+    ModuleSP module_sp;
+    FindSharedModule(module_spec, module_sp, nullptr);
+    if (module_sp && module_sp->GetObjectFile())
+      preloaded_modules.AppendIfNeeded(module_sp, /*notify=*/false);
+  }
+
+  const size_t num_modules = preloaded_modules.GetSize();
+  if (num_modules == 0)
+    return preloaded_modules;
+
+  unsigned num_threads = GetPreloadSymbolsThreadCount();
+  if (num_threads == 0)
+    num_threads = llvm::hardware_concurrency();
+  num_threads = std::min<size_t>(std::max(num_threads, 1u), num_modules);
+
+  static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
+  Timer scoped_timer(func_cat, "Target::PreloadModules (%zu modules)",
+                     num_modules);
+
+  // Use a dedicated pool rather than the shared TaskPool: preloading a symbol
+  // file may itself fan out work to the TaskPool and wait for it, which must
+  // not happen from inside one of its workers.
+  llvm::ThreadPool pool(num_threads);
+  for (size_t i = 0; i < num_modules; ++i) {
+    ModuleSP module_sp = preloaded_modules.GetModuleAtIndex(i);
+    pool.async([module_sp]() { module_sp->PreloadSymbols(); });
+  }
+  pool.wait();
+  return preloaded_modules;
+}
+
 ModuleSP Target::GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
                                    Status *error_ptr) {
   ModuleSP module_sp;
@@ -1966,51 +2063,7 @@ ModuleSP Target::GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
   if (!module_sp) {
     ModuleSP old_module_sp; // This will get filled in if we have a new version
                             // of the library
-    bool did_create_module = false;
-    FileSpecList search_paths = GetExecutableSearchPaths();
-    // If there are image search path entries, try to use them first to acquire
-    // a suitable image.
-    if (m_image_search_paths.GetSize()) {
-      ModuleSpec transformed_spec(module_spec);
-      if (m_image_search_paths.RemapPath(
-              module_spec.GetFileSpec().GetDirectory(),
-              transformed_spec.GetFileSpec().GetDirectory())) {
-        transformed_spec.GetFileSpec().GetFilename() =
-            module_spec.GetFileSpec().GetFilename();
-        error = ModuleList::GetSharedModule(transformed_spec, module_sp,
-                                            &search_paths, &old_module_sp,
-                                            &did_create_module);
-      }
-    }
-
-    if (!module_sp) {
-      // If we have a UUID, we can check our global shared module list in case
-      // we already have it. If we don't have a valid UUID, then we can't since
-      // the path in "module_spec" will be a platform path, and we will need to
-      // let the platform find that file. For example, we could be asking for
-      // "/usr/lib/dyld" and if we do not have a UUID, we don't want to pick
-      // the local copy of "/usr/lib/dyld" since our platform could be a remote
-      // platform that has its own "/usr/lib/dyld" in an SDK or in a local file
-      // cache.
-      if (module_spec.GetUUID().IsValid()) {
-        // We have a UUID, it is OK to check the global module list...
-        error =
-            ModuleList::GetSharedModule(module_spec, module_sp, &search_paths,
-                                        &old_module_sp, &did_create_module);
-      }
-
-      if (!module_sp) {
-        // The platform is responsible for finding and caching an appropriate
-        // module in the shared module cache.
-        if (m_platform_sp) {
-          error = m_platform_sp->GetSharedModule(
-              module_spec, m_process_sp.get(), module_sp, &search_paths,
-              &old_module_sp, &did_create_module);
-        } else {
-          error.SetErrorString("no platform is currently set");
-        }
-      }
-    }
+    error = FindSharedModule(module_spec, module_sp, &old_module_sp);
 
     // We found a module that wasn't in our target list.  Let's make sure that
     // there wasn't an equivalent module in the list already, and if there was,
@@ -2070,8 +2123,8 @@ ModuleSP Target::GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
           }
         }
 
-        // Preload symbols outside of any lock, so hopefully we can do this for
-        // each library in parallel.
+        // Preload symbols outside of any lock. This is a no-op if the module
+        // was already preloaded in parallel by PreloadModules.
         if (GetPreloadSymbols())
           module_sp->PreloadSymbols();
 
@@ -3584,6 +3637,17 @@ void TargetProperties::SetPreloadSymbols(bool b) {
   m_collection_sp->SetPropertyAtIndexAsBoolean(nullptr, idx, b);
 }
 
+uint32_t TargetProperties::GetPreloadSymbolsThreadCount() const {
+  const uint32_t idx = ePropertyPreloadSymbolsThreads;
+  return m_collection_sp->GetPropertyAtIndexAsUInt64(
+      nullptr, idx, g_target_properties[idx].default_uint_value);
+}
+
+void TargetProperties::SetPreloadSymbolsThreadCount(uint32_t count) {
+  const uint32_t idx = ePropertyPreloadSymbolsThreads;
+  m_collection_sp->SetPropertyAtIndexAsUInt64(nullptr, idx, count);
+}
+
 bool TargetProperties::GetDisableASLR() const {
   const uint32_t idx = ePropertyDisableASLR;
   return m_collection_sp->GetPropertyAtIndexAsBoolean(
@@ -10,16 +10,16 @@
 
 #include "lldb/Utility/Stream.h"
 
-#include "llvm/ADT/StringMap.h"
-#include "llvm/ADT/iterator.h"
 #include "llvm/Support/Allocator.h"
-#include "llvm/Support/DJB.h"
 #include "llvm/Support/FormatProviders.h"
-#include "llvm/Support/RWMutex.h"
 #include "llvm/Support/Threading.h"
+#include "llvm/Support/xxhash.h"
 
 #include <array>
-#include <utility>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include <inttypes.h>
 #include <stdint.h>
@@ -27,34 +27,42 @@
 
 using namespace lldb_private;
 
+// The pool is split into shards, selected by the hash of a string, so that
+// threads adding different strings rarely contend. Each shard has an open
+// addressing hash table of pointers to entries in the shard's arena. Lookups
+// do not lock: entries are never removed or modified once published, and a
+// table that outgrows its capacity is replaced but kept alive, so a reader
+// may only miss a string that is being added concurrently. Such misses fall
+// back to the shard's mutex, which also serializes additions.
 class Pool {
 public:
-  typedef const char *StringPoolValueType;
-  typedef llvm::StringMap<StringPoolValueType, llvm::BumpPtrAllocator>
-      StringPool;
-  typedef llvm::StringMapEntry<StringPoolValueType> StringPoolEntryType;
-
-  static StringPoolEntryType &
-  GetStringMapEntryFromKeyData(const char *keyData) {
-    return StringPoolEntryType::GetStringMapEntryFromKeyData(keyData);
-  }
+  // Each string is stored right after its entry, so the entry can be found
+  // from the string pointer alone.
+  struct Entry {
+    // The mangled or demangled counterpart of this string, if any.
+    std::atomic<const char *> counterpart;
+    size_t length;
+
+    const char *GetKeyData() const {
+      return reinterpret_cast<const char *>(this + 1);
+    }
 
-  static size_t GetConstCStringLength(const char *ccstr) {
-    if (ccstr != nullptr) {
-      // Since the entry is read only, and we derive the entry entirely from
-      // the pointer, we don't need the lock.
-      const StringPoolEntryType &entry = GetStringMapEntryFromKeyData(ccstr);
-      return entry.getKey().size();
+    static Entry &GetEntryFromKeyData(const char *key_data) {
+      return *reinterpret_cast<Entry *>(const_cast<char *>(key_data) -
+                                        sizeof(Entry));
     }
+  };
+
+  static size_t GetConstCStringLength(const char *ccstr) {
+    if (ccstr != nullptr)
+      return Entry::GetEntryFromKeyData(ccstr).length;
     return 0;
   }
 
-  StringPoolValueType GetMangledCounterpart(const char *ccstr) const {
-    if (ccstr != nullptr) {
-      const uint8_t h = hash(llvm::StringRef(ccstr));
-      llvm::sys::SmartScopedReader<false> rlock(m_string_pools[h].m_mutex);
-      return GetStringMapEntryFromKeyData(ccstr).getValue();
-    }
+  const char *GetMangledCounterpart(const char *ccstr) const {
+    if (ccstr != nullptr)
+      return Entry::GetEntryFromKeyData(ccstr).counterpart.load(
+          std::memory_order_acquire);
     return nullptr;
   }
 
@@ -71,52 +79,35 @@ public:
   }
 
   const char *GetConstCStringWithStringRef(const llvm::StringRef &string_ref) {
-    if (string_ref.data()) {
-      const uint8_t h = hash(string_ref);
-
-      {
-        llvm::sys::SmartScopedReader<false> rlock(m_string_pools[h].m_mutex);
-        auto it = m_string_pools[h].m_string_map.find(string_ref);
-        if (it != m_string_pools[h].m_string_map.end())
-          return it->getKeyData();
-      }
-
-      llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-      StringPoolEntryType &entry =
-          *m_string_pools[h]
-               .m_string_map.insert(std::make_pair(string_ref, nullptr))
-               .first;
-      return entry.getKeyData();
+    if (string_ref.data() == nullptr)
+      return nullptr;
+
+    const uint64_t h = hash(string_ref);
+    Shard &shard = m_shards[h >> (64 - g_shard_bits)];
+    if (const Entry *entry =
+            Find(shard.table.load(std::memory_order_acquire), h, string_ref))
+      return entry->GetKeyData();
+
+    std::unique_lock<std::mutex> lock(shard.mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+      shard.num_contended_inserts.fetch_add(1, std::memory_order_relaxed);
+      lock.lock();
     }
-    return nullptr;
+    return Insert(shard, h, string_ref)->GetKeyData();
   }
 
   const char *
   GetConstCStringAndSetMangledCounterPart(llvm::StringRef demangled,
                                           const char *mangled_ccstr) {
-    const char *demangled_ccstr = nullptr;
-
-    {
-      const uint8_t h = hash(demangled);
-      llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-
-      // Make or update string pool entry with the mangled counterpart
-      StringPool &map = m_string_pools[h].m_string_map;
-      StringPoolEntryType &entry = *map.try_emplace(demangled).first;
+    // Make or update string pool entry with the mangled counterpart
+    const char *demangled_ccstr = GetConstCStringWithStringRef(demangled);
+    Entry::GetEntryFromKeyData(demangled_ccstr)
+        .counterpart.store(mangled_ccstr, std::memory_order_release);
 
-      entry.second = mangled_ccstr;
-
-      // Extract the const version of the demangled_cstr
-      demangled_ccstr = entry.getKeyData();
-    }
-
-    {
-      // Now assign the demangled const string as the counterpart of the
-      // mangled const string...
-      const uint8_t h = hash(llvm::StringRef(mangled_ccstr));
-      llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-      GetStringMapEntryFromKeyData(mangled_ccstr).setValue(demangled_ccstr);
-    }
+    // Now assign the demangled const string as the counterpart of the
+    // mangled const string...
+    Entry::GetEntryFromKeyData(mangled_ccstr)
+        .counterpart.store(demangled_ccstr, std::memory_order_release);
 
     // Return the constant demangled C string
     return demangled_ccstr;
@@ -131,30 +122,125 @@ public:
     return nullptr;
   }
 
+  ConstString::PoolStatistics GetStatistics() const {
+    ConstString::PoolStatistics stats;
+    stats.bytes_allocated = sizeof(Pool);
+    for (const Shard &shard : m_shards) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      stats.num_strings += shard.num_strings;
+      stats.bytes_used += shard.bytes_used;
+      stats.bytes_allocated += shard.allocator.getTotalMemory();
+      for (const auto &table : shard.tables)
+        stats.bytes_allocated += table->capacity * sizeof(table->slots[0]);
+      stats.num_contended_inserts +=
+          shard.num_contended_inserts.load(std::memory_order_relaxed);
+    }
+    return stats;
+  }
+
   // Return the size in bytes that this object and any items in its collection
   // of uniqued strings + data count values takes in memory.
-  size_t MemorySize() const {
-    size_t mem_size = sizeof(Pool);
-    for (const auto &pool : m_string_pools) {
-      llvm::sys::SmartScopedReader<false> rlock(pool.m_mutex);
-      for (const auto &entry : pool.m_string_map)
-        mem_size += sizeof(StringPoolEntryType) + entry.getKey().size();
+  size_t MemorySize() const { return GetStatistics().bytes_allocated; }
+
+protected:
+  static const unsigned g_shard_bits = 8;
+  static const size_t g_initial_capacity = 16;
+
+  struct Table {
+    explicit Table(size_t capacity)
+        : capacity(capacity), slots(new std::atomic<Entry *>[capacity]()) {}
+
+    size_t capacity;
+    std::unique_ptr<std::atomic<Entry *>[]> slots;
+  };
+
+  struct Shard {
+    mutable std::mutex mutex;
+    // The current table. Guarded by mutex for writing only.
+    std::atomic<Table *> table{nullptr};
+    // The current table and all tables it replaced, which readers may still
+    // be looking at. Guarded by mutex.
+    std::vector<std::unique_ptr<Table>> tables;
+    // Storage for the entries and their strings. Guarded by mutex.
+    llvm::BumpPtrAllocator allocator;
+    size_t num_strings = 0;
+    size_t bytes_used = 0;
+    std::atomic<uint64_t> num_contended_inserts{0};
+  };
+
+  static uint64_t hash(llvm::StringRef s) { return llvm::xxHash64(s); }
+
+  static const Entry *Find(const Table *table, uint64_t h,
+                           llvm::StringRef s) {
+    if (table == nullptr)
+      return nullptr;
+    const size_t mask = table->capacity - 1;
+    for (size_t i = h & mask;; i = (i + 1) & mask) {
+      const Entry *entry = table->slots[i].load(std::memory_order_acquire);
+      if (entry == nullptr)
+        return nullptr;
+      if (entry->length == s.size() &&
+          memcmp(entry->GetKeyData(), s.data(), s.size()) == 0)
+        return entry;
     }
-    return mem_size;
   }
 
-protected:
-  uint8_t hash(const llvm::StringRef &s) const {
-    uint32_t h = llvm::djbHash(s);
-    return ((h >> 24) ^ (h >> 16) ^ (h >> 8) ^ h) & 0xff;
+  static void Publish(Table &table, uint64_t h, Entry *entry) {
+    const size_t mask = table.capacity - 1;
+    size_t i = h & mask;
+    while (table.slots[i].load(std::memory_order_relaxed) != nullptr)
+      i = (i + 1) & mask;
+    table.slots[i].store(entry, std::memory_order_release);
   }
 
-  struct PoolEntry {
-    mutable llvm::sys::SmartRWMutex<false> m_mutex;
-    StringPool m_string_map;
-  };
+  // Returns the entry for the given string, adding it if needed. The shard's
+  // mutex must be held.
+  const Entry *Insert(Shard &shard, uint64_t h, llvm::StringRef s) {
+    Table *table = shard.table.load(std::memory_order_relaxed);
+    if (const Entry *entry = Find(table, h, s))
+      return entry;
+
+    // Keep the load factor at or below 3/4 so probe sequences stay short.
+    if (table == nullptr || (shard.num_strings + 1) * 4 > table->capacity * 3)
+      table = Grow(shard);
+
+    const size_t size = sizeof(Entry) + s.size() + 1;
+    void *mem = shard.allocator.Allocate(size, alignof(Entry));
+    Entry *entry = new (mem) Entry();
+    entry->counterpart.store(nullptr, std::memory_order_relaxed);
+    entry->length = s.size();
+    char *key_data = const_cast<char *>(entry->GetKeyData());
+    memcpy(key_data, s.data(), s.size());
+    key_data[s.size()] = '\0';
+
+    Publish(*table, h, entry);
+    ++shard.num_strings;
+    shard.bytes_used += size;
+    return entry;
+  }
 
-  std::array<PoolEntry, 256> m_string_pools;
+  // Replaces the shard's table with one twice as big. The old table stays
+  // alive, since lock-free readers may still be probing it.
+  Table *Grow(Shard &shard) {
+    Table *old_table = shard.table.load(std::memory_order_relaxed);
+    auto new_table = std::make_unique<Table>(
+        old_table ? old_table->capacity * 2 : g_initial_capacity);
+    if (old_table) {
+      for (size_t i = 0; i < old_table->capacity; ++i) {
+        Entry *entry = old_table->slots[i].load(std::memory_order_relaxed);
+        if (entry != nullptr)
+          Publish(*new_table, hash(llvm::StringRef(entry->GetKeyData(),
+                                                   entry->length)),
+                  entry);
+      }
+    }
+    Table *result = new_table.get();
+    shard.tables.push_back(std::move(new_table));
+    shard.table.store(result, std::memory_order_release);
+    return result;
+  }
+
+  std::array<Shard, 1 << g_shard_bits> m_shards;
 };
 
 // Frameworks and dylibs aren't supposed to have global C++ initializers so we
@@ -304,6 +390,10 @@ size_t ConstString::StaticMemorySize() {
   return StringPool().MemorySize();
 }
 
+ConstString::PoolStatistics ConstString::GetPoolStatistics() {
+  return StringPool().GetStatistics();
+}
+
 void llvm::format_provider<ConstString>::format(const ConstString &CS,
                                                 llvm::raw_ostream &OS,
                                                 llvm::StringRef Options) {
@@ -397,6 +397,8 @@ StringExtractorGDBRemote::GetServerPacketType() const {
     return eServerPacketType_m;
 
   case 'M':
+    if (PACKET_STARTS_WITH("MultiMemRead:"))
+      return eServerPacketType_MultiMemRead;
     return eServerPacketType_M;
 
   case 'p':
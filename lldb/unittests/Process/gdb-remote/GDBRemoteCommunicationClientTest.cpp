@@ -362,6 +362,86 @@ TEST_F(GDBRemoteCommunicationClientTest, GetMemoryRegionInfoInvalidResponse) {
   EXPECT_FALSE(result.get().Success());
 }
 
+TEST_F(GDBRemoteCommunicationClientTest, ReadMemoryRangesMultiMemRead) {
+  std::vector<std::pair<lldb::addr_t, size_t>> ranges = {
+      {0x1000, 4}, {0x2000, 2}, {0x3000, 4}};
+  uint8_t buf[10] = {};
+  std::future<std::vector<size_t>> result = std::async(
+      std::launch::async, [&] { return client.ReadMemoryRanges(ranges, buf); });
+
+  HandlePacket(server, testing::StartsWith("qSupported:"),
+               "PacketSize=20000;MultiMemRead+");
+  HandlePacket(server, "MultiMemRead:ranges:1000,4,2000,2,3000,4;",
+               "4,0,2;abcdef");
+  EXPECT_THAT(result.get(), testing::ElementsAre(4u, 0u, 2u));
+  EXPECT_EQ("abcd", StringRef(reinterpret_cast<char *>(buf), 4));
+  EXPECT_EQ("ef", StringRef(reinterpret_cast<char *>(buf) + 6, 2));
+}
+
+TEST_F(GDBRemoteCommunicationClientTest, ReadMemoryRangesPipelined) {
+  std::vector<std::pair<lldb::addr_t, size_t>> ranges = {{0x1000, 4},
+                                                         {0x2000, 2}};
+  uint8_t buf[6] = {};
+  std::future<std::vector<size_t>> result = std::async(
+      std::launch::async, [&] { return client.ReadMemoryRanges(ranges, buf); });
+
+  HandlePacket(server, testing::StartsWith("qSupported:"), "PacketSize=20000");
+  HandlePacket(server, "x0,0", "OK");
+
+  // Both requests are sent before the first response arrives.
+  StringExtractorGDBRemote request;
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  EXPECT_EQ("x1000,4", request.GetStringRef());
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  EXPECT_EQ("x2000,2", request.GetStringRef());
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("abcd"));
+  ASSERT_EQ(PacketResult::Success, server.SendErrorResponse(0x08));
+
+  EXPECT_THAT(result.get(), testing::ElementsAre(4u, 0u));
+  EXPECT_EQ("abcd", StringRef(reinterpret_cast<char *>(buf), 4));
+}
+
+TEST_F(GDBRemoteCommunicationClientTest, ReadMemoryRangesPipelinedTimeout) {
+  client.SetPacketTimeout(std::chrono::seconds(1));
+  std::vector<std::pair<lldb::addr_t, size_t>> ranges = {
+      {0x1000, 4}, {0x2000, 2}, {0x3000, 4}};
+  uint8_t buf[10] = {};
+  std::future<std::vector<size_t>> result = std::async(
+      std::launch::async, [&] { return client.ReadMemoryRanges(ranges, buf); });
+
+  HandlePacket(server, testing::StartsWith("qSupported:"),
+               "PacketSize=20000;qEcho+");
+  HandlePacket(server, "x0,0", "OK");
+
+  StringExtractorGDBRemote request;
+  for (StringRef expected : {"x1000,4", "x2000,2", "x3000,4"}) {
+    ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+    EXPECT_EQ(expected, request.GetStringRef());
+  }
+
+  // The second response only arrives after the client stopped waiting for it.
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("abcd"));
+  PacketResult packet_result;
+  do
+    packet_result = server.GetPacket(request);
+  while (packet_result == PacketResult::ErrorReplyTimeout);
+  ASSERT_EQ(PacketResult::Success, packet_result);
+  EXPECT_EQ("qEcho:1", request.GetStringRef());
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("ef"));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("ghij"));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("qEcho:1"));
+  EXPECT_THAT(result.get(), testing::ElementsAre(0u, 0u, 0u));
+
+  // The late responses are not taken as the responses to later packets.
+  std::future<std::string> response = std::async(std::launch::async, [&] {
+    StringExtractorGDBRemote response;
+    client.SendPacketAndWaitForResponse("qTest", response, false);
+    return response.GetStringRef().str();
+  });
+  HandlePacket(server, "qTest", "test");
+  EXPECT_EQ("test", response.get());
+}
+
 TEST_F(GDBRemoteCommunicationClientTest, SendStartTracePacket) {
   TraceOptions options;
   Status error;
@@ -0,0 +1,162 @@
+//===-- TestSymtab.cpp ------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Plugins/ObjectFile/ELF/ObjectFileELF.h"
+#include "Plugins/SymbolFile/Symtab/SymbolFileSymtab.h"
+#include "TestingSupport/SubsystemRAII.h"
+#include "TestingSupport/TestUtilities.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleSpec.h"
+#include "lldb/Host/FileSystem.h"
+#include "lldb/Host/HostInfo.h"
+#include "lldb/Symbol/SymbolContext.h"
+#include "lldb/Symbol/Symtab.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace {
+class SymtabTest : public testing::Test {
+  SubsystemRAII<FileSystem, HostInfo, ObjectFileELF, SymbolFileSymtab>
+      subsystems;
+
+protected:
+  // Creates a module with a code symbol for each of the given names, in that
+  // order.
+  void CreateModule(llvm::ArrayRef<std::string> names) {
+    std::string yaml = R"(
+--- !ELF
+FileHeader:
+  Class:           ELFCLASS64
+  Data:            ELFDATA2LSB
+  Type:            ET_EXEC
+  Machine:         EM_X86_64
+Sections:
+  - Name:            .text
+    Type:            SHT_PROGBITS
+    Flags:           [ SHF_ALLOC, SHF_EXECINSTR ]
+    AddressAlign:    0x0000000000000010
+    Size:            0x10
+Symbols:
+)";
+    for (const std::string &name : names)
+      yaml += llvm::formatv("  - Name:            '{0}'\n"
+                            "    Type:            STT_FUNC\n"
+                            "    Section:         .text\n"
+                            "    Binding:         STB_GLOBAL\n",
+                            name)
+                  .str();
+    yaml += "...\n";
+
+    auto file = TestFile::fromYaml(yaml);
+    ASSERT_THAT_EXPECTED(file, llvm::Succeeded());
+    m_file.emplace(std::move(*file));
+    m_module_sp =
+        std::make_shared<Module>(ModuleSpec(FileSpec(m_file->name())));
+    m_symtab = m_module_sp->GetSymtab();
+    ASSERT_NE(nullptr, m_symtab);
+  }
+
+  // Counts the symbols with the given mangled or demangled name.
+  size_t CountSymbols(llvm::StringRef name) {
+    std::vector<uint32_t> indexes;
+    m_symtab->FindAllSymbolsWithNameAndType(ConstString(name), eSymbolTypeAny,
+                                            indexes);
+    return indexes.size();
+  }
+
+  size_t CountFunctions(llvm::StringRef name, FunctionNameType type) {
+    SymbolContextList sc_list;
+    m_symtab->FindFunctionSymbols(ConstString(name), type, sc_list);
+    return sc_list.GetSize();
+  }
+
+  // Looks up the names of the symbols created by CreateCommonModule(). The
+  // lookups by mangled name come first, as they can be answered without
+  // demangling the symbol table.
+  void CheckCommonLookups() {
+    // Mangled names.
+    EXPECT_EQ(1u, CountSymbols("_ZN2ns4quuxEv"));
+    EXPECT_EQ(1u, CountSymbols("_ZN1B3bazEv"));
+    EXPECT_EQ(1u, CountFunctions("_ZN1BC2Ev", eFunctionNameTypeFull));
+
+    // Demangled full names.
+    EXPECT_EQ(1u, CountSymbols("ns::quux()"));
+    EXPECT_EQ(1u, CountSymbols("B::baz()"));
+    EXPECT_EQ(1u, CountSymbols("B::B()"));
+    EXPECT_EQ(1u, CountFunctions("main", eFunctionNameTypeFull));
+
+    // Base names. A function in a namespace can't be told apart from a
+    // method, so it is indexed as both.
+    EXPECT_EQ(1u, CountFunctions("quux", eFunctionNameTypeBase));
+    EXPECT_EQ(1u, CountFunctions("main", eFunctionNameTypeBase));
+    EXPECT_EQ(0u, CountFunctions("B", eFunctionNameTypeBase));
+
+    // Method names. B has a constructor, so baz is a method, even though it
+    // comes first in the symbol table.
+    EXPECT_EQ(1u, CountFunctions("quux", eFunctionNameTypeMethod));
+    EXPECT_EQ(1u, CountFunctions("baz", eFunctionNameTypeMethod));
+    EXPECT_EQ(0u, CountFunctions("baz", eFunctionNameTypeBase));
+    EXPECT_EQ(1u, CountFunctions("B", eFunctionNameTypeMethod));
+
+    // Names with linker annotations, with and without them.
+    EXPECT_EQ(1u, CountSymbols("puts@GLIBC_2.5"));
+    EXPECT_EQ(1u, CountSymbols("puts"));
+    EXPECT_EQ(1u, CountSymbols("_Z5annotv@VERSION3"));
+    EXPECT_EQ(1u, CountSymbols("_Z5annotv"));
+
+    // ObjC methods, by selector and by name without the category.
+    EXPECT_EQ(1u, CountFunctions("ObjCbar", eFunctionNameTypeSelector));
+    EXPECT_EQ(1u, CountSymbols("+[B ObjCbar(WithCategory)]"));
+    EXPECT_EQ(1u, CountSymbols("+[B ObjCbar]"));
+  }
+
+  void CreateCommonModule() {
+    CreateModule({"_ZN1B3bazEv", "_ZN2ns4quuxEv", "_ZN1BC2Ev", "main",
+                  "puts@GLIBC_2.5", "_Z5annotv@VERSION3",
+                  "+[B ObjCbar(WithCategory)]"});
+  }
+
+  llvm::Optional<TestFile> m_file;
+  ModuleSP m_module_sp;
+  Symtab *m_symtab = nullptr;
+};
+} // namespace
+
+TEST_F(SymtabTest, FindsNamesLazily) {
+  CreateCommonModule();
+  CheckCommonLookups();
+}
+
+TEST_F(SymtabTest, FindsNamesAfterPreloading) {
+  CreateCommonModule();
+  m_symtab->PreloadSymbols();
+  CheckCommonLookups();
+}
+
+TEST_F(SymtabTest, FindsMethodsAcrossBatches) {
+  // Enough symbols that the symbol table is demangled in several batches,
+  // with the method of B in the first one and its constructor in the last.
+  std::vector<std::string> names = {"_ZN1B3bazEv", "_ZN1C3quxEv"};
+  for (unsigned i = 0; i < 10000; ++i)
+    names.push_back(llvm::formatv("_Z5f{0:d4}v", i).str());
+  names.push_back("_ZN1BC2Ev");
+  CreateModule(names);
+
+  EXPECT_EQ(1u, CountFunctions("baz", eFunctionNameTypeMethod));
+  EXPECT_EQ(0u, CountFunctions("baz", eFunctionNameTypeBase));
+  EXPECT_EQ(1u, CountFunctions("qux", eFunctionNameTypeMethod));
+  EXPECT_EQ(1u, CountFunctions("qux", eFunctionNameTypeBase));
+  EXPECT_EQ(1u, CountFunctions("f0000", eFunctionNameTypeBase));
+  EXPECT_EQ(1u, CountFunctions("f9999", eFunctionNameTypeBase));
+  EXPECT_EQ(1u, CountSymbols("f5000()"));
+  EXPECT_EQ(1u, CountSymbols("_Z5f5000v"));
+}
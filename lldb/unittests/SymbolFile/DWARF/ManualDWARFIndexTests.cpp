@@ -0,0 +1,212 @@
+//===-- ManualDWARFIndexTests.cpp -------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Plugins/ObjectFile/ELF/ObjectFileELF.h"
+#include "Plugins/SymbolFile/DWARF/ManualDWARFIndex.h"
+#include "Plugins/SymbolFile/DWARF/SymbolFileDWARF.h"
+#include "TestingSupport/SubsystemRAII.h"
+#include "TestingSupport/TestUtilities.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleList.h"
+#include "lldb/Core/ModuleSpec.h"
+#include "lldb/Host/FileSystem.h"
+#include "lldb/Host/HostInfo.h"
+#include "lldb/Symbol/ClangASTContext.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace {
+// A module with a build ID and a single compile unit that declares the base
+// type "foo".
+const char *g_yaml = R"(
+--- !ELF
+FileHeader:
+  Class:           ELFCLASS64
+  Data:            ELFDATA2LSB
+  Type:            ET_EXEC
+  Machine:         EM_X86_64
+Sections:
+  - Name:            .note.gnu.build-id
+    Type:            SHT_NOTE
+    Flags:           [ SHF_ALLOC ]
+    AddressAlign:    0x0000000000000004
+    Content:         040000001400000003000000474E55003F3EC29E3FD83E49D18C4D49CD8A730CC13117B6
+  - Name:            .debug_abbrev
+    Type:            SHT_PROGBITS
+    AddressAlign:    0x0000000000000001
+    Content:         01110103081305000002240003083E0B0B0B000000
+  - Name:            .debug_info
+    Type:            SHT_PROGBITS
+    AddressAlign:    0x0000000000000001
+    Content:         160000000400000000000801612E63000C0002666F6F00050400
+...
+)";
+
+// The offsets of the format version and the first byte of the UUID in an
+// index cache file.
+const size_t g_version_offset = sizeof("lldb-dwarf-index");
+const size_t g_uuid_offset = g_version_offset + 8;
+
+class ManualDWARFIndexTest : public testing::Test {
+  SubsystemRAII<FileSystem, HostInfo, ObjectFileELF, SymbolFileDWARF,
+                ClangASTContext>
+      subsystems;
+
+public:
+  void SetUp() override {
+    auto file = TestFile::fromYaml(g_yaml);
+    ASSERT_THAT_EXPECTED(file, llvm::Succeeded());
+    m_file.emplace(std::move(*file));
+    ASSERT_NO_ERROR(
+        llvm::sys::fs::createUniqueDirectory("dwarf-index-cache", m_cache_dir));
+    ModuleList::GetGlobalModuleListProperties().SetDWARFIndexCachePath(
+        m_cache_dir);
+  }
+
+  void TearDown() override {
+    ModuleList::GetGlobalModuleListProperties().SetDWARFIndexCachePath("");
+    llvm::sys::fs::remove_directories(m_cache_dir);
+  }
+
+protected:
+  // Indexes the test module anew and returns the DIEs of the types with the
+  // given name.
+  DIEArray FindTypes(llvm::StringRef name) {
+    auto module_sp =
+        std::make_shared<Module>(ModuleSpec(FileSpec(m_file->name())));
+    auto *dwarf = static_cast<SymbolFileDWARF *>(module_sp->GetSymbolFile());
+    EXPECT_NE(nullptr, dwarf);
+    if (!dwarf)
+      return {};
+    ManualDWARFIndex index(*module_sp, dwarf->DebugInfo());
+    DIEArray offsets;
+    index.GetTypes(ConstString(name), offsets);
+    return offsets;
+  }
+
+  // Returns the path of the only file in the cache directory.
+  std::string GetCacheFile() {
+    std::vector<std::string> files;
+    std::error_code ec;
+    for (llvm::sys::fs::directory_iterator it(m_cache_dir, ec), end;
+         !ec && it != end; it.increment(ec))
+      files.push_back(it->path());
+    EXPECT_EQ(1u, files.size());
+    return files.empty() ? std::string() : files.front();
+  }
+
+  void ModifyCacheFile(llvm::function_ref<void(std::string &)> modify) {
+    std::string path = GetCacheFile();
+    auto buffer = llvm::MemoryBuffer::getFile(path);
+    ASSERT_TRUE(bool(buffer));
+    std::string contents = (*buffer)->getBuffer().str();
+    modify(contents);
+    std::error_code ec;
+    llvm::raw_fd_ostream os(path, ec);
+    ASSERT_NO_ERROR(ec);
+    os << contents;
+  }
+
+  // Renames "foo" to "bar" in the cache, so that lookups show whether the
+  // index came from the cache or from the DWARF.
+  void RenameFooInCache() {
+    ModifyCacheFile([](std::string &contents) {
+      size_t pos = contents.find(std::string("foo", 4));
+      ASSERT_NE(std::string::npos, pos);
+      contents.replace(pos, 3, "bar");
+    });
+    ASSERT_EQ(1u, FindTypes("bar").size());
+    ASSERT_EQ(0u, FindTypes("foo").size());
+  }
+
+  llvm::Optional<TestFile> m_file;
+  llvm::SmallString<128> m_cache_dir;
+};
+} // namespace
+
+TEST_F(ManualDWARFIndexTest, RoundTrip) {
+  DIEArray indexed = FindTypes("foo");
+  ASSERT_EQ(1u, indexed.size());
+  EXPECT_FALSE(GetCacheFile().empty());
+
+  RenameFooInCache();
+  DIEArray loaded = FindTypes("bar");
+  ASSERT_EQ(1u, loaded.size());
+  EXPECT_EQ(indexed[0].die_offset(), loaded[0].die_offset());
+}
+
+TEST_F(ManualDWARFIndexTest, VersionMismatch) {
+  ASSERT_EQ(1u, FindTypes("foo").size());
+  RenameFooInCache();
+  ModifyCacheFile(
+      [](std::string &contents) { ++contents[g_version_offset]; });
+  EXPECT_EQ(1u, FindTypes("foo").size());
+  EXPECT_EQ(0u, FindTypes("bar").size());
+}
+
+TEST_F(ManualDWARFIndexTest, UUIDMismatch) {
+  ASSERT_EQ(1u, FindTypes("foo").size());
+  RenameFooInCache();
+  ModifyCacheFile([](std::string &contents) { ++contents[g_uuid_offset]; });
+  EXPECT_EQ(1u, FindTypes("foo").size());
+  EXPECT_EQ(0u, FindTypes("bar").size());
+}
+
+TEST_F(ManualDWARFIndexTest, ModificationTimeMismatch) {
+  ASSERT_EQ(1u, FindTypes("foo").size());
+  RenameFooInCache();
+
+  int fd;
+  ASSERT_NO_ERROR(llvm::sys::fs::openFileForWrite(
+      m_file->name(), fd, llvm::sys::fs::CD_OpenExisting,
+      llvm::sys::fs::OF_Append));
+  llvm::sys::TimePoint<> mtime =
+      FileSystem::Instance().GetModificationTime(FileSpec(m_file->name()));
+  ASSERT_NO_ERROR(llvm::sys::fs::setLastAccessAndModificationTime(
+      fd, mtime + std::chrono::seconds(10)));
+  llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+
+  EXPECT_EQ(1u, FindTypes("foo").size());
+  EXPECT_EQ(0u, FindTypes("bar").size());
+}
+
+TEST_F(ManualDWARFIndexTest, TruncatedFile) {
+  ASSERT_EQ(1u, FindTypes("foo").size());
+  RenameFooInCache();
+  ModifyCacheFile([](std::string &contents) {
+    contents.resize(contents.size() - 4);
+  });
+  EXPECT_EQ(1u, FindTypes("foo").size());
+  EXPECT_EQ(0u, FindTypes("bar").size());
+
+  RenameFooInCache();
+  ModifyCacheFile([](std::string &contents) { contents.resize(10); });
+  EXPECT_EQ(1u, FindTypes("foo").size());
+  EXPECT_EQ(0u, FindTypes("bar").size());
+}
+
+TEST_F(ManualDWARFIndexTest, CorruptFile) {
+  ASSERT_EQ(1u, FindTypes("foo").size());
+  RenameFooInCache();
+  // The file ends with the only type entry and an empty namespace map. Point
+  // the entry at a name past the end of the table.
+  ModifyCacheFile([](std::string &contents) {
+    ASSERT_GE(contents.size(), 16u);
+    contents[contents.size() - 13] = '\x7f';
+  });
+  EXPECT_EQ(1u, FindTypes("foo").size());
+  EXPECT_EQ(0u, FindTypes("bar").size());
+}
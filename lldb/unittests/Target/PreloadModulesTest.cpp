@@ -0,0 +1,200 @@
+//===-- PreloadModulesTest.cpp ----------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Plugins/ObjectFile/ELF/ObjectFileELF.h"
+#include "Plugins/Platform/Linux/PlatformLinux.h"
+#include "Plugins/SymbolFile/Symtab/SymbolFileSymtab.h"
+#include "TestingSupport/TestUtilities.h"
+#include "lldb/Core/Debugger.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleList.h"
+#include "lldb/Core/ModuleSpec.h"
+#include "lldb/Host/FileSystem.h"
+#include "lldb/Host/HostInfo.h"
+#include "lldb/Symbol/Symtab.h"
+#include "lldb/Target/Platform.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Utility/Reproducer.h"
+#include "lldb/Utility/UUID.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <array>
+
+using namespace lldb_private;
+using namespace lldb_private::repro;
+using namespace lldb;
+
+namespace {
+const unsigned g_num_libraries = 8;
+const unsigned g_num_symbols = 50;
+
+class PreloadModulesTest : public ::testing::Test {
+public:
+  void SetUp() override {
+    llvm::cantFail(Reproducer::Initialize(ReproducerMode::Off, llvm::None));
+    FileSystem::Initialize();
+    HostInfo::Initialize();
+    ObjectFileELF::Initialize();
+    SymbolFileSymtab::Initialize();
+    platform_linux::PlatformLinux::Initialize();
+  }
+
+  void TearDown() override {
+    m_files.clear();
+    ModuleList::RemoveOrphanSharedModules(/*mandatory=*/false);
+    platform_linux::PlatformLinux::Terminate();
+    SymbolFileSymtab::Terminate();
+    ObjectFileELF::Terminate();
+    HostInfo::Terminate();
+    FileSystem::Terminate();
+    Reproducer::Terminate();
+  }
+
+protected:
+  TargetSP CreateTarget() {
+    ArchSpec arch("x86_64-pc-linux");
+    Platform::SetHostPlatform(
+        platform_linux::PlatformLinux::CreateInstance(true, &arch));
+    m_debugger_sp = Debugger::CreateInstance();
+    TargetSP target_sp;
+    PlatformSP platform_sp;
+    Status error = m_debugger_sp->GetTargetList().CreateTarget(
+        *m_debugger_sp, "", arch, eLoadDependentsNo, platform_sp, target_sp);
+    EXPECT_TRUE(error.Success()) << error.AsCString();
+    return target_sp;
+  }
+
+  // Writes g_num_libraries new shared libraries and returns their
+  // specifications. Library i defines the same symbols in every call, but
+  // each call creates different files with different build IDs, so that no
+  // module is shared with an earlier call.
+  std::vector<ModuleSpec> CreateLibraries(const ArchSpec &arch) {
+    std::vector<ModuleSpec> specs;
+    for (unsigned i = 0; i < g_num_libraries; ++i) {
+      std::array<uint8_t, 20> build_id{};
+      build_id[0] = m_num_calls;
+      build_id[1] = i;
+
+      std::string yaml = llvm::formatv(R"(
+--- !ELF
+FileHeader:
+  Class:           ELFCLASS64
+  Data:            ELFDATA2LSB
+  Type:            ET_DYN
+  Machine:         EM_X86_64
+Sections:
+  - Name:            .note.gnu.build-id
+    Type:            SHT_NOTE
+    Flags:           [ SHF_ALLOC ]
+    AddressAlign:    0x0000000000000004
+    Content:         040000001400000003000000474E5500{0}
+  - Name:            .text
+    Type:            SHT_PROGBITS
+    Flags:           [ SHF_ALLOC, SHF_EXECINSTR ]
+    AddressAlign:    0x0000000000000010
+    Size:            0x10
+Symbols:
+)",
+                                       llvm::toHex(build_id))
+                             .str();
+      for (unsigned j = 0; j < g_num_symbols; ++j)
+        yaml += llvm::formatv("  - Name:            lib{0}_func{1}\n"
+                              "    Type:            STT_FUNC\n"
+                              "    Section:         .text\n"
+                              "    Binding:         STB_GLOBAL\n",
+                              i, j)
+                    .str();
+      yaml += "...\n";
+
+      auto file = TestFile::fromYaml(yaml);
+      EXPECT_THAT_EXPECTED(file, llvm::Succeeded());
+      if (!file)
+        return {};
+      m_files.push_back(std::move(*file));
+
+      ModuleSpec spec(FileSpec(m_files.back().name()), arch);
+      spec.GetUUID() = UUID::fromData(build_id);
+      specs.push_back(spec);
+    }
+    ++m_num_calls;
+    return specs;
+  }
+
+  DebuggerSP m_debugger_sp;
+  std::vector<TestFile> m_files;
+  uint8_t m_num_calls = 0;
+};
+} // namespace
+
+// Returns the sorted symbol names of each module, in module order.
+static std::vector<std::vector<std::string>>
+GetSymbolNames(const ModuleList &modules) {
+  std::vector<std::vector<std::string>> result;
+  for (size_t i = 0; i < modules.GetSize(); ++i) {
+    std::vector<std::string> names;
+    if (Symtab *symtab = modules.GetModuleAtIndex(i)->GetSymtab())
+      for (size_t j = 0; j < symtab->GetNumSymbols(); ++j)
+        names.push_back(
+            symtab->SymbolAtIndex(j)->GetName().GetStringRef().str());
+    llvm::sort(names);
+    result.push_back(std::move(names));
+  }
+  return result;
+}
+
+TEST_F(PreloadModulesTest, SameResultForAnyThreadCount) {
+  std::vector<std::vector<std::vector<std::string>>> results;
+  for (uint32_t num_threads : {1u, 4u}) {
+    TargetSP target_sp = CreateTarget();
+    ASSERT_TRUE(target_sp);
+    target_sp->SetPreloadSymbols(true);
+    target_sp->SetPreloadSymbolsThreadCount(num_threads);
+
+    std::vector<ModuleSpec> specs =
+        CreateLibraries(target_sp->GetArchitecture());
+    ASSERT_EQ(g_num_libraries, specs.size());
+
+    ModuleList preloaded = target_sp->PreloadModules(specs);
+    ASSERT_EQ(specs.size(), preloaded.GetSize());
+    for (size_t i = 0; i < specs.size(); ++i) {
+      ModuleSP module_sp = preloaded.GetModuleAtIndex(i);
+      EXPECT_EQ(specs[i].GetFileSpec(), module_sp->GetFileSpec());
+      EXPECT_EQ(specs[i].GetUUID(), module_sp->GetUUID());
+      // Adding the library to the target picks up the preloaded module.
+      EXPECT_EQ(module_sp, target_sp->GetOrCreateModule(specs[i], false));
+    }
+
+    // Libraries which are already in the target are not preloaded again.
+    EXPECT_EQ(0u, target_sp->PreloadModules(specs).GetSize());
+
+    results.push_back(GetSymbolNames(preloaded));
+  }
+
+  ASSERT_EQ(g_num_libraries, results[0].size());
+  for (unsigned i = 0; i < g_num_libraries; ++i) {
+    for (unsigned j = 0; j < g_num_symbols; ++j) {
+      std::string name = llvm::formatv("lib{0}_func{1}", i, j).str();
+      EXPECT_TRUE(std::binary_search(results[0][i].begin(),
+                                     results[0][i].end(), name))
+          << name;
+    }
+  }
+  EXPECT_EQ(results[0], results[1]);
+}
+
+TEST_F(PreloadModulesTest, DoesNothingWithoutPreloadSymbols) {
+  TargetSP target_sp = CreateTarget();
+  ASSERT_TRUE(target_sp);
+  target_sp->SetPreloadSymbols(false);
+  std::vector<ModuleSpec> specs =
+      CreateLibraries(target_sp->GetArchitecture());
+  EXPECT_EQ(0u, target_sp->PreloadModules(specs).GetSize());
+}
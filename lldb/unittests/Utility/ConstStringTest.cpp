@@ -10,6 +10,8 @@
 #include "llvm/Support/FormatVariadic.h"
 #include "gtest/gtest.h"
 
+#include <thread>
+
 using namespace lldb_private;
 
 TEST(ConstStringTest, format_provider) {
@@ -137,3 +139,31 @@ TEST(ConstStringTest, CompareStringRef) {
   EXPECT_TRUE(null == static_cast<const char *>(nullptr));
   EXPECT_TRUE(null != "bar");
 }
+
+TEST(ConstStringTest, ConcurrentInsertions) {
+  const unsigned num_threads = 8;
+  const unsigned num_strings = 2000;
+  std::vector<std::vector<const char *>> results(num_threads);
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&results, t] {
+      for (unsigned i = 0; i < num_strings; ++i)
+        results[t].push_back(
+            ConstString(llvm::formatv("concurrent{0}", i).str()).GetCString());
+    });
+  }
+  for (std::thread &thread : threads)
+    thread.join();
+
+  for (unsigned t = 1; t < num_threads; ++t)
+    EXPECT_EQ(results[0], results[t]);
+  for (unsigned i = 0; i < num_strings; ++i) {
+    std::string str = llvm::formatv("concurrent{0}", i).str();
+    EXPECT_EQ(str, results[0][i]);
+    EXPECT_EQ(str.size(), ConstString(str).GetLength());
+  }
+
+  ConstString::PoolStatistics stats = ConstString::GetPoolStatistics();
+  EXPECT_LE(num_strings, stats.num_strings);
+  EXPECT_LE(stats.bytes_used, stats.bytes_allocated);
+}